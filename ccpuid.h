@@ -309,9 +309,18 @@ typedef const CPUIDFIELDDESC* LPCCPUIDFIELDDESC;
 #define CPUF_ERMS	CPUIDFIELD_MAKE(7,0,1,9,1)
 #define CPUF_INVPCID	CPUIDFIELD_MAKE(7,0,1,10,1)
 #define CPUF_RTM	CPUIDFIELD_MAKE(7,0,1,11,1)
+#define CPUF_AVX512F	CPUIDFIELD_MAKE(7,0,1,16,1)
+#define CPUF_AVX512DQ	CPUIDFIELD_MAKE(7,0,1,17,1)
 #define CPUF_RDSEED	CPUIDFIELD_MAKE(7,0,1,18,1)
 #define CPUF_ADX	CPUIDFIELD_MAKE(7,0,1,19,1)
 #define CPUF_SMAP	CPUIDFIELD_MAKE(7,0,1,20,1)
+#define CPUF_AVX512IFMA	CPUIDFIELD_MAKE(7,0,1,21,1)
+#define CPUF_AVX512PF	CPUIDFIELD_MAKE(7,0,1,26,1)
+#define CPUF_AVX512ER	CPUIDFIELD_MAKE(7,0,1,27,1)
+#define CPUF_AVX512CD	CPUIDFIELD_MAKE(7,0,1,28,1)
+#define CPUF_AVX512BW	CPUIDFIELD_MAKE(7,0,1,30,1)
+#define CPUF_AVX512VL	CPUIDFIELD_MAKE(7,0,1,31,1)
+#define CPUF_AVX512VBMI	CPUIDFIELD_MAKE(7,0,2,1,1)
 #define CPUF_PLATFORM_DCA_CAP	CPUIDFIELD_MAKE(9,0,0,0,32)
 #define CPUF_APM_Version	CPUIDFIELD_MAKE(0xA,0,0,0,8)
 #define CPUF_APM_Counters	CPUIDFIELD_MAKE(0xA,0,0,8,8)
@@ -518,6 +527,27 @@ INLINE uint32_t	getcpuidfield(CPUIDFIELD cpuf)
 	return getcpuidfield_buf(dwBuf, cpuf);
 }
 
+// 读取扩展控制寄存器（XCR）. 调用前需确认 CPUF_OSXSAVE 非0.
+//
+// result: 返回XCR的值. 例如XCR0表示操作系统启用了哪些状态（XMM, YMM, opmask, ZMM等）.
+// xcr: 寄存器编号. 0表示XCR0.
+INLINE uint64_t	getxcr(uint32_t xcr)
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))	// GCC
+	uint32_t eax, edx;
+	__asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0"	// XGETBV. 用机器码是为了兼容不认识该指令的旧汇编器.
+		: "=a" (eax), "=d" (edx)
+		: "c" (xcr));
+	return ((uint64_t)edx << 32) | eax;
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64)) && defined(_MSC_FULL_VER) && _MSC_FULL_VER >= 160040219	// VC2010 SP1才支持_xgetbv.
+	return _xgetbv(xcr);
+#else
+	// 不支持XGETBV时, 用CPUID 0Dh 的XFeatureSupportedMask近似代替.
+	if (0!=xcr)	return 0;
+	return getcpuidfield(CPUF_XFeatureSupportedMaskLo);
+#endif	// #if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+}
+
 
 
 ////////////////////////////////////////
@@ -539,6 +569,8 @@ INLINE uint32_t	getcpuidfield(CPUIDFIELD cpuf)
 #define SIMD_AVX_NONE	0	// 不支持
 #define SIMD_AVX_1	1	// AVX
 #define SIMD_AVX_2	2	// AVX2
+#define SIMD_AVX_512F	3	// AVX-512F
+#define SIMD_AVX_512BW	4	// AVX-512F + AVX-512BW + AVX-512DQ
 
 
 
@@ -588,6 +620,37 @@ INLINE int cpu_getbrand(char* pbrand)
 	return 48;
 }
 
+// 取得某一级数据缓存（或统一缓存）的大小.
+// 使用 Function 4: Deterministic Cache Parameters. 不支持时（例如AMD）再尝试 Function 8000001Dh, 两者的字段布局相同.
+//
+// result: 返回缓存的字节数. 没有该级缓存或无法检测时返回0.
+// level: 缓存级别. 1表示L1.
+INLINE uint32_t	cpu_getcachesize(int level)
+{
+	static const uint32_t fids[2] = {4, 0x8000001DU};	// 功能号.
+	uint32_t dwBuf[4];
+	uint32_t type;	// 缓存类型. 0:无效, 1:数据, 2:指令, 3:统一.
+	int i, j;
+	for(i=0; i<2; ++i)
+	{
+		getcpuid(dwBuf, fids[i] & 0x80000000U);	// 最大功能号.
+		if (dwBuf[0] < fids[i])	continue;
+		for(j=0; j<32; ++j)
+		{
+			getcpuidex(dwBuf, fids[i], j);
+			type = getcpuidfield_buf(dwBuf, CPUF_Cache_Type);
+			if (0==type)	break;
+			if (2==type || getcpuidfield_buf(dwBuf, CPUF_Cache_Level)!=(uint32_t)level)	continue;
+			// 大小 = 路数 * 分区数 * 行大小 * 组数. 各字段均为实际值减1.
+			return (getcpuidfield_buf(dwBuf, CPUF_Cache_Ways)+1)
+				* (getcpuidfield_buf(dwBuf, CPUF_Cache_Partitions)+1)
+				* (getcpuidfield_buf(dwBuf, CPUF_Cache_LineSize)+1)
+				* (getcpuidfield_buf(dwBuf, CPUF_Cache_Sets)+1);
+		}
+	}
+	return 0;
+}
+
 
 static jmp_buf *volatile simd_pjump_sigill = NULL;	// SIGILL信号的跳回地址.
 
@@ -776,6 +839,14 @@ INLINE int	simd_avx_level(int* phwavx)
 			if (0!=getcpuidfield(CPUF_AVX2))
 			{
 				rt = SIMD_AVX_2;
+				if (0!=getcpuidfield(CPUF_AVX512F))
+				{
+					rt = SIMD_AVX_512F;
+					if (0!=getcpuidfield(CPUF_AVX512BW) && 0!=getcpuidfield(CPUF_AVX512DQ))
+					{
+						rt = SIMD_AVX_512BW;
+					}
+				}
 			}
 		}
 		if (NULL!=phwavx)	*phwavx=rt;
@@ -785,9 +856,13 @@ INLINE int	simd_avx_level(int* phwavx)
 		{
 			if (0!=getcpuidfield(CPUF_OSXSAVE))	// XGETBV enabled for application use.
 			{
-				uint32_t n = getcpuidfield(CPUF_XFeatureSupportedMaskLo);	// XCR0: XFeatureSupportedMask register.
+				uint32_t n = (uint32_t)getxcr(0);	// XCR0: XFEATURE_ENABLED_MASK register.
 				if (6==(n&6))	// XCR0[2:1] = ‘11b’ (XMM state and YMM state are enabled by OS).
 				{
+					if (rt>=SIMD_AVX_512F && 0xE0!=(n&0xE0))	// XCR0[7:5] = ‘111b’ (opmask, ZMM_Hi256 and Hi16_ZMM state are enabled by OS).
+					{
+						rt = SIMD_AVX_2;
+					}
 					return rt;
 				}
 			}
@@ -0,0 +1,662 @@
+﻿#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <errno.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <intrin.h>
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <x86intrin.h>
+#endif	// #if defined(_WIN32)
+
+#include "ccpuid.h"
+#include "simdsum.h"
+#include "simdbench.h"
+
+
+//////////////////////////////////////////////////
+// 计时
+//////////////////////////////////////////////////
+
+double simdbench_now(void)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER cnt, freq;
+	QueryPerformanceCounter(&cnt);
+	QueryPerformanceFrequency(&freq);
+	return (double)cnt.QuadPart / (double)freq.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif	// #if defined(_WIN32)
+}
+
+uint64_t simdbench_ticks(void)
+{
+	return (uint64_t)__rdtsc();
+}
+
+
+//////////////////////////////////////////////////
+// 配置
+//////////////////////////////////////////////////
+
+// 解析字节数. 可带K/M/G后缀（1K=1024）.
+// 不是非负整数、后缀之后还有字符或溢出时报错, 返回0（即不启用该项）.
+static size_t simdbench_parsesize(const char* sz)
+{
+	char* pend;
+	unsigned long long v;
+	int shift = 0;	// 后缀对应的移位数.
+	errno = 0;
+	v = strtoull(sz, &pend, 10);
+	if (pend==sz || '-'==*sz || ERANGE==errno || v > (unsigned long long)SIZE_MAX)	goto bad;
+	switch(*pend)
+	{
+	case 'k': case 'K':	shift = 10;	++pend;	break;
+	case 'm': case 'M':	shift = 20;	++pend;	break;
+	case 'g': case 'G':	shift = 30;	++pend;	break;
+	}
+	if (0!=*pend || v > (SIZE_MAX >> shift))	goto bad;
+	return (size_t)v << shift;
+bad:
+	fprintf(stderr, "invalid size: %s\n", sz);
+	return 0;
+}
+
+void simdbench_init(SIMDBENCH_CFG* pcfg, int argc, char* argv[])
+{
+	int i, j;
+	const char* sz;
+	pcfg->format = SIMDBENCH_FMT_TABLE;
+	pcfg->warmup = SIMDBENCH_WARMUP;
+	pcfg->trials = SIMDBENCH_TRIALS;
+	pcfg->mintime = SIMDBENCH_MINTIME;
+	pcfg->cntrows = 0;
+	pcfg->cbsweep = 0;
+	pcfg->gbpsread = 0;
+	pcfg->szfile = NULL;
+	pcfg->cbfile = 0;
+	pcfg->page = SIMDSUM_PAGE_4K;
+	pcfg->cbpagecmp = 0;
+	for(i=1; i<argc; ++i)
+	{
+		sz = argv[i];
+		if (0==strcmp(sz, "--format=csv"))	pcfg->format = SIMDBENCH_FMT_CSV;
+		else if (0==strcmp(sz, "--format=json"))	pcfg->format = SIMDBENCH_FMT_JSON;
+		else if (0==strcmp(sz, "--format=table"))	pcfg->format = SIMDBENCH_FMT_TABLE;
+		else if (0==strncmp(sz, "--warmup=", 9))	pcfg->warmup = atoi(sz+9);
+		else if (0==strncmp(sz, "--trials=", 9))	pcfg->trials = atoi(sz+9);
+		else if (0==strncmp(sz, "--mintime=", 10))	pcfg->mintime = atof(sz+10);
+		else if (0==strcmp(sz, "--sweep"))	pcfg->cbsweep = SIMDBENCH_SWEEP_MAX;
+		else if (0==strncmp(sz, "--sweep=", 8))	pcfg->cbsweep = simdbench_parsesize(sz+8);
+		else if (0==strncmp(sz, "--file=", 7))	pcfg->szfile = sz+7;
+		else if (0==strncmp(sz, "--filesize=", 11))	pcfg->cbfile = simdbench_parsesize(sz+11);
+		else if (0==strncmp(sz, "--pages=", 8))
+		{
+			for(j=SIMDSUM_PAGE_4K; j<=SIMDSUM_PAGE_HUGETLB; ++j)
+			{
+				if (0==strcmp(sz+8, simdsum_page_name(j)))	pcfg->page = j;
+			}
+		}
+		else if (0==strcmp(sz, "--pagecmp"))	pcfg->cbpagecmp = SIMDBENCH_PAGECMP_BYTES;
+		else if (0==strncmp(sz, "--pagecmp=", 10))	pcfg->cbpagecmp = simdbench_parsesize(sz+10);
+	}
+	if (pcfg->warmup < 0)	pcfg->warmup = 0;
+	if (pcfg->trials < 1)	pcfg->trials = 1;
+}
+
+FILE* simdbench_info(const SIMDBENCH_CFG* pcfg)
+{
+	return (SIMDBENCH_FMT_TABLE==pcfg->format) ? stdout : stderr;
+}
+
+
+//////////////////////////////////////////////////
+// 测试
+//////////////////////////////////////////////////
+
+// qsort用的比较函数.
+static int simdbench_cmp(const void* a, const void* b)
+{
+	double x = *(const double*)a;
+	double y = *(const double*)b;
+	return (x<y) ? -1 : ((x>y) ? 1 : 0);
+}
+
+// 统计并填写结果. 周期数与时间分别排序, 取各自的中位数.
+static void simdbench_stat(SIMDBENCH_RESULT* pres, const char* szname, double* ptm, double* ptk, int n, int reps, size_t cntelem, size_t cbelem)
+{
+	qsort(ptm, n, sizeof(double), simdbench_cmp);
+	qsort(ptk, n, sizeof(double), simdbench_cmp);
+	pres->szName = szname;
+	pres->cntelem = cntelem;
+	pres->cbelem = cbelem;
+	pres->reps = reps;
+	pres->trials = n;
+	pres->tmin = ptm[0];
+	pres->tmed = (n&1) ? ptm[n/2] : (ptm[n/2-1] + ptm[n/2]) / 2;
+	pres->tp99 = ptm[(int)ceil(0.99 * n) - 1];
+	pres->gbps = (pres->tmed > 0) ? (double)cntelem * cbelem / pres->tmed * 1e-9 : 0;
+	pres->epc = (ptk[n/2] > 0) ? (double)cntelem / ptk[n/2] : 0;
+	pres->szNote[0] = 0;
+}
+
+// 分配各轮的时间数组, ptm与ptk各n项, 共用一块内存. 失败时报错, 并把结果置为0.
+static double* simdbench_alloctm(SIMDBENCH_RESULT* pres, const char* szname, int n, size_t cntelem, size_t cbelem)
+{
+	double* p = (double*)malloc(2 * (size_t)n * sizeof(double));
+	if (NULL==p)
+	{
+		fprintf(stderr, "%s: out of memory (%d trials).\n", szname, n);
+		memset(pres, 0, sizeof(*pres));
+		pres->szName = szname;
+		pres->cntelem = cntelem;
+		pres->cbelem = cbelem;
+	}
+	return p;
+}
+
+void simdbench_run(const SIMDBENCH_CFG* pcfg, SIMDBENCH_RESULT* pres, const char* szname, SIMDBENCH_PROC proc, void* param, size_t cntelem, size_t cbelem)
+{
+	int i, j;
+	int reps;	// 每轮的调用次数.
+	int n = pcfg->trials;
+	double t0, dt;
+	uint64_t tk0;
+	double* ptm = simdbench_alloctm(pres, szname, n, cntelem, cbelem);	// 各轮的单次调用时间.
+	double* ptk;	// 各轮的单次调用TSC周期数.
+	if (NULL==ptm)	return;
+	ptk = ptm + n;
+
+	// 估计调用次数, 使每轮不短于mintime. 第一次调用有缺页与缓存未命中, 不计入; 之后取3次中最快的.
+	proc(param);
+	dt = 0;
+	for(i=0; i<3; ++i)
+	{
+		t0 = simdbench_now();
+		proc(param);
+		t0 = simdbench_now() - t0;
+		if (0==i || t0 < dt)	dt = t0;
+	}
+	reps = 1;
+	if (dt < pcfg->mintime)
+	{
+		reps = (dt > 0) ? (int)ceil(pcfg->mintime / dt) : 1000;
+		if (reps > 1000000)	reps = 1000000;
+	}
+
+	// 预热.
+	for(i=0; i<pcfg->warmup; ++i)
+	{
+		for(j=0; j<reps; ++j)	proc(param);
+	}
+
+	// 计时.
+	for(i=0; i<n; ++i)
+	{
+		tk0 = simdbench_ticks();
+		t0 = simdbench_now();
+		for(j=0; j<reps; ++j)	proc(param);
+		ptm[i] = (simdbench_now() - t0) / reps;
+		ptk[i] = (double)(simdbench_ticks() - tk0) / reps;
+	}
+
+	simdbench_stat(pres, szname, ptm, ptk, n, reps, cntelem, cbelem);
+	free(ptm);
+}
+
+void simdbench_run_prep(const SIMDBENCH_CFG* pcfg, SIMDBENCH_RESULT* pres, const char* szname, SIMDBENCH_PROC proc, SIMDBENCH_PROC prep, void* param, size_t cntelem, size_t cbelem)
+{
+	int i;
+	int n = pcfg->trials;
+	double t0;
+	uint64_t tk0;
+	double* ptm = simdbench_alloctm(pres, szname, n, cntelem, cbelem);	// 各轮的调用时间.
+	double* ptk;	// 各轮的调用TSC周期数.
+	if (NULL==ptm)	return;
+	ptk = ptm + n;
+
+	for(i=0; i<n; ++i)
+	{
+		prep(param);
+		tk0 = simdbench_ticks();
+		t0 = simdbench_now();
+		proc(param);
+		ptm[i] = simdbench_now() - t0;
+		ptk[i] = (double)(simdbench_ticks() - tk0);
+	}
+	simdbench_stat(pres, szname, ptm, ptk, n, 1, cntelem, cbelem);
+	free(ptm);
+}
+
+
+//////////////////////////////////////////////////
+// 文件
+//////////////////////////////////////////////////
+
+int simdbench_mkfile(const char* szpath, const void* pdata, size_t cbdata, size_t cb)
+{
+	size_t cbw;	// 本次写入的字节数.
+	int rt;
+	FILE* fp = fopen(szpath, "wb");
+	if (NULL==fp)	return errno;
+	for(; cb>0; cb-=cbw)
+	{
+		cbw = (cb < cbdata) ? cb : cbdata;
+		if (fwrite(pdata, 1, cbw, fp) != cbw)
+		{
+			rt = errno;
+			fclose(fp);
+			return rt;
+		}
+	}
+	if (0!=fclose(fp))	return errno;
+	return 0;
+}
+
+int simdbench_dropcache(const char* szpath)
+{
+#if defined(_WIN32)
+	(void)szpath;
+	return -1;
+#else
+	int rt;
+	int fd = open(szpath, O_RDONLY);
+	if (fd < 0)	return errno;
+	fdatasync(fd);	// 脏页不会被丢弃, 须先写回.
+	rt = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+	close(fd);
+	return rt;
+#endif	// #if defined(_WIN32)
+}
+
+int simdbench_isdevice(const char* szpath)
+{
+#if defined(_WIN32)
+	DWORD attr = GetFileAttributesA(szpath);
+	return (INVALID_FILE_ATTRIBUTES!=attr && 0!=(attr & FILE_ATTRIBUTE_DEVICE));
+#else
+	struct stat st;
+	if (0!=stat(szpath, &st))	return 0;	// 不存在时可以生成.
+	return !S_ISREG(st.st_mode);
+#endif	// #if defined(_WIN32)
+}
+
+int simdbench_open(const char* szpath)
+{
+#if defined(_WIN32)
+	return _open(szpath, _O_RDONLY | _O_BINARY);
+#else
+	return open(szpath, O_RDONLY);
+#endif	// #if defined(_WIN32)
+}
+
+void simdbench_close(int fd)
+{
+#if defined(_WIN32)
+	_close(fd);
+#else
+	close(fd);
+#endif	// #if defined(_WIN32)
+}
+
+uint64_t simdbench_readfd(int fd, size_t cbchunk, uint64_t cblimit)
+{
+	uint64_t cbdone = 0;	// 已读的字节数.
+	size_t cb;	// 本次要读的字节数.
+#if defined(_WIN32)
+	int n;
+#else
+	ssize_t n;
+#endif	// #if defined(_WIN32)
+	char* p = (char*)simdbench_alloc(cbchunk);
+	if (NULL==p)	return 0;
+	for(;;)
+	{
+		cb = cbchunk;
+		if (0!=cblimit)
+		{
+			if (cbdone >= cblimit)	break;
+			if (cblimit-cbdone < cb)	cb = (size_t)(cblimit-cbdone);
+		}
+#if defined(_WIN32)
+		n = _read(fd, p, (unsigned)cb);
+#else
+		n = read(fd, p, cb);
+		if (n<0 && EINTR==errno)	continue;
+#endif	// #if defined(_WIN32)
+		if (n<=0)	break;
+		cbdone += (uint64_t)n;
+	}
+	simdbench_free(p);
+	return cbdone;
+}
+
+
+//////////////////////////////////////////////////
+// STREAM式基准
+//////////////////////////////////////////////////
+
+// 调用参数.
+typedef struct tagSIMDBENCH_STREAMCTX{
+	double*	pa;	// 数组a. 复制与三元组的目标.
+	double*	pb;	// 数组b.
+	double*	pc;	// 数组c.
+	size_t	cnt;	// 数组长度.
+	volatile uint64_t	r;	// 只读的结果. 避免调用被优化.
+}SIMDBENCH_STREAMCTX;
+
+static SIMDSUM_ARENA simdbench_stream_arena = {NULL, 0, 0, SIMDSUM_PAGE_4K};	// simdbench_stream_buf 所在的内存区. 页面类型与求和测试的数组相同.
+static double* simdbench_stream_buf = NULL;	// 各项测试共用的数组.
+static size_t simdbench_stream_cb = 0;	// simdbench_stream_buf 的字节数.
+
+static void simdbench_stream_free(void)
+{
+	simdsum_arena_free(&simdbench_stream_arena);
+	simdbench_stream_buf = NULL;
+	simdbench_stream_cb = 0;
+}
+
+static void simdbench_stream_read(void* param)
+{
+	SIMDBENCH_STREAMCTX* pctx = (SIMDBENCH_STREAMCTX*)param;
+	pctx->r = simd_stream_read(pctx->pa, pctx->cnt);
+}
+
+static void simdbench_stream_copy(void* param)
+{
+	SIMDBENCH_STREAMCTX* pctx = (SIMDBENCH_STREAMCTX*)param;
+	simd_stream_copy(pctx->pa, pctx->pb, pctx->cnt);
+}
+
+static void simdbench_stream_triad(void* param)
+{
+	SIMDBENCH_STREAMCTX* pctx = (SIMDBENCH_STREAMCTX*)param;
+	simd_stream_triad(pctx->pa, pctx->pb, pctx->pc, 3.0, pctx->cnt);
+}
+
+void simdbench_stream(SIMDBENCH_CFG* pcfg, const SIMDBENCH_CFG* pcfgrun, size_t cb, const char* sznote)
+{
+	size_t i;
+	size_t cnt = cb / sizeof(double);	// 总元素数.
+	SIMDBENCH_STREAMCTX ctx;
+	SIMDBENCH_RESULT res;
+
+	// 数组不够大时重新分配. 填入1.0, 三元组的结果总是4.0, 不会溢出或产生非规格化数.
+	if (cb > simdbench_stream_cb)
+	{
+		simdbench_stream_free();
+		if (0==simdsum_arena_init(&simdbench_stream_arena, cb, pcfg->page))	simdbench_stream_buf = (double*)simdsum_arena_alloc(&simdbench_stream_arena, cb);
+		if (NULL==simdbench_stream_buf)
+		{
+			fprintf(stderr, "stream: out of memory (%llu bytes).\n", (unsigned long long)cb);
+			pcfg->gbpsread = 0;
+			return;
+		}
+		simdbench_stream_cb = cb;
+	}
+	for(i=0; i<cnt; ++i)	simdbench_stream_buf[i] = 1.0;
+	pcfg->gbpsread = 0;	// 基准自身的百分比在测完只读后才有意义.
+
+	// 只读: 1个数组.
+	ctx.pa = simdbench_stream_buf;
+	ctx.cnt = cnt;
+	simdbench_run(pcfgrun, &res, "stream_read", simdbench_stream_read, &ctx, ctx.cnt, sizeof(double));
+	pcfg->gbpsread = res.gbps;
+	strcpy(res.szNote, sznote);
+	simdbench_print(pcfg, &res);
+
+	// 复制: 2个数组.
+	ctx.cnt = cnt / 2;
+	ctx.pb = ctx.pa + ctx.cnt;
+	simdbench_run(pcfgrun, &res, "stream_copy", simdbench_stream_copy, &ctx, ctx.cnt, 2*sizeof(double));
+	strcpy(res.szNote, sznote);
+	simdbench_print(pcfg, &res);
+
+	// 三元组: 3个数组.
+	ctx.cnt = cnt / 3;
+	ctx.pb = ctx.pa + ctx.cnt;
+	ctx.pc = ctx.pb + ctx.cnt;
+	simdbench_run(pcfgrun, &res, "stream_triad", simdbench_stream_triad, &ctx, ctx.cnt, 3*sizeof(double));
+	strcpy(res.szNote, sznote);
+	simdbench_print(pcfg, &res);
+}
+
+
+//////////////////////////////////////////////////
+// 输出
+//////////////////////////////////////////////////
+
+// 输出JSON字符串. 只转义引号、反斜杠与控制字符.
+static void simdbench_jsonstr(const char* sz)
+{
+	putchar('"');
+	for(; 0!=*sz; ++sz)
+	{
+		if ('"'==*sz || '\\'==*sz)	printf("\\%c", *sz);
+		else if ((unsigned char)*sz < 0x20)	printf("\\u%04x", (unsigned char)*sz);
+		else	putchar(*sz);
+	}
+	putchar('"');
+}
+
+// 输出CSV字段. 总是加引号, 字段内的引号写两次. 名称中常有逗号, 例如 simd_sum_i32(loop,short).
+static void simdbench_csvstr(const char* sz)
+{
+	putchar('"');
+	for(; 0!=*sz; ++sz)
+	{
+		if ('"'==*sz)	putchar('"');
+		putchar(*sz);
+	}
+	putchar('"');
+}
+
+void simdbench_print(SIMDBENCH_CFG* pcfg, const SIMDBENCH_RESULT* pres)
+{
+	double pctread = (pcfg->gbpsread > 0) ? pres->gbps / pcfg->gbpsread * 100 : 0;	// 占只读带宽的百分比.
+	switch(pcfg->format)
+	{
+	case SIMDBENCH_FMT_CSV:
+		if (0==pcfg->cntrows)	printf("name,elements,bytes,reps,trials,min_us,median_us,p99_us,gbps,elem_per_cycle,pct_read,note\n");
+		simdbench_csvstr(pres->szName);
+		printf(",%llu,%llu,%d,%d,%.3f,%.3f,%.3f,%.3f,%.4f,", (unsigned long long)pres->cntelem, (unsigned long long)(pres->cntelem*pres->cbelem), pres->reps, pres->trials
+			, pres->tmin*1e6, pres->tmed*1e6, pres->tp99*1e6, pres->gbps, pres->epc);
+		if (pcfg->gbpsread > 0)	printf("%.1f", pctread);
+		putchar(',');
+		simdbench_csvstr(pres->szNote);
+		putchar('\n');
+		break;
+	case SIMDBENCH_FMT_JSON:
+		printf((0==pcfg->cntrows) ? "{\"results\":[\n" : ",\n");
+		printf("{\"name\":");
+		simdbench_jsonstr(pres->szName);
+		printf(",\"elements\":%llu,\"bytes\":%llu,\"reps\":%d,\"trials\":%d,\"min_us\":%.3f,\"median_us\":%.3f,\"p99_us\":%.3f,\"gbps\":%.3f,\"elem_per_cycle\":%.4f"
+			, (unsigned long long)pres->cntelem, (unsigned long long)(pres->cntelem*pres->cbelem), pres->reps, pres->trials
+			, pres->tmin*1e6, pres->tmed*1e6, pres->tp99*1e6, pres->gbps, pres->epc);
+		if (pcfg->gbpsread > 0)	printf(",\"pct_read\":%.1f,\"note\":", pctread);
+		else	printf(",\"pct_read\":null,\"note\":");
+		simdbench_jsonstr(pres->szNote);
+		printf("}");
+		break;
+	default:
+		if (0==pcfg->cntrows)	printf("%-28s %10s %10s %10s %8s %8s %6s  %s\n", "name", "min(us)", "med(us)", "p99(us)", "GB/s", "elem/clk", "%read", "note");
+		printf("%-28s %10.2f %10.2f %10.2f %8.2f %8.3f ", pres->szName, pres->tmin*1e6, pres->tmed*1e6, pres->tp99*1e6, pres->gbps, pres->epc);
+		if (pcfg->gbpsread > 0)	printf("%6.1f", pctread);
+		else	printf("%6s", "-");
+		printf("  %s\n", pres->szNote);
+		break;
+	}
+	++pcfg->cntrows;
+	fflush(stdout);
+}
+
+void simdbench_end(SIMDBENCH_CFG* pcfg)
+{
+	simdbench_stream_free();
+	if (SIMDBENCH_FMT_JSON==pcfg->format)
+	{
+		printf((0==pcfg->cntrows) ? "{\"results\":[]}\n" : "\n]}\n");
+	}
+	fflush(stdout);
+}
+
+
+//////////////////////////////////////////////////
+// 工作集扫描
+//////////////////////////////////////////////////
+
+void* simdbench_alloc(size_t cb)
+{
+#if defined(_WIN32)
+	return _aligned_malloc(cb, 64);
+#else
+	void* p = NULL;
+	if (0!=posix_memalign(&p, 64, cb))	return NULL;
+	return p;
+#endif	// #if defined(_WIN32)
+}
+
+void simdbench_free(void* p)
+{
+#if defined(_WIN32)
+	_aligned_free(p);
+#else
+	free(p);
+#endif	// #if defined(_WIN32)
+}
+
+size_t simdbench_cachesize(int level)
+{
+	static size_t s_cbcache[4] = {0};	// 各级缓存的字节数. [0]非0表示已检测.
+	int i;
+	if (level<1 || level>3)	return 0;
+	if (0==s_cbcache[0])
+	{
+		for(i=1; i<=3; ++i)	s_cbcache[i] = cpu_getcachesize(i);
+		s_cbcache[0] = 1;
+	}
+	return s_cbcache[level];
+}
+
+int simdbench_cachelevel(size_t cb)
+{
+	int i;
+	for(i=1; i<=3; ++i)
+	{
+		if (cb <= simdbench_cachesize(i))	return i;
+	}
+	return 4;
+}
+
+size_t simdbench_sweep_next(size_t cb)
+{
+	return (0==(cb & (cb-1))) ? cb/2*3 : cb/3*4;
+}
+
+void simdbench_sweep_cfg(const SIMDBENCH_CFG* pcfg, SIMDBENCH_CFG* pcfgsize, size_t cb)
+{
+	*pcfgsize = *pcfg;
+	if ((double)cb * pcfg->trials > SIMDBENCH_SWEEP_BYTES)
+	{
+		pcfgsize->trials = (int)(SIMDBENCH_SWEEP_BYTES / cb);
+		if (pcfgsize->trials < 3)	pcfgsize->trials = 3;
+		if (pcfgsize->trials > pcfg->trials)	pcfgsize->trials = pcfg->trials;
+	}
+	if (pcfgsize->warmup > pcfgsize->trials)	pcfgsize->warmup = pcfgsize->trials;
+}
+
+// 字节数的文字. 使用能整除的最大单位.
+static void simdbench_sizestr(char* sz, size_t cb)
+{
+	if (0!=cb && 0==(cb & ((1U<<30)-1)))	sprintf(sz, "%lluGB", (unsigned long long)(cb>>30));
+	else if (0!=cb && 0==(cb & ((1U<<20)-1)))	sprintf(sz, "%lluMB", (unsigned long long)(cb>>20));
+	else if (0!=cb && 0==(cb & ((1U<<10)-1)))	sprintf(sz, "%lluKB", (unsigned long long)(cb>>10));
+	else	sprintf(sz, "%lluB", (unsigned long long)cb);
+}
+
+void simdbench_sweep_note(char* sznote, size_t cb)
+{
+	int level = simdbench_cachelevel(cb);
+	simdbench_sizestr(sznote, cb);
+	if (level<=3)	sprintf(sznote + strlen(sznote), " L%d", level);
+	else	strcat(sznote, " mem");
+}
+
+void simdbench_sweep_mark(FILE* fp, size_t cbprev, size_t cb)
+{
+	char szSize[32];
+	int i;
+	int level = simdbench_cachelevel(cb);
+	if (0==cbprev)
+	{
+		for(i=1; i<=3; ++i)
+		{
+			simdbench_sizestr(szSize, simdbench_cachesize(i));
+			fprintf(fp, "L%d:\t%s\n", i, (0!=simdbench_cachesize(i)) ? szSize : "-");
+		}
+		fprintf(fp, "\n");
+	}
+	else if (level != (i = simdbench_cachelevel(cbprev)))
+	{
+		// 工作集超出了第i级缓存.
+		simdbench_sizestr(szSize, simdbench_cachesize(i));
+		if (level<=3)	fprintf(fp, "---- > L%d (%s), L%d ----\n", i, szSize, level);
+		else	fprintf(fp, "---- > L%d (%s), mem ----\n", i, szSize);
+	}
+	fflush(fp);
+}
+
+
+//////////////////////////////////////////////////
+// 分段求和
+//////////////////////////////////////////////////
+
+// 生成一段的长度.
+static size_t simdbench_seglen(int dist)
+{
+	switch(dist)
+	{
+	case SIMDBENCH_SEG_SHORT:
+		return 1 + rand()%16;
+	case SIMDBENCH_SEG_FIXED:
+		return 64;
+	case SIMDBENCH_SEG_UNIFORM:
+		return 10 + rand()%491;
+	default:
+		if (rand()%10 != 0)	return 1 + rand()%32;
+		return 256 + rand()%1793;
+	}
+}
+
+size_t simdbench_segoffs(size_t* poffs, size_t cntbuf, int dist)
+{
+	size_t cntseg = 0;	// 段数.
+	size_t n;
+	poffs[0] = 0;
+	for(;;)
+	{
+		n = simdbench_seglen(dist);
+		if (n > cntbuf - poffs[cntseg])	break;
+		poffs[cntseg+1] = poffs[cntseg] + n;
+		++cntseg;
+	}
+	return cntseg;
+}
+
+const char* simdbench_seg_name(int dist)
+{
+	static const char* const s_szName[SIMDBENCH_SEG_COUNT] = {"short", "64", "10-500", "skewed"};
+	if (dist<0 || dist>=SIMDBENCH_SEG_COUNT)	return "";
+	return s_szName[dist];
+}
@@ -0,0 +1,227 @@
+﻿#ifndef __SIMDBENCH_H_INCLUDED
+#define __SIMDBENCH_H_INCLUDED
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "stdint.h"
+
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////
+// simdbench: 基准测试工具.
+// 先预热, 再计时多轮, 报告单次调用时间的最小值/中位数/p99, 以及带宽和每周期处理的元素数.
+////////////////////////////////////////
+
+// 输出格式.
+#define SIMDBENCH_FMT_TABLE	0	// 表格. 默认.
+#define SIMDBENCH_FMT_CSV	1	// CSV. 第一行为表头.
+#define SIMDBENCH_FMT_JSON	2	// JSON. 整个输出是一个对象, 结果在 "results" 数组中.
+
+// 默认参数. 可用命令行参数修改, 详见 simdbench_init.
+#define SIMDBENCH_WARMUP	3	// 预热轮数. 不计入结果.
+#define SIMDBENCH_TRIALS	50	// 计时轮数.
+#define SIMDBENCH_MINTIME	0.002	// 每轮的最短时间（秒）. 单次调用太快时, 每轮会重复调用多次.
+
+// 工作集扫描. 数组大小从SIMDBENCH_SWEEP_MIN开始, 按约√2倍（交替×1.5与×4/3）递增, 直至最大字节数.
+#define SIMDBENCH_SWEEP_MIN	4096	// 最小字节数.
+#define SIMDBENCH_SWEEP_MAX	((size_t)1 << (sizeof(size_t)>4 ? 31 : 29))	// 默认的最大字节数. 64位下为2GB, 32位下为512MB.
+#define SIMDBENCH_SWEEP_BYTES	(64*1024*1024)	// 每项测试计时的数据量. 工作集较大时按它减少计时轮数（至少3轮）, 以免扫描耗时过长.
+
+#define SIMDBENCH_DEVICE_BYTES	(1024*1024*1024)	// 文件求和测试的输入为设备或管道时, 默认读取的字节数.
+#define SIMDBENCH_PAGECMP_BYTES	((size_t)1 << (sizeof(size_t)>4 ? 30 : 28))	// 页面对比测试默认的字节数. 远大于末级缓存. 64位下为1GB, 32位下为256MB.
+
+// 测试配置.
+typedef struct tagSIMDBENCH_CFG{
+	int	format;	// 输出格式. 详见SIMDBENCH_FMT_常数.
+	int	warmup;	// 预热轮数.
+	int	trials;	// 计时轮数.
+	double	mintime;	// 每轮的最短时间（秒）.
+	int	cntrows;	// 已输出的结果数. 用于输出表头与JSON分隔符.
+	size_t	cbsweep;	// 工作集扫描的最大字节数. 0表示不扫描.
+	double	gbpsread;	// 只读带宽(GB/s). 由 simdbench_stream 设置. 非0时输出各结果占它的百分比（%read）.
+	const char*	szfile;	// 文件求和测试的文件路径. NULL表示不测试.
+	size_t	cbfile;	// 测试前生成的文件大小（字节）. 0表示使用已有的文件.
+	int	page;	// 大数组（工作集扫描、STREAM基准）的页面类型. 详见SIMDSUM_PAGE_常数.
+	size_t	cbpagecmp;	// 页面对比测试的字节数. 0表示不测试.
+}SIMDBENCH_CFG;
+
+// 测试结果. 时间均为单次调用的秒数.
+typedef struct tagSIMDBENCH_RESULT{
+	const char*	szName;	// 名称.
+	size_t	cntelem;	// 每次调用处理的元素数.
+	size_t	cbelem;	// 元素的字节数.
+	int	reps;	// 每轮的调用次数.
+	int	trials;	// 计时轮数.
+	double	tmin;	// 最小值.
+	double	tmed;	// 中位数.
+	double	tp99;	// 第99百分位数.
+	double	gbps;	// 带宽(GB/s, 1GB=1e9字节). 按中位数计算.
+	double	epc;	// 每个TSC周期处理的元素数. 按中位数计算. TSC频率固定, 与睿频无关.
+	char	szNote[96];	// 附加说明, 例如求和结果. 由调用者填写.
+}SIMDBENCH_RESULT;
+
+// 被测函数. 每次调用执行一次被测操作.
+typedef void (*SIMDBENCH_PROC)(void* param);
+
+// 初始化配置, 并解析命令行参数. 不认识的参数会被忽略.
+// --format=table|csv|json  输出格式.
+// --warmup=N  预热轮数.
+// --trials=N  计时轮数.
+// --mintime=S  每轮的最短时间（秒）.
+// --sweep[=SIZE]  工作集扫描. SIZE为最大字节数, 可带K/M/G后缀, 默认为SIMDBENCH_SWEEP_MAX.
+// --file=PATH  文件求和测试. PATH为原始二进制数组文件.
+// --pages=4k|thp|hugetlb  大数组的页面类型. 默认为4k.
+// --pagecmp[=SIZE]  页面对比测试. 在SIZE字节的数组上对比普通页与大页, 默认为SIMDBENCH_PAGECMP_BYTES.
+// --filesize=SIZE  测试前先生成文件, 大小可带K/M/G后缀. 已有的文件会被覆盖. PATH为设备或管道时, 为读取的字节数（默认为SIMDBENCH_DEVICE_BYTES）.
+void simdbench_init(SIMDBENCH_CFG* pcfg, int argc, char* argv[]);
+
+// 说明文字的输出流. 表格格式时为stdout, 否则为stderr, 以免混入CSV/JSON.
+FILE* simdbench_info(const SIMDBENCH_CFG* pcfg);
+
+// 取得单调时钟（秒）. UNIX下为 clock_gettime(CLOCK_MONOTONIC).
+double simdbench_now(void);
+
+// 读取时间戳计数器(TSC).
+uint64_t simdbench_ticks(void);
+
+// 进行测试.
+//
+// pcfg: 测试配置.
+// pres: 返回测试结果. szNote置为空串. 内存不足时报错, 各项为0.
+// szname: 名称. 只保存指针, 输出前须保持有效.
+// proc: 被测函数.
+// param: 传给被测函数的参数.
+// cntelem: 每次调用处理的元素数.
+// cbelem: 元素的字节数.
+void simdbench_run(const SIMDBENCH_CFG* pcfg, SIMDBENCH_RESULT* pres, const char* szname, SIMDBENCH_PROC proc, void* param, size_t cntelem, size_t cbelem);
+
+// 进行测试_每轮前准备. 每轮先调用prep（不计时）, 再调用一次proc. 不预热.
+// 用于每次调用前都需要恢复初始状态的测试, 例如清空页缓存后的冷读.
+//
+// prep: 准备函数. 参数与proc相同.
+// 其余参数与 simdbench_run 相同.
+void simdbench_run_prep(const SIMDBENCH_CFG* pcfg, SIMDBENCH_RESULT* pres, const char* szname, SIMDBENCH_PROC proc, SIMDBENCH_PROC prep, void* param, size_t cntelem, size_t cbelem);
+
+// 按配置的格式输出一条结果. 第一条之前会输出表头.
+void simdbench_print(SIMDBENCH_CFG* pcfg, const SIMDBENCH_RESULT* pres);
+
+// 结束输出. JSON格式时输出结尾的括号. 并释放 simdbench_stream 的数组.
+void simdbench_end(SIMDBENCH_CFG* pcfg);
+
+// 生成文件. 重复写入pdata, 直至cb字节.
+//
+// result: 成功时返回0, 否则返回errno.
+// szpath: 文件路径. 已有的文件会被覆盖.
+// pdata: 数据.
+// cbdata: 数据的字节数.
+// cb: 文件的字节数.
+int simdbench_mkfile(const char* szpath, const void* pdata, size_t cbdata, size_t cb);
+
+// 清空文件在页缓存中的页面, 之后再读取时需要访问磁盘. 先写回脏页, 再用 posix_fadvise(POSIX_FADV_DONTNEED).
+//
+// result: 成功时返回0, 否则返回错误码. Windows下不支持, 总是返回-1.
+// szpath: 文件路径.
+int simdbench_dropcache(const char* szpath);
+
+// 判断路径是否为设备、管道等非普通文件. 此类输入无法映射, 只测试流水线读取求和, 也不会被生成文件覆盖.
+int simdbench_isdevice(const char* szpath);
+
+// 只读打开文件. Windows下为二进制模式.
+//
+// result: 成功时返回文件描述符, 否则返回-1.
+// szpath: 文件路径.
+int simdbench_open(const char* szpath);
+
+// 关闭 simdbench_open 打开的文件.
+void simdbench_close(int fd);
+
+// 只读取、不处理数据, 用于测量I/O带宽. 与 simd_sum_fd_* 一样按块调用read().
+//
+// result: 返回读取的字节数.
+// fd: 文件描述符.
+// cbchunk: 每次读取的字节数.
+// cblimit: 最多读取的字节数. 0表示读到文件结尾.
+uint64_t simdbench_readfd(int fd, size_t cbchunk, uint64_t cblimit);
+
+// STREAM式基准: 测试只读、复制、三元组（均为双精度浮点数组）的带宽并输出, 再将只读带宽保存到 pcfg->gbpsread.
+// 各项涉及的数组总大小均为cb字节, 与同样大小的求和测试处于同一级缓存. 带宽按STREAM的惯例计算: 复制每元素16字节, 三元组每元素24字节.
+// 之后输出的结果都会附带占只读带宽的百分比. 远低于100%说明受计算限制, 接近100%则说明已受内存（或缓存）带宽限制, 再增加SIMD并行度也不会更快.
+//
+// pcfg: 测试配置. 用于输出, 并保存只读带宽.
+// pcfgrun: 计时所用的配置. 一般与pcfg相同, 工作集扫描时为 simdbench_sweep_cfg 的结果.
+// cb: 工作集的字节数.
+// sznote: 各结果的附加说明.
+void simdbench_stream(SIMDBENCH_CFG* pcfg, const SIMDBENCH_CFG* pcfgrun, size_t cb, const char* sznote);
+
+// 分配按缓存行（64字节）对齐的内存. 用于工作集扫描等较大的数组.
+//
+// result: 返回首地址. 失败时返回NULL.
+// cb: 字节数.
+void* simdbench_alloc(size_t cb);
+
+// 释放 simdbench_alloc 分配的内存.
+void simdbench_free(void* p);
+
+// 取得数据缓存的字节数. 首次调用时用CPUID（ccpuid.h 的 cpu_getcachesize）检测.
+//
+// result: 返回字节数. 没有该级缓存或无法检测时返回0.
+// level: 缓存级别. 1~3.
+size_t simdbench_cachesize(int level);
+
+// 取得能容纳工作集的最低缓存级别.
+//
+// result: 返回缓存级别1~3. 各级缓存都容纳不下时返回4, 表示内存.
+// cb: 工作集的字节数.
+int simdbench_cachelevel(size_t cb);
+
+// 工作集扫描的下一个字节数. 2的幂乘以1.5, 否则乘以4/3. 以SIMDBENCH_SWEEP_MIN开始时, 结果均为1KB的整数倍.
+size_t simdbench_sweep_next(size_t cb);
+
+// 工作集扫描时某一大小所用的配置. 计时轮数按SIMDBENCH_SWEEP_BYTES减少, 预热轮数不多于计时轮数.
+//
+// pcfg: 原配置.
+// pcfgsize: 返回该大小所用的配置. 只应传给 simdbench_run, 输出时仍用原配置.
+// cb: 工作集的字节数.
+void simdbench_sweep_cfg(const SIMDBENCH_CFG* pcfg, SIMDBENCH_CFG* pcfgsize, size_t cb);
+
+// 工作集扫描的附加说明, 格式为“大小 级别”, 例如 "48KB L1", "64MB mem".
+//
+// sznote: 返回说明文字. 不超过32个字符.
+// cb: 工作集的字节数.
+void simdbench_sweep_note(char* sznote, size_t cb);
+
+// 输出检测到的各级缓存大小, 并在工作集跨过某级缓存时输出分界线.
+//
+// fp: 输出流. 一般为 simdbench_info 的返回值.
+// cbprev: 上一个字节数. 为0时输出各级缓存的大小.
+// cb: 当前字节数.
+void simdbench_sweep_mark(FILE* fp, size_t cbprev, size_t cb);
+
+// 分段求和测试的段长分布.
+#define SIMDBENCH_SEG_SHORT	0	// 1~16, 均匀分布. 多数段不足一个向量.
+#define SIMDBENCH_SEG_FIXED	1	// 固定为64.
+#define SIMDBENCH_SEG_UNIFORM	2	// 10~500, 均匀分布.
+#define SIMDBENCH_SEG_SKEWED	3	// 偏斜: 约90%为1~32, 其余为256~2048.
+#define SIMDBENCH_SEG_COUNT	4	// 分布的个数.
+
+// 生成分段求和测试的偏移数组（CSR式）. 用rand()随机生成各段的长度, 依次排列, 直至下一段将超出数组.
+//
+// result: 返回段数.
+// poffs: 返回偏移数组. 至少需要 cntbuf+1 项.
+// cntbuf: 数组长度.
+// dist: 段长分布. 详见SIMDBENCH_SEG_常数.
+size_t simdbench_segoffs(size_t* poffs, size_t cntbuf, int dist);
+
+// 取得段长分布的名称, 例如 "short", "10-500".
+const char* simdbench_seg_name(int dist);
+
+
+#if defined __cplusplus
+};
+#endif
+
+#endif	// #ifndef __SIMDBENCH_H_INCLUDED
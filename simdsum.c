@@ -0,0 +1,1486 @@
+﻿#include <stdlib.h>
+#include <string.h>
+
+#include "zintrin.h"
+#include "ccpuid.h"
+#include "simdsum.h"
+
+
+//////////////////////////////////////////////////
+// ISA: 指令集级别的检测
+//////////////////////////////////////////////////
+
+// 指令集级别的名称. 也是环境变量SIMDSUM_ISA的取值.
+static const char* const simdsum_isa_names[SIMDSUM_ISA_MAX+1] = {
+	"base",
+	"mmx",
+	"sse",
+	"sse2",
+	"sse41",
+	"avx",
+	"f16c",
+	"fma",
+	"avx2",
+	"avx512",
+};
+
+static int simdsum_isa_hw = -1;	// 硬件支持的指令集级别. -1表示尚未检测.
+static int simdsum_isa_cur = -1;	// 实际使用的指令集级别. -1表示尚未检测.
+
+// 检测硬件（含操作系统）支持的指令集级别.
+static int simdsum_detect(void)
+{
+	int rt = SIMDSUM_ISA_BASE;
+	int sse = simd_sse_level(NULL);
+	int avx = simd_avx_level(NULL);
+	if (simd_mmx(NULL))	rt = SIMDSUM_ISA_MMX;
+	if (sse >= SIMD_SSE_1)	rt = SIMDSUM_ISA_SSE;
+	if (sse >= SIMD_SSE_2)
+	{
+		rt = SIMDSUM_ISA_SSE2;
+		if (sse >= SIMD_SSE_41)	rt = SIMDSUM_ISA_SSE41;
+		if (avx >= SIMD_AVX_1)	rt = SIMDSUM_ISA_AVX;
+		if (SIMDSUM_ISA_AVX==rt && getcpuidfield(CPUF_F16C))	rt = SIMDSUM_ISA_F16C;
+		if (SIMDSUM_ISA_F16C==rt && getcpuidfield(CPUF_FMA))	rt = SIMDSUM_ISA_FMA;
+		if (avx >= SIMD_AVX_2 && SIMDSUM_ISA_FMA==rt)	rt = SIMDSUM_ISA_AVX2;	// 更高的级别都要求FMA.
+		if (avx >= SIMD_AVX_512BW && SIMDSUM_ISA_AVX2==rt)	rt = SIMDSUM_ISA_AVX512;
+	}
+	return rt;
+}
+
+// 根据环境变量SIMDSUM_ISA限制指令集级别. 只能降低, 不能超过硬件级别.
+static int simdsum_env_limit(int isa)
+{
+	int i;
+	const char* sz = getenv(SIMDSUM_ENV_ISA);
+	if (NULL==sz || 0==sz[0])	return isa;
+	for(i=0; i<=SIMDSUM_ISA_MAX; ++i)
+	{
+		if (0==strcmp(sz, simdsum_isa_names[i]))
+		{
+			return (i < isa) ? i : isa;
+		}
+	}
+	return isa;	// 无法识别时忽略.
+}
+
+const char* simdsum_isa_name(int isa)
+{
+	if (isa<0 || isa>SIMDSUM_ISA_MAX)	return "";
+	return simdsum_isa_names[isa];
+}
+
+
+//////////////////////////////////////////////////
+// simd_sum: 运行时分派
+//////////////////////////////////////////////////
+
+static int32_t simdsum_init_i32(const int32_t* pbuf, size_t cntbuf);
+static float simdsum_init_f32(const float* pbuf, size_t cntbuf);
+static double simdsum_init_f64(const double* pbuf, size_t cntbuf);
+static float simdsum_init_f32_kahan(const float* pbuf, size_t cntbuf);
+static double simdsum_init_f64_kahan(const double* pbuf, size_t cntbuf);
+static int64_t simdsum_init_i32_wide(const int32_t* pbuf, size_t cntbuf);
+static void simdsum_init_i32_seg(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums);
+static void simdsum_init_f32_seg(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums);
+static void simdsum_init_f64_seg(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums);
+static void simdsum_init_i32_stats(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+static void simdsum_init_f32_stats(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+static void simdsum_init_f64_stats(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+static float simdsum_init_f32_dot(const float* pa, const float* pb, size_t cntbuf);
+static double simdsum_init_f64_dot(const double* pa, const double* pb, size_t cntbuf);
+static int32_t simdsum_init_i32_scan(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl);
+static int64_t simdsum_init_i64_scan(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl);
+static float simdsum_init_f32_scan(float* pdst, const float* psrc, size_t cntbuf, float init, int excl);
+static double simdsum_init_f64_scan(double* pdst, const double* psrc, size_t cntbuf, double init, int excl);
+static int32_t simdsum_init_i32_stride(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+static float simdsum_init_f32_stride(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+static double simdsum_init_f64_stride(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+static float simdsum_init_f16(const uint16_t* pbuf, size_t cntbuf);
+static float simdsum_init_bf16(const uint16_t* pbuf, size_t cntbuf);
+static uint64_t simdsum_init_u8(const uint8_t* pbuf, size_t cntbuf);
+static int64_t simdsum_init_i8(const int8_t* pbuf, size_t cntbuf);
+static int64_t simdsum_init_i16(const int16_t* pbuf, size_t cntbuf);
+static int64_t simdsum_init_i64(const int64_t* pbuf, size_t cntbuf);
+static uint64_t simdsum_init_u64(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry);
+static int32_t simdsum_init_i32_where(const int32_t* pval, const int32_t* pkey, size_t cntbuf, int32_t lo, int32_t hi, int flags);
+static float simdsum_init_f32_where(const float* pval, const float* pkey, size_t cntbuf, float lo, float hi, int flags);
+static double simdsum_init_f64_where(const double* pval, const double* pkey, size_t cntbuf, double lo, double hi, int flags);
+static float simdsum_init_f32_nan(const float* pbuf, size_t cntbuf, size_t* pcnt);
+static double simdsum_init_f64_nan(const double* pbuf, size_t cntbuf, size_t* pcnt);
+static int32_t simdsum_init_i32_nta(const int32_t* pbuf, size_t cntbuf);
+static float simdsum_init_f32_nta(const float* pbuf, size_t cntbuf);
+static double simdsum_init_f64_nta(const double* pbuf, size_t cntbuf);
+static uint64_t simdsum_init_stream_read(const double* pbuf, size_t cntbuf);
+static void simdsum_init_stream_copy(double* pdst, const double* psrc, size_t cntbuf);
+static void simdsum_init_stream_triad(double* pa, const double* pb, const double* pc, double s, size_t cntbuf);
+
+// 缓存的内核指针. 初值指向初始化桩函数, 以便在加载时初始化之前被调用时也能正确工作.
+static SUMI32PROC simdsum_pfn_i32 = simdsum_init_i32;
+static SUMF32PROC simdsum_pfn_f32 = simdsum_init_f32;
+static SUMF64PROC simdsum_pfn_f64 = simdsum_init_f64;
+static SUMF32PROC simdsum_pfn_f32_kahan = simdsum_init_f32_kahan;
+static SUMF64PROC simdsum_pfn_f64_kahan = simdsum_init_f64_kahan;
+static SUMI32WIDEPROC simdsum_pfn_i32_wide = simdsum_init_i32_wide;
+static SUMI32SEGPROC simdsum_pfn_i32_seg = simdsum_init_i32_seg;
+static SUMF32SEGPROC simdsum_pfn_f32_seg = simdsum_init_f32_seg;
+static SUMF64SEGPROC simdsum_pfn_f64_seg = simdsum_init_f64_seg;
+static SUMI32STATSPROC simdsum_pfn_i32_stats = simdsum_init_i32_stats;
+static SUMF32STATSPROC simdsum_pfn_f32_stats = simdsum_init_f32_stats;
+static SUMF64STATSPROC simdsum_pfn_f64_stats = simdsum_init_f64_stats;
+static DOTF32PROC simdsum_pfn_f32_dot = simdsum_init_f32_dot;
+static DOTF64PROC simdsum_pfn_f64_dot = simdsum_init_f64_dot;
+static SCANI32PROC simdsum_pfn_i32_scan = simdsum_init_i32_scan;
+static SCANI64PROC simdsum_pfn_i64_scan = simdsum_init_i64_scan;
+static SCANF32PROC simdsum_pfn_f32_scan = simdsum_init_f32_scan;
+static SCANF64PROC simdsum_pfn_f64_scan = simdsum_init_f64_scan;
+static SUMI32STRIDEPROC simdsum_pfn_i32_stride = simdsum_init_i32_stride;
+static SUMF32STRIDEPROC simdsum_pfn_f32_stride = simdsum_init_f32_stride;
+static SUMF64STRIDEPROC simdsum_pfn_f64_stride = simdsum_init_f64_stride;
+static SUMF16PROC simdsum_pfn_f16 = simdsum_init_f16;
+static SUMF16PROC simdsum_pfn_bf16 = simdsum_init_bf16;
+static SUMU8PROC simdsum_pfn_u8 = simdsum_init_u8;
+static SUMI8PROC simdsum_pfn_i8 = simdsum_init_i8;
+static SUMI16PROC simdsum_pfn_i16 = simdsum_init_i16;
+static SUMI64PROC simdsum_pfn_i64 = simdsum_init_i64;
+static SUMU64PROC simdsum_pfn_u64 = simdsum_init_u64;
+static SUMI32WHEREPROC simdsum_pfn_i32_where = simdsum_init_i32_where;
+static SUMF32WHEREPROC simdsum_pfn_f32_where = simdsum_init_f32_where;
+static SUMF64WHEREPROC simdsum_pfn_f64_where = simdsum_init_f64_where;
+static SUMF32NANPROC simdsum_pfn_f32_nan = simdsum_init_f32_nan;
+static SUMF64NANPROC simdsum_pfn_f64_nan = simdsum_init_f64_nan;
+static SUMI32PROC simdsum_pfn_i32_nta = simdsum_init_i32_nta;
+static SUMF32PROC simdsum_pfn_f32_nta = simdsum_init_f32_nta;
+static SUMF64PROC simdsum_pfn_f64_nta = simdsum_init_f64_nta;
+static STREAMREADPROC simdsum_pfn_stream_read = simdsum_init_stream_read;
+static STREAMCOPYPROC simdsum_pfn_stream_copy = simdsum_init_stream_copy;
+static STREAMTRIADPROC simdsum_pfn_stream_triad = simdsum_init_stream_triad;
+
+static size_t simdsum_cbdist = SIMDSUM_PREFETCH_DIST;	// 预取距离（字节）.
+static size_t simdsum_cbline = SIMDSUM_CACHELINE;	// 缓存行大小（字节）.
+
+// 检测缓存行大小, 并读取环境变量SIMDSUM_PFDIST.
+static void simdsum_init_prefetch(void)
+{
+	size_t cb = getcpuidfield(CPUF_CLFlush) * 8;	// CLFLUSH的行大小, 以8字节为单位.
+	const char* sz = getenv(SIMDSUM_ENV_PREFETCH);
+	if (0==cb && getcpuidfield(CPUF_LFuncStd) >= 4)	cb = getcpuidfield(CPUF_Cache_LineSize) + 1;
+	if (0!=cb)	simdsum_cbline = cb;
+	if (NULL!=sz && 0!=sz[0])	simdsum_cbdist = (size_t)strtoul(sz, NULL, 10);
+}
+
+// 检测指令集并选定内核. 多个线程同时调用时结果相同, 故无需加锁.
+static void simdsum_init(void)
+{
+	int isa;
+	SUMI32PROC pfn_i32 = sumint_base;
+	SUMF32PROC pfn_f32 = sumfloat_base;
+	SUMF64PROC pfn_f64 = sumdouble_base;
+	SUMF32PROC pfn_f32_kahan = sumfloat_kahan_base;
+	SUMF64PROC pfn_f64_kahan = sumdouble_kahan_base;
+	SUMI32WIDEPROC pfn_i32_wide = sumint_wide_base;
+	SUMI32SEGPROC pfn_i32_seg = sumint_seg_base;
+	SUMF32SEGPROC pfn_f32_seg = sumfloat_seg_base;
+	SUMF64SEGPROC pfn_f64_seg = sumdouble_seg_base;
+	SUMI32STATSPROC pfn_i32_stats = sumint_stats_base;
+	SUMF32STATSPROC pfn_f32_stats = sumfloat_stats_base;
+	SUMF64STATSPROC pfn_f64_stats = sumdouble_stats_base;
+	DOTF32PROC pfn_f32_dot = dotfloat_base;
+	DOTF64PROC pfn_f64_dot = dotdouble_base;
+	SCANI32PROC pfn_i32_scan = scanint_base;
+	SCANI64PROC pfn_i64_scan = scanint64_base;
+	SCANF32PROC pfn_f32_scan = scanfloat_base;
+	SCANF64PROC pfn_f64_scan = scandouble_base;
+	SUMI32STRIDEPROC pfn_i32_stride = sumint_stride_base;
+	SUMF32STRIDEPROC pfn_f32_stride = sumfloat_stride_base;
+	SUMF64STRIDEPROC pfn_f64_stride = sumdouble_stride_base;
+	SUMF16PROC pfn_f16 = sumhalf_base;
+	SUMF16PROC pfn_bf16 = sumbf16_base;
+	SUMU8PROC pfn_u8 = sumuint8_base;
+	SUMI8PROC pfn_i8 = sumint8_base;
+	SUMI16PROC pfn_i16 = sumint16_base;
+	SUMI64PROC pfn_i64 = sumint64_base;
+	SUMU64PROC pfn_u64 = sumuint64_base;
+	SUMI32WHEREPROC pfn_i32_where = sumint_where_base;
+	SUMF32WHEREPROC pfn_f32_where = sumfloat_where_base;
+	SUMF64WHEREPROC pfn_f64_where = sumdouble_where_base;
+	SUMF32NANPROC pfn_f32_nan = sumfloat_nan_base;
+	SUMF64NANPROC pfn_f64_nan = sumdouble_nan_base;
+	SUMI32PROC pfn_i32_nta = NULL;	// NULL表示没有预取版, 使用普通内核.
+	SUMF32PROC pfn_f32_nta = NULL;
+	SUMF64PROC pfn_f64_nta = NULL;
+	STREAMREADPROC pfn_stream_read = stream_read_base;
+	STREAMCOPYPROC pfn_stream_copy = stream_copy_base;
+	STREAMTRIADPROC pfn_stream_triad = stream_triad_base;
+
+	simdsum_isa_hw = simdsum_detect();
+	isa = simdsum_env_limit(simdsum_isa_hw);
+	simdsum_init_prefetch();
+
+#ifdef INTRIN_MMX
+	if (isa >= SIMDSUM_ISA_MMX)	pfn_i32 = sumint_mmx_4loop;
+#endif	// #ifdef INTRIN_MMX
+#ifdef INTRIN_SSE
+	if (isa >= SIMDSUM_ISA_SSE)
+	{
+		pfn_f32 = sumfloat_sse_4loop;
+		pfn_f32_kahan = sumfloat_kahan_sse;
+		pfn_f32_seg = sumfloat_seg_sse;
+		pfn_f32_dot = dotfloat_sse_8loop;
+		pfn_f32_stride = sumfloat_stride_sse;
+		pfn_f32_where = sumfloat_where_sse;
+	}
+#endif	// #ifdef INTRIN_SSE
+#ifdef INTRIN_SSE2
+	if (isa >= SIMDSUM_ISA_SSE2)
+	{
+		pfn_i32 = sumint_sse_4loop;
+		pfn_f64 = sumdouble_sse_4loop;
+		pfn_f64_kahan = sumdouble_kahan_sse;
+		pfn_i32_seg = sumint_seg_sse;
+		pfn_f64_seg = sumdouble_seg_sse;
+		pfn_i32_stats = sumint_stats_sse;
+		pfn_f32_stats = sumfloat_stats_sse;
+		pfn_f64_stats = sumdouble_stats_sse;
+		pfn_f64_dot = dotdouble_sse_8loop;
+		pfn_i32_scan = scanint_sse;
+		pfn_i64_scan = scanint64_sse;
+		pfn_f32_scan = scanfloat_sse;
+		pfn_f64_scan = scandouble_sse;
+		pfn_i32_stride = sumint_stride_sse;
+		pfn_f64_stride = sumdouble_stride_sse;
+		pfn_bf16 = sumbf16_sse_4loop;
+		pfn_u8 = sumuint8_sse_4loop;
+		pfn_i8 = sumint8_sse_4loop;
+		pfn_i16 = sumint16_sse_4loop;
+		pfn_i64 = sumint64_sse_4loop;
+		pfn_u64 = sumuint64_sse_4loop;
+		pfn_i32_where = sumint_where_sse;
+		pfn_f64_where = sumdouble_where_sse;
+		pfn_f32_nan = sumfloat_nan_sse_4loop;
+		pfn_f64_nan = sumdouble_nan_sse_4loop;
+		pfn_stream_read = stream_read_sse;
+		pfn_stream_copy = stream_copy_sse;
+		pfn_stream_triad = stream_triad_sse;
+	}
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_SSE41
+	if (isa >= SIMDSUM_ISA_SSE41)	pfn_i32_wide = sumint_wide_sse41;
+#endif	// #ifdef SIMDSUM_HAVE_SSE41
+#ifdef SIMDSUM_HAVE_AVX
+	if (isa >= SIMDSUM_ISA_AVX)
+	{
+		pfn_f32 = sumfloat_avx_4loop;
+		pfn_f64 = sumdouble_avx_4loop;
+		pfn_f32_kahan = sumfloat_kahan_avx;
+		pfn_f64_kahan = sumdouble_kahan_avx;
+		pfn_f32_seg = sumfloat_seg_avx;
+		pfn_f64_seg = sumdouble_seg_avx;
+		pfn_i32_stats = sumint_stats_avx;
+		pfn_f32_stats = sumfloat_stats_avx;
+		pfn_f64_stats = sumdouble_stats_avx;
+		pfn_f32_dot = dotfloat_avx_8loop;
+		pfn_f64_dot = dotdouble_avx_8loop;
+		pfn_f32_stride = sumfloat_stride_avx;
+		pfn_f64_stride = sumdouble_stride_avx;
+		pfn_f32_where = sumfloat_where_avx;
+		pfn_f64_where = sumdouble_where_avx;
+		pfn_f32_nan = sumfloat_nan_avx_4loop;
+		pfn_f64_nan = sumdouble_nan_avx_4loop;
+		pfn_stream_read = stream_read_avx;
+		pfn_stream_copy = stream_copy_avx;
+		pfn_stream_triad = stream_triad_avx;
+		pfn_f32_nta = sumfloat_avx_nta;
+		pfn_f64_nta = sumdouble_avx_nta;
+	}
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+#ifdef SIMDSUM_HAVE_F16C
+	if (isa >= SIMDSUM_ISA_F16C)	pfn_f16 = sumhalf_f16c_4loop;
+#endif	// #ifdef SIMDSUM_HAVE_F16C
+#ifdef SIMDSUM_HAVE_FMA
+	if (isa >= SIMDSUM_ISA_FMA)
+	{
+		pfn_i32_stats = sumint_stats_fma;
+		pfn_f32_stats = sumfloat_stats_fma;
+		pfn_f64_stats = sumdouble_stats_fma;
+		pfn_f32_dot = dotfloat_fma_8loop;
+		pfn_f64_dot = dotdouble_fma_8loop;
+	}
+#endif	// #ifdef SIMDSUM_HAVE_FMA
+#ifdef SIMDSUM_HAVE_AVX2
+	if (isa >= SIMDSUM_ISA_AVX2)
+	{
+		pfn_i32 = sumint_avx2_4loop;
+		pfn_i32_wide = sumint_wide_avx2;
+		pfn_i32_nta = sumint_avx2_nta;
+		pfn_i32_seg = sumint_seg_avx2;
+		pfn_i32_scan = scanint_avx2;
+		pfn_i64_scan = scanint64_avx2;
+		pfn_f32_scan = scanfloat_avx2;
+		pfn_f64_scan = scandouble_avx2;
+		pfn_i32_stride = sumint_stride_avx2;
+		pfn_f32_stride = sumfloat_stride_avx2;
+		pfn_f64_stride = sumdouble_stride_avx2;
+		pfn_bf16 = sumbf16_avx2_4loop;
+		pfn_u8 = sumuint8_avx2_4loop;
+		pfn_i8 = sumint8_avx2_4loop;
+		pfn_i16 = sumint16_avx2_4loop;
+		pfn_i64 = sumint64_avx2_4loop;
+		pfn_u64 = sumuint64_avx2_4loop;
+		pfn_i32_where = sumint_where_avx2;
+	}
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+#ifdef SIMDSUM_HAVE_AVX512
+	if (isa >= SIMDSUM_ISA_AVX512)
+	{
+		pfn_i32 = sumint_avx512_4loop;
+		pfn_f32 = sumfloat_avx512_4loop;
+		pfn_f64 = sumdouble_avx512_4loop;
+		pfn_i32_seg = sumint_seg_avx512;
+		pfn_f32_seg = sumfloat_seg_avx512;
+		pfn_f64_seg = sumdouble_seg_avx512;
+		pfn_i32_stats = sumint_stats_avx512;
+		pfn_f32_stats = sumfloat_stats_avx512;
+		pfn_f64_stats = sumdouble_stats_avx512;
+		pfn_stream_read = stream_read_avx512;
+		pfn_stream_copy = stream_copy_avx512;
+		pfn_stream_triad = stream_triad_avx512;
+		pfn_i32_nta = sumint_avx512_nta;
+		pfn_f32_nta = sumfloat_avx512_nta;
+		pfn_f64_nta = sumdouble_avx512_nta;
+		pfn_f16 = sumhalf_avx512_4loop;
+		pfn_bf16 = sumbf16_avx512_4loop;
+		pfn_i64 = sumint64_avx512_4loop;
+		pfn_u64 = sumuint64_avx512_4loop;
+	}
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+
+	if (NULL==pfn_i32_nta)	pfn_i32_nta = pfn_i32;
+	if (NULL==pfn_f32_nta)	pfn_f32_nta = pfn_f32;
+	if (NULL==pfn_f64_nta)	pfn_f64_nta = pfn_f64;
+
+	simdsum_pfn_i32 = pfn_i32;
+	simdsum_pfn_f32 = pfn_f32;
+	simdsum_pfn_f64 = pfn_f64;
+	simdsum_pfn_f32_kahan = pfn_f32_kahan;
+	simdsum_pfn_f64_kahan = pfn_f64_kahan;
+	simdsum_pfn_i32_wide = pfn_i32_wide;
+	simdsum_pfn_i32_seg = pfn_i32_seg;
+	simdsum_pfn_f32_seg = pfn_f32_seg;
+	simdsum_pfn_f64_seg = pfn_f64_seg;
+	simdsum_pfn_i32_stats = pfn_i32_stats;
+	simdsum_pfn_f32_stats = pfn_f32_stats;
+	simdsum_pfn_f64_stats = pfn_f64_stats;
+	simdsum_pfn_f32_dot = pfn_f32_dot;
+	simdsum_pfn_f64_dot = pfn_f64_dot;
+	simdsum_pfn_i32_scan = pfn_i32_scan;
+	simdsum_pfn_i64_scan = pfn_i64_scan;
+	simdsum_pfn_f32_scan = pfn_f32_scan;
+	simdsum_pfn_f64_scan = pfn_f64_scan;
+	simdsum_pfn_i32_stride = pfn_i32_stride;
+	simdsum_pfn_f32_stride = pfn_f32_stride;
+	simdsum_pfn_f64_stride = pfn_f64_stride;
+	simdsum_pfn_f16 = pfn_f16;
+	simdsum_pfn_bf16 = pfn_bf16;
+	simdsum_pfn_u8 = pfn_u8;
+	simdsum_pfn_i8 = pfn_i8;
+	simdsum_pfn_i16 = pfn_i16;
+	simdsum_pfn_i64 = pfn_i64;
+	simdsum_pfn_u64 = pfn_u64;
+	simdsum_pfn_i32_where = pfn_i32_where;
+	simdsum_pfn_f32_where = pfn_f32_where;
+	simdsum_pfn_f64_where = pfn_f64_where;
+	simdsum_pfn_f32_nan = pfn_f32_nan;
+	simdsum_pfn_f64_nan = pfn_f64_nan;
+	simdsum_pfn_i32_nta = pfn_i32_nta;
+	simdsum_pfn_f32_nta = pfn_f32_nta;
+	simdsum_pfn_f64_nta = pfn_f64_nta;
+	simdsum_pfn_stream_read = pfn_stream_read;
+	simdsum_pfn_stream_copy = pfn_stream_copy;
+	simdsum_pfn_stream_triad = pfn_stream_triad;
+	simdsum_isa_cur = isa;
+}
+
+#if defined(__GNUC__)
+// 加载时初始化. MSVC下则在首次调用时由桩函数初始化.
+__attribute__((constructor)) static void simdsum_ctor(void)
+{
+	simdsum_init();
+}
+#endif	// #if defined(__GNUC__)
+
+static int32_t simdsum_init_i32(const int32_t* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_i32(pbuf, cntbuf);
+}
+
+static float simdsum_init_f32(const float* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_f32(pbuf, cntbuf);
+}
+
+static double simdsum_init_f64(const double* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_f64(pbuf, cntbuf);
+}
+
+static float simdsum_init_f32_kahan(const float* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_f32_kahan(pbuf, cntbuf);
+}
+
+static double simdsum_init_f64_kahan(const double* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_f64_kahan(pbuf, cntbuf);
+}
+
+static int64_t simdsum_init_i32_wide(const int32_t* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_i32_wide(pbuf, cntbuf);
+}
+
+static void simdsum_init_i32_seg(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums)
+{
+	simdsum_init();
+	simdsum_pfn_i32_seg(pbuf, poffs, cntseg, psums);
+}
+
+static void simdsum_init_f32_seg(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums)
+{
+	simdsum_init();
+	simdsum_pfn_f32_seg(pbuf, poffs, cntseg, psums);
+}
+
+static void simdsum_init_f64_seg(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums)
+{
+	simdsum_init();
+	simdsum_pfn_f64_seg(pbuf, poffs, cntseg, psums);
+}
+
+static void simdsum_init_i32_stats(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	simdsum_init();
+	simdsum_pfn_i32_stats(pbuf, cntbuf, pst);
+}
+
+static void simdsum_init_f32_stats(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	simdsum_init();
+	simdsum_pfn_f32_stats(pbuf, cntbuf, pst);
+}
+
+static void simdsum_init_f64_stats(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	simdsum_init();
+	simdsum_pfn_f64_stats(pbuf, cntbuf, pst);
+}
+
+static float simdsum_init_f32_dot(const float* pa, const float* pb, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_f32_dot(pa, pb, cntbuf);
+}
+
+static double simdsum_init_f64_dot(const double* pa, const double* pb, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_f64_dot(pa, pb, cntbuf);
+}
+
+static int32_t simdsum_init_i32_scan(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl)
+{
+	simdsum_init();
+	return simdsum_pfn_i32_scan(pdst, psrc, cntbuf, init, excl);
+}
+
+static int64_t simdsum_init_i64_scan(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl)
+{
+	simdsum_init();
+	return simdsum_pfn_i64_scan(pdst, psrc, cntbuf, init, excl);
+}
+
+static float simdsum_init_f32_scan(float* pdst, const float* psrc, size_t cntbuf, float init, int excl)
+{
+	simdsum_init();
+	return simdsum_pfn_f32_scan(pdst, psrc, cntbuf, init, excl);
+}
+
+static double simdsum_init_f64_scan(double* pdst, const double* psrc, size_t cntbuf, double init, int excl)
+{
+	simdsum_init();
+	return simdsum_pfn_f64_scan(pdst, psrc, cntbuf, init, excl);
+}
+
+static int32_t simdsum_init_i32_stride(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	simdsum_init();
+	return simdsum_pfn_i32_stride(pbase, cntrec, cbstride, cboffset);
+}
+
+static float simdsum_init_f32_stride(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	simdsum_init();
+	return simdsum_pfn_f32_stride(pbase, cntrec, cbstride, cboffset);
+}
+
+static double simdsum_init_f64_stride(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	simdsum_init();
+	return simdsum_pfn_f64_stride(pbase, cntrec, cbstride, cboffset);
+}
+
+static float simdsum_init_f16(const uint16_t* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_f16(pbuf, cntbuf);
+}
+
+static float simdsum_init_bf16(const uint16_t* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_bf16(pbuf, cntbuf);
+}
+
+static uint64_t simdsum_init_u8(const uint8_t* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_u8(pbuf, cntbuf);
+}
+
+static int64_t simdsum_init_i8(const int8_t* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_i8(pbuf, cntbuf);
+}
+
+static int64_t simdsum_init_i16(const int16_t* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_i16(pbuf, cntbuf);
+}
+
+static int64_t simdsum_init_i64(const int64_t* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_i64(pbuf, cntbuf);
+}
+
+static uint64_t simdsum_init_u64(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry)
+{
+	simdsum_init();
+	return simdsum_pfn_u64(pbuf, cntbuf, pcarry);
+}
+
+static int32_t simdsum_init_i32_where(const int32_t* pval, const int32_t* pkey, size_t cntbuf, int32_t lo, int32_t hi, int flags)
+{
+	simdsum_init();
+	return simdsum_pfn_i32_where(pval, pkey, cntbuf, lo, hi, flags);
+}
+
+static float simdsum_init_f32_where(const float* pval, const float* pkey, size_t cntbuf, float lo, float hi, int flags)
+{
+	simdsum_init();
+	return simdsum_pfn_f32_where(pval, pkey, cntbuf, lo, hi, flags);
+}
+
+static double simdsum_init_f64_where(const double* pval, const double* pkey, size_t cntbuf, double lo, double hi, int flags)
+{
+	simdsum_init();
+	return simdsum_pfn_f64_where(pval, pkey, cntbuf, lo, hi, flags);
+}
+
+static float simdsum_init_f32_nan(const float* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	simdsum_init();
+	return simdsum_pfn_f32_nan(pbuf, cntbuf, pcnt);
+}
+
+static double simdsum_init_f64_nan(const double* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	simdsum_init();
+	return simdsum_pfn_f64_nan(pbuf, cntbuf, pcnt);
+}
+
+static int32_t simdsum_init_i32_nta(const int32_t* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_i32_nta(pbuf, cntbuf);
+}
+
+static float simdsum_init_f32_nta(const float* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_f32_nta(pbuf, cntbuf);
+}
+
+static double simdsum_init_f64_nta(const double* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_f64_nta(pbuf, cntbuf);
+}
+
+static uint64_t simdsum_init_stream_read(const double* pbuf, size_t cntbuf)
+{
+	simdsum_init();
+	return simdsum_pfn_stream_read(pbuf, cntbuf);
+}
+
+static void simdsum_init_stream_copy(double* pdst, const double* psrc, size_t cntbuf)
+{
+	simdsum_init();
+	simdsum_pfn_stream_copy(pdst, psrc, cntbuf);
+}
+
+static void simdsum_init_stream_triad(double* pa, const double* pb, const double* pc, double s, size_t cntbuf)
+{
+	simdsum_init();
+	simdsum_pfn_stream_triad(pa, pb, pc, s, cntbuf);
+}
+
+int	simdsum_isa(int* phwisa)
+{
+	if (simdsum_isa_cur < 0)	simdsum_init();
+	if (NULL!=phwisa)	*phwisa = simdsum_isa_hw;
+	return simdsum_isa_cur;
+}
+
+int32_t simd_sum_i32(const int32_t* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_i32(pbuf, cntbuf);
+}
+
+float simd_sum_f32(const float* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_f32(pbuf, cntbuf);
+}
+
+double simd_sum_f64(const double* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_f64(pbuf, cntbuf);
+}
+
+float simd_sum_f32_kahan(const float* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_f32_kahan(pbuf, cntbuf);
+}
+
+double simd_sum_f64_kahan(const double* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_f64_kahan(pbuf, cntbuf);
+}
+
+int64_t simd_sum_i32_wide(const int32_t* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_i32_wide(pbuf, cntbuf);
+}
+
+void simd_sum_seg_i32(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums)
+{
+	simdsum_pfn_i32_seg(pbuf, poffs, cntseg, psums);
+}
+
+void simd_sum_seg_f32(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums)
+{
+	simdsum_pfn_f32_seg(pbuf, poffs, cntseg, psums);
+}
+
+void simd_sum_seg_f64(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums)
+{
+	simdsum_pfn_f64_seg(pbuf, poffs, cntseg, psums);
+}
+
+void simd_sum_stats_i32(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	simdsum_pfn_i32_stats(pbuf, cntbuf, pst);
+}
+
+void simd_sum_stats_f32(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	simdsum_pfn_f32_stats(pbuf, cntbuf, pst);
+}
+
+void simd_sum_stats_f64(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	simdsum_pfn_f64_stats(pbuf, cntbuf, pst);
+}
+
+float simd_dot_f32(const float* pa, const float* pb, size_t cntbuf)
+{
+	return simdsum_pfn_f32_dot(pa, pb, cntbuf);
+}
+
+double simd_dot_f64(const double* pa, const double* pb, size_t cntbuf)
+{
+	return simdsum_pfn_f64_dot(pa, pb, cntbuf);
+}
+
+int32_t simd_scan_i32(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl)
+{
+	return simdsum_pfn_i32_scan(pdst, psrc, cntbuf, init, excl);
+}
+
+int64_t simd_scan_i64(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl)
+{
+	return simdsum_pfn_i64_scan(pdst, psrc, cntbuf, init, excl);
+}
+
+float simd_scan_f32(float* pdst, const float* psrc, size_t cntbuf, float init, int excl)
+{
+	return simdsum_pfn_f32_scan(pdst, psrc, cntbuf, init, excl);
+}
+
+double simd_scan_f64(double* pdst, const double* psrc, size_t cntbuf, double init, int excl)
+{
+	return simdsum_pfn_f64_scan(pdst, psrc, cntbuf, init, excl);
+}
+
+int32_t simd_sum_stride_i32(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	return simdsum_pfn_i32_stride(pbase, cntrec, cbstride, cboffset);
+}
+
+float simd_sum_stride_f32(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	return simdsum_pfn_f32_stride(pbase, cntrec, cbstride, cboffset);
+}
+
+double simd_sum_stride_f64(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	return simdsum_pfn_f64_stride(pbase, cntrec, cbstride, cboffset);
+}
+
+float simd_sum_f16(const uint16_t* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_f16(pbuf, cntbuf);
+}
+
+float simd_sum_bf16(const uint16_t* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_bf16(pbuf, cntbuf);
+}
+
+uint64_t simd_sum_u8(const uint8_t* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_u8(pbuf, cntbuf);
+}
+
+int64_t simd_sum_i8(const int8_t* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_i8(pbuf, cntbuf);
+}
+
+int64_t simd_sum_i16(const int16_t* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_i16(pbuf, cntbuf);
+}
+
+int64_t simd_sum_i64(const int64_t* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_i64(pbuf, cntbuf);
+}
+
+uint64_t simd_sum_u64(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry)
+{
+	return simdsum_pfn_u64(pbuf, cntbuf, pcarry);
+}
+
+int32_t simd_sum_where_i32(const int32_t* pval, const int32_t* pkey, size_t cntbuf, int32_t lo, int32_t hi, int flags)
+{
+	return simdsum_pfn_i32_where(pval, pkey, cntbuf, lo, hi, flags);
+}
+
+float simd_sum_where_f32(const float* pval, const float* pkey, size_t cntbuf, float lo, float hi, int flags)
+{
+	return simdsum_pfn_f32_where(pval, pkey, cntbuf, lo, hi, flags);
+}
+
+double simd_sum_where_f64(const double* pval, const double* pkey, size_t cntbuf, double lo, double hi, int flags)
+{
+	return simdsum_pfn_f64_where(pval, pkey, cntbuf, lo, hi, flags);
+}
+
+float simd_sum_f32_nan(const float* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	return simdsum_pfn_f32_nan(pbuf, cntbuf, pcnt);
+}
+
+double simd_sum_f64_nan(const double* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	return simdsum_pfn_f64_nan(pbuf, cntbuf, pcnt);
+}
+
+int32_t simd_sum_i32_nta(const int32_t* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_i32_nta(pbuf, cntbuf);
+}
+
+float simd_sum_f32_nta(const float* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_f32_nta(pbuf, cntbuf);
+}
+
+double simd_sum_f64_nta(const double* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_f64_nta(pbuf, cntbuf);
+}
+
+void simdsum_prefetch_setdist(size_t cbdist)
+{
+	simdsum_cbdist = cbdist;
+}
+
+size_t simdsum_prefetch_dist(void)
+{
+	return simdsum_cbdist;
+}
+
+size_t simdsum_cacheline(void)
+{
+	return simdsum_cbline;
+}
+
+uint64_t simd_stream_read(const double* pbuf, size_t cntbuf)
+{
+	return simdsum_pfn_stream_read(pbuf, cntbuf);
+}
+
+void simd_stream_copy(double* pdst, const double* psrc, size_t cntbuf)
+{
+	simdsum_pfn_stream_copy(pdst, psrc, cntbuf);
+}
+
+void simd_stream_triad(double* pa, const double* pb, const double* pc, double s, size_t cntbuf)
+{
+	simdsum_pfn_stream_triad(pa, pb, pc, s, cntbuf);
+}
+
+
+//////////////////////////////////////////////////
+// kernels: 内核表
+//////////////////////////////////////////////////
+
+static const SUMI32KERNEL simdsum_kernels_i32_list[] = {
+	{"sumint_base", SIMDSUM_ISA_BASE, sumint_base},	// 32位整数数组求和_基本版.
+#ifdef INTRIN_MMX
+	{"sumint_mmx", SIMDSUM_ISA_MMX, sumint_mmx},	// 32位整数数组求和_MMX版.
+	{"sumint_mmx_4", SIMDSUM_ISA_MMX, sumint_mmx_4loop},	// 32位整数数组求和_MMX四路循环展开版.
+#endif	// #ifdef INTRIN_MMX
+#ifdef INTRIN_SSE2
+	{"sumint_sse", SIMDSUM_ISA_SSE2, sumint_sse},	// 32位整数数组求和_SSE版.
+	{"sumint_sse_4", SIMDSUM_ISA_SSE2, sumint_sse_4loop},	// 32位整数数组求和_SSE四路循环展开版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumint_avx2", SIMDSUM_ISA_AVX2, sumint_avx2},	// 32位整数数组求和_AVX2版.
+	{"sumint_avx2_4", SIMDSUM_ISA_AVX2, sumint_avx2_4loop},	// 32位整数数组求和_AVX2四路循环展开版.
+	{"sumint_avx2_pf", SIMDSUM_ISA_AVX2, sumint_avx2_pf},	// 32位整数数组求和_AVX2预取版.
+	{"sumint_avx2_nta", SIMDSUM_ISA_AVX2, sumint_avx2_nta},	// 32位整数数组求和_AVX2非临时预取版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumint_avx512", SIMDSUM_ISA_AVX512, sumint_avx512},	// 32位整数数组求和_AVX-512版.
+	{"sumint_avx512_4", SIMDSUM_ISA_AVX512, sumint_avx512_4loop},	// 32位整数数组求和_AVX-512四路循环展开版.
+	{"sumint_avx512_pf", SIMDSUM_ISA_AVX512, sumint_avx512_pf},	// 32位整数数组求和_AVX-512预取版.
+	{"sumint_avx512_nta", SIMDSUM_ISA_AVX512, sumint_avx512_nta},	// 32位整数数组求和_AVX-512非临时预取版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{NULL, 0, NULL}
+};
+
+static const SUMF32KERNEL simdsum_kernels_f32_list[] = {
+	{"sumfloat_base", SIMDSUM_ISA_BASE, sumfloat_base},	// 单精度浮点数组求和_基本版.
+#ifdef INTRIN_SSE
+	{"sumfloat_sse", SIMDSUM_ISA_SSE, sumfloat_sse},	// 单精度浮点数组求和_SSE版.
+	{"sumfloat_sse_4", SIMDSUM_ISA_SSE, sumfloat_sse_4loop},	// 单精度浮点数组求和_SSE四路循环展开版.
+#endif	// #ifdef INTRIN_SSE
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumfloat_avx", SIMDSUM_ISA_AVX, sumfloat_avx},	// 单精度浮点数组求和_AVX版.
+	{"sumfloat_avx_4", SIMDSUM_ISA_AVX, sumfloat_avx_4loop},	// 单精度浮点数组求和_AVX四路循环展开版.
+	{"sumfloat_avx_pf", SIMDSUM_ISA_AVX, sumfloat_avx_pf},	// 单精度浮点数组求和_AVX预取版.
+	{"sumfloat_avx_nta", SIMDSUM_ISA_AVX, sumfloat_avx_nta},	// 单精度浮点数组求和_AVX非临时预取版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumfloat_avx512", SIMDSUM_ISA_AVX512, sumfloat_avx512},	// 单精度浮点数组求和_AVX-512版.
+	{"sumfloat_avx512_4", SIMDSUM_ISA_AVX512, sumfloat_avx512_4loop},	// 单精度浮点数组求和_AVX-512四路循环展开版.
+	{"sumfloat_avx512_pf", SIMDSUM_ISA_AVX512, sumfloat_avx512_pf},	// 单精度浮点数组求和_AVX-512预取版.
+	{"sumfloat_avx512_nta", SIMDSUM_ISA_AVX512, sumfloat_avx512_nta},	// 单精度浮点数组求和_AVX-512非临时预取版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{"sumfloat_kahan_base", SIMDSUM_ISA_BASE, sumfloat_kahan_base},	// 单精度浮点数组求和_补偿求和基本版.
+#ifdef INTRIN_SSE
+	{"sumfloat_kahan_sse", SIMDSUM_ISA_SSE, sumfloat_kahan_sse},	// 单精度浮点数组求和_SSE补偿求和版.
+#endif	// #ifdef INTRIN_SSE
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumfloat_kahan_avx", SIMDSUM_ISA_AVX, sumfloat_kahan_avx},	// 单精度浮点数组求和_AVX补偿求和版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+	{NULL, 0, NULL}
+};
+
+static const SUMF64KERNEL simdsum_kernels_f64_list[] = {
+	{"sumdouble_base", SIMDSUM_ISA_BASE, sumdouble_base},	// 双精度浮点数组求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumdouble_sse", SIMDSUM_ISA_SSE2, sumdouble_sse},	// 双精度浮点数组求和_SSE版.
+	{"sumdouble_sse_4", SIMDSUM_ISA_SSE2, sumdouble_sse_4loop},	// 双精度浮点数组求和_SSE四路循环展开版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumdouble_avx", SIMDSUM_ISA_AVX, sumdouble_avx},	// 双精度浮点数组求和_AVX版.
+	{"sumdouble_avx_4", SIMDSUM_ISA_AVX, sumdouble_avx_4loop},	// 双精度浮点数组求和_AVX四路循环展开版.
+	{"sumdouble_avx_pf", SIMDSUM_ISA_AVX, sumdouble_avx_pf},	// 双精度浮点数组求和_AVX预取版.
+	{"sumdouble_avx_nta", SIMDSUM_ISA_AVX, sumdouble_avx_nta},	// 双精度浮点数组求和_AVX非临时预取版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumdouble_avx512", SIMDSUM_ISA_AVX512, sumdouble_avx512},	// 双精度浮点数组求和_AVX-512版.
+	{"sumdouble_avx512_4", SIMDSUM_ISA_AVX512, sumdouble_avx512_4loop},	// 双精度浮点数组求和_AVX-512四路循环展开版.
+	{"sumdouble_avx512_pf", SIMDSUM_ISA_AVX512, sumdouble_avx512_pf},	// 双精度浮点数组求和_AVX-512预取版.
+	{"sumdouble_avx512_nta", SIMDSUM_ISA_AVX512, sumdouble_avx512_nta},	// 双精度浮点数组求和_AVX-512非临时预取版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{"sumdouble_kahan_base", SIMDSUM_ISA_BASE, sumdouble_kahan_base},	// 双精度浮点数组求和_补偿求和基本版.
+#ifdef INTRIN_SSE2
+	{"sumdouble_kahan_sse", SIMDSUM_ISA_SSE2, sumdouble_kahan_sse},	// 双精度浮点数组求和_SSE补偿求和版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumdouble_kahan_avx", SIMDSUM_ISA_AVX, sumdouble_kahan_avx},	// 双精度浮点数组求和_AVX补偿求和版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+	{NULL, 0, NULL}
+};
+
+static const SUMI32WIDEKERNEL simdsum_kernels_i32_wide_list[] = {
+	{"sumint_wide_base", SIMDSUM_ISA_BASE, sumint_wide_base},	// 32位整数数组求和_64位结果_基本版.
+#ifdef SIMDSUM_HAVE_SSE41
+	{"sumint_wide_sse41", SIMDSUM_ISA_SSE41, sumint_wide_sse41},	// 32位整数数组求和_64位结果_SSE4.1版.
+#endif	// #ifdef SIMDSUM_HAVE_SSE41
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumint_wide_avx2", SIMDSUM_ISA_AVX2, sumint_wide_avx2},	// 32位整数数组求和_64位结果_AVX2分段版.
+	{"sumint_wide_avx2_movsx", SIMDSUM_ISA_AVX2, sumint_wide_avx2_movsx},	// 32位整数数组求和_64位结果_AVX2符号扩展版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+	{NULL, 0, NULL}
+};
+
+static const SUMI32SEGKERNEL simdsum_kernels_i32_seg_list[] = {
+	{"sumint_seg_base", SIMDSUM_ISA_BASE, sumint_seg_base},	// 32位整数数组分段求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumint_seg_sse", SIMDSUM_ISA_SSE2, sumint_seg_sse},	// 32位整数数组分段求和_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumint_seg_avx2", SIMDSUM_ISA_AVX2, sumint_seg_avx2},	// 32位整数数组分段求和_AVX2版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumint_seg_avx512", SIMDSUM_ISA_AVX512, sumint_seg_avx512},	// 32位整数数组分段求和_AVX-512版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{NULL, 0, NULL}
+};
+
+static const SUMF32SEGKERNEL simdsum_kernels_f32_seg_list[] = {
+	{"sumfloat_seg_base", SIMDSUM_ISA_BASE, sumfloat_seg_base},	// 单精度浮点数组分段求和_基本版.
+#ifdef INTRIN_SSE
+	{"sumfloat_seg_sse", SIMDSUM_ISA_SSE, sumfloat_seg_sse},	// 单精度浮点数组分段求和_SSE版.
+#endif	// #ifdef INTRIN_SSE
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumfloat_seg_avx", SIMDSUM_ISA_AVX, sumfloat_seg_avx},	// 单精度浮点数组分段求和_AVX版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumfloat_seg_avx512", SIMDSUM_ISA_AVX512, sumfloat_seg_avx512},	// 单精度浮点数组分段求和_AVX-512版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{NULL, 0, NULL}
+};
+
+static const SUMF64SEGKERNEL simdsum_kernels_f64_seg_list[] = {
+	{"sumdouble_seg_base", SIMDSUM_ISA_BASE, sumdouble_seg_base},	// 双精度浮点数组分段求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumdouble_seg_sse", SIMDSUM_ISA_SSE2, sumdouble_seg_sse},	// 双精度浮点数组分段求和_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumdouble_seg_avx", SIMDSUM_ISA_AVX, sumdouble_seg_avx},	// 双精度浮点数组分段求和_AVX版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumdouble_seg_avx512", SIMDSUM_ISA_AVX512, sumdouble_seg_avx512},	// 双精度浮点数组分段求和_AVX-512版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{NULL, 0, NULL}
+};
+
+static const SUMI32STATSKERNEL simdsum_kernels_i32_stats_list[] = {
+	{"sumint_stats_base", SIMDSUM_ISA_BASE, sumint_stats_base},	// 32位整数数组统计_基本版.
+#ifdef INTRIN_SSE2
+	{"sumint_stats_sse", SIMDSUM_ISA_SSE2, sumint_stats_sse},	// 32位整数数组统计_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumint_stats_avx", SIMDSUM_ISA_AVX, sumint_stats_avx},	// 32位整数数组统计_AVX版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+#ifdef SIMDSUM_HAVE_FMA
+	{"sumint_stats_fma", SIMDSUM_ISA_FMA, sumint_stats_fma},	// 32位整数数组统计_AVX+FMA版.
+#endif	// #ifdef SIMDSUM_HAVE_FMA
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumint_stats_avx512", SIMDSUM_ISA_AVX512, sumint_stats_avx512},	// 32位整数数组统计_AVX-512版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{NULL, 0, NULL}
+};
+
+static const SUMF32STATSKERNEL simdsum_kernels_f32_stats_list[] = {
+	{"sumfloat_stats_base", SIMDSUM_ISA_BASE, sumfloat_stats_base},	// 单精度浮点数组统计_基本版.
+#ifdef INTRIN_SSE2
+	{"sumfloat_stats_sse", SIMDSUM_ISA_SSE2, sumfloat_stats_sse},	// 单精度浮点数组统计_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumfloat_stats_avx", SIMDSUM_ISA_AVX, sumfloat_stats_avx},	// 单精度浮点数组统计_AVX版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+#ifdef SIMDSUM_HAVE_FMA
+	{"sumfloat_stats_fma", SIMDSUM_ISA_FMA, sumfloat_stats_fma},	// 单精度浮点数组统计_AVX+FMA版.
+#endif	// #ifdef SIMDSUM_HAVE_FMA
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumfloat_stats_avx512", SIMDSUM_ISA_AVX512, sumfloat_stats_avx512},	// 单精度浮点数组统计_AVX-512版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{NULL, 0, NULL}
+};
+
+static const SUMF64STATSKERNEL simdsum_kernels_f64_stats_list[] = {
+	{"sumdouble_stats_base", SIMDSUM_ISA_BASE, sumdouble_stats_base},	// 双精度浮点数组统计_基本版.
+#ifdef INTRIN_SSE2
+	{"sumdouble_stats_sse", SIMDSUM_ISA_SSE2, sumdouble_stats_sse},	// 双精度浮点数组统计_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumdouble_stats_avx", SIMDSUM_ISA_AVX, sumdouble_stats_avx},	// 双精度浮点数组统计_AVX版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+#ifdef SIMDSUM_HAVE_FMA
+	{"sumdouble_stats_fma", SIMDSUM_ISA_FMA, sumdouble_stats_fma},	// 双精度浮点数组统计_AVX+FMA版.
+#endif	// #ifdef SIMDSUM_HAVE_FMA
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumdouble_stats_avx512", SIMDSUM_ISA_AVX512, sumdouble_stats_avx512},	// 双精度浮点数组统计_AVX-512版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{NULL, 0, NULL}
+};
+
+static const DOTF32KERNEL simdsum_kernels_f32_dot_list[] = {
+	{"dotfloat_base", SIMDSUM_ISA_BASE, dotfloat_base},	// 单精度浮点点积_基本版.
+#ifdef INTRIN_SSE
+	{"dotfloat_sse_4loop", SIMDSUM_ISA_SSE, dotfloat_sse_4loop},	// 单精度浮点点积_SSE四路循环展开版.
+	{"dotfloat_sse_8loop", SIMDSUM_ISA_SSE, dotfloat_sse_8loop},	// 单精度浮点点积_SSE八路循环展开版.
+#endif	// #ifdef INTRIN_SSE
+#ifdef SIMDSUM_HAVE_AVX
+	{"dotfloat_avx_4loop", SIMDSUM_ISA_AVX, dotfloat_avx_4loop},	// 单精度浮点点积_AVX四路循环展开版.
+	{"dotfloat_avx_8loop", SIMDSUM_ISA_AVX, dotfloat_avx_8loop},	// 单精度浮点点积_AVX八路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+#ifdef SIMDSUM_HAVE_FMA
+	{"dotfloat_fma_4loop", SIMDSUM_ISA_FMA, dotfloat_fma_4loop},	// 单精度浮点点积_AVX+FMA四路循环展开版.
+	{"dotfloat_fma_8loop", SIMDSUM_ISA_FMA, dotfloat_fma_8loop},	// 单精度浮点点积_AVX+FMA八路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_FMA
+	{NULL, 0, NULL}
+};
+
+static const DOTF64KERNEL simdsum_kernels_f64_dot_list[] = {
+	{"dotdouble_base", SIMDSUM_ISA_BASE, dotdouble_base},	// 双精度浮点点积_基本版.
+#ifdef INTRIN_SSE2
+	{"dotdouble_sse_4loop", SIMDSUM_ISA_SSE2, dotdouble_sse_4loop},	// 双精度浮点点积_SSE四路循环展开版.
+	{"dotdouble_sse_8loop", SIMDSUM_ISA_SSE2, dotdouble_sse_8loop},	// 双精度浮点点积_SSE八路循环展开版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX
+	{"dotdouble_avx_4loop", SIMDSUM_ISA_AVX, dotdouble_avx_4loop},	// 双精度浮点点积_AVX四路循环展开版.
+	{"dotdouble_avx_8loop", SIMDSUM_ISA_AVX, dotdouble_avx_8loop},	// 双精度浮点点积_AVX八路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+#ifdef SIMDSUM_HAVE_FMA
+	{"dotdouble_fma_4loop", SIMDSUM_ISA_FMA, dotdouble_fma_4loop},	// 双精度浮点点积_AVX+FMA四路循环展开版.
+	{"dotdouble_fma_8loop", SIMDSUM_ISA_FMA, dotdouble_fma_8loop},	// 双精度浮点点积_AVX+FMA八路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_FMA
+	{NULL, 0, NULL}
+};
+
+static const SCANI32KERNEL simdsum_kernels_i32_scan_list[] = {
+	{"scanint_base", SIMDSUM_ISA_BASE, scanint_base},	// 32位整数前缀和_基本版.
+#ifdef INTRIN_SSE2
+	{"scanint_sse", SIMDSUM_ISA_SSE2, scanint_sse},	// 32位整数前缀和_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"scanint_avx2", SIMDSUM_ISA_AVX2, scanint_avx2},	// 32位整数前缀和_AVX2版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+	{NULL, 0, NULL}
+};
+
+static const SCANI64KERNEL simdsum_kernels_i64_scan_list[] = {
+	{"scanint64_base", SIMDSUM_ISA_BASE, scanint64_base},	// 64位整数前缀和_基本版.
+#ifdef INTRIN_SSE2
+	{"scanint64_sse", SIMDSUM_ISA_SSE2, scanint64_sse},	// 64位整数前缀和_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"scanint64_avx2", SIMDSUM_ISA_AVX2, scanint64_avx2},	// 64位整数前缀和_AVX2版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+	{NULL, 0, NULL}
+};
+
+static const SCANF32KERNEL simdsum_kernels_f32_scan_list[] = {
+	{"scanfloat_base", SIMDSUM_ISA_BASE, scanfloat_base},	// 单精度浮点前缀和_基本版.
+#ifdef INTRIN_SSE2
+	{"scanfloat_sse", SIMDSUM_ISA_SSE2, scanfloat_sse},	// 单精度浮点前缀和_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"scanfloat_avx2", SIMDSUM_ISA_AVX2, scanfloat_avx2},	// 单精度浮点前缀和_AVX2版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+	{NULL, 0, NULL}
+};
+
+static const SCANF64KERNEL simdsum_kernels_f64_scan_list[] = {
+	{"scandouble_base", SIMDSUM_ISA_BASE, scandouble_base},	// 双精度浮点前缀和_基本版.
+#ifdef INTRIN_SSE2
+	{"scandouble_sse", SIMDSUM_ISA_SSE2, scandouble_sse},	// 双精度浮点前缀和_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"scandouble_avx2", SIMDSUM_ISA_AVX2, scandouble_avx2},	// 双精度浮点前缀和_AVX2版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+	{NULL, 0, NULL}
+};
+
+static const SUMI32STRIDEKERNEL simdsum_kernels_i32_stride_list[] = {
+	{"sumint_stride_base", SIMDSUM_ISA_BASE, sumint_stride_base},	// 32位整数字段求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumint_stride_sse", SIMDSUM_ISA_SSE2, sumint_stride_sse},	// 32位整数字段求和_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumint_stride_avx2", SIMDSUM_ISA_AVX2, sumint_stride_avx2},	// 32位整数字段求和_AVX2版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+	{NULL, 0, NULL}
+};
+
+static const SUMF32STRIDEKERNEL simdsum_kernels_f32_stride_list[] = {
+	{"sumfloat_stride_base", SIMDSUM_ISA_BASE, sumfloat_stride_base},	// 单精度浮点字段求和_基本版.
+#ifdef INTRIN_SSE
+	{"sumfloat_stride_sse", SIMDSUM_ISA_SSE, sumfloat_stride_sse},	// 单精度浮点字段求和_SSE版.
+#endif	// #ifdef INTRIN_SSE
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumfloat_stride_avx", SIMDSUM_ISA_AVX, sumfloat_stride_avx},	// 单精度浮点字段求和_AVX版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumfloat_stride_avx2", SIMDSUM_ISA_AVX2, sumfloat_stride_avx2},	// 单精度浮点字段求和_AVX2版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+	{NULL, 0, NULL}
+};
+
+static const SUMF64STRIDEKERNEL simdsum_kernels_f64_stride_list[] = {
+	{"sumdouble_stride_base", SIMDSUM_ISA_BASE, sumdouble_stride_base},	// 双精度浮点字段求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumdouble_stride_sse", SIMDSUM_ISA_SSE2, sumdouble_stride_sse},	// 双精度浮点字段求和_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumdouble_stride_avx", SIMDSUM_ISA_AVX, sumdouble_stride_avx},	// 双精度浮点字段求和_AVX版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumdouble_stride_avx2", SIMDSUM_ISA_AVX2, sumdouble_stride_avx2},	// 双精度浮点字段求和_AVX2版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+	{NULL, 0, NULL}
+};
+
+static const SUMF16KERNEL simdsum_kernels_f16_list[] = {
+	{"sumhalf_base", SIMDSUM_ISA_BASE, sumhalf_base},	// 半精度浮点数组求和_基本版.
+#ifdef SIMDSUM_HAVE_F16C
+	{"sumhalf_f16c", SIMDSUM_ISA_F16C, sumhalf_f16c},	// 半精度浮点数组求和_F16C版.
+	{"sumhalf_f16c_4loop", SIMDSUM_ISA_F16C, sumhalf_f16c_4loop},	// 半精度浮点数组求和_F16C四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_F16C
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumhalf_avx512", SIMDSUM_ISA_AVX512, sumhalf_avx512},	// 半精度浮点数组求和_AVX-512版.
+	{"sumhalf_avx512_4loop", SIMDSUM_ISA_AVX512, sumhalf_avx512_4loop},	// 半精度浮点数组求和_AVX-512四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{NULL, 0, NULL}
+};
+
+static const SUMF16KERNEL simdsum_kernels_bf16_list[] = {
+	{"sumbf16_base", SIMDSUM_ISA_BASE, sumbf16_base},	// bfloat16数组求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumbf16_sse", SIMDSUM_ISA_SSE2, sumbf16_sse},	// bfloat16数组求和_SSE版.
+	{"sumbf16_sse_4loop", SIMDSUM_ISA_SSE2, sumbf16_sse_4loop},	// bfloat16数组求和_SSE四路循环展开版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumbf16_avx2", SIMDSUM_ISA_AVX2, sumbf16_avx2},	// bfloat16数组求和_AVX2版.
+	{"sumbf16_avx2_4loop", SIMDSUM_ISA_AVX2, sumbf16_avx2_4loop},	// bfloat16数组求和_AVX2四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumbf16_avx512", SIMDSUM_ISA_AVX512, sumbf16_avx512},	// bfloat16数组求和_AVX-512版.
+	{"sumbf16_avx512_4loop", SIMDSUM_ISA_AVX512, sumbf16_avx512_4loop},	// bfloat16数组求和_AVX-512四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{NULL, 0, NULL}
+};
+
+static const SUMU8KERNEL simdsum_kernels_u8_list[] = {
+	{"sumuint8_base", SIMDSUM_ISA_BASE, sumuint8_base},	// 无符号8位整数数组求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumuint8_sse", SIMDSUM_ISA_SSE2, sumuint8_sse},	// 无符号8位整数数组求和_SSE版.
+	{"sumuint8_sse_4loop", SIMDSUM_ISA_SSE2, sumuint8_sse_4loop},	// 无符号8位整数数组求和_SSE四路循环展开版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumuint8_avx2", SIMDSUM_ISA_AVX2, sumuint8_avx2},	// 无符号8位整数数组求和_AVX2版.
+	{"sumuint8_avx2_4loop", SIMDSUM_ISA_AVX2, sumuint8_avx2_4loop},	// 无符号8位整数数组求和_AVX2四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+	{NULL, 0, NULL}
+};
+
+static const SUMI8KERNEL simdsum_kernels_i8_list[] = {
+	{"sumint8_base", SIMDSUM_ISA_BASE, sumint8_base},	// 有符号8位整数数组求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumint8_sse", SIMDSUM_ISA_SSE2, sumint8_sse},	// 有符号8位整数数组求和_SSE版.
+	{"sumint8_sse_4loop", SIMDSUM_ISA_SSE2, sumint8_sse_4loop},	// 有符号8位整数数组求和_SSE四路循环展开版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumint8_avx2", SIMDSUM_ISA_AVX2, sumint8_avx2},	// 有符号8位整数数组求和_AVX2版.
+	{"sumint8_avx2_4loop", SIMDSUM_ISA_AVX2, sumint8_avx2_4loop},	// 有符号8位整数数组求和_AVX2四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+	{NULL, 0, NULL}
+};
+
+static const SUMI16KERNEL simdsum_kernels_i16_list[] = {
+	{"sumint16_base", SIMDSUM_ISA_BASE, sumint16_base},	// 有符号16位整数数组求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumint16_sse", SIMDSUM_ISA_SSE2, sumint16_sse},	// 有符号16位整数数组求和_SSE版.
+	{"sumint16_sse_4loop", SIMDSUM_ISA_SSE2, sumint16_sse_4loop},	// 有符号16位整数数组求和_SSE四路循环展开版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumint16_avx2", SIMDSUM_ISA_AVX2, sumint16_avx2},	// 有符号16位整数数组求和_AVX2版.
+	{"sumint16_avx2_4loop", SIMDSUM_ISA_AVX2, sumint16_avx2_4loop},	// 有符号16位整数数组求和_AVX2四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+	{NULL, 0, NULL}
+};
+
+static const SUMI64KERNEL simdsum_kernels_i64_list[] = {
+	{"sumint64_base", SIMDSUM_ISA_BASE, sumint64_base},	// 64位整数数组求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumint64_sse", SIMDSUM_ISA_SSE2, sumint64_sse},	// 64位整数数组求和_SSE版.
+	{"sumint64_sse_4loop", SIMDSUM_ISA_SSE2, sumint64_sse_4loop},	// 64位整数数组求和_SSE四路循环展开版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumint64_avx2", SIMDSUM_ISA_AVX2, sumint64_avx2},	// 64位整数数组求和_AVX2版.
+	{"sumint64_avx2_4loop", SIMDSUM_ISA_AVX2, sumint64_avx2_4loop},	// 64位整数数组求和_AVX2四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumint64_avx512", SIMDSUM_ISA_AVX512, sumint64_avx512},	// 64位整数数组求和_AVX-512版.
+	{"sumint64_avx512_4loop", SIMDSUM_ISA_AVX512, sumint64_avx512_4loop},	// 64位整数数组求和_AVX-512四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{NULL, 0, NULL}
+};
+
+static const SUMU64KERNEL simdsum_kernels_u64_list[] = {
+	{"sumuint64_base", SIMDSUM_ISA_BASE, sumuint64_base},	// 无符号64位整数数组求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumuint64_sse", SIMDSUM_ISA_SSE2, sumuint64_sse},	// 无符号64位整数数组求和_SSE版.
+	{"sumuint64_sse_4loop", SIMDSUM_ISA_SSE2, sumuint64_sse_4loop},	// 无符号64位整数数组求和_SSE四路循环展开版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumuint64_avx2", SIMDSUM_ISA_AVX2, sumuint64_avx2},	// 无符号64位整数数组求和_AVX2版.
+	{"sumuint64_avx2_4loop", SIMDSUM_ISA_AVX2, sumuint64_avx2_4loop},	// 无符号64位整数数组求和_AVX2四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+#ifdef SIMDSUM_HAVE_AVX512
+	{"sumuint64_avx512", SIMDSUM_ISA_AVX512, sumuint64_avx512},	// 无符号64位整数数组求和_AVX-512版.
+	{"sumuint64_avx512_4loop", SIMDSUM_ISA_AVX512, sumuint64_avx512_4loop},	// 无符号64位整数数组求和_AVX-512四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX512
+	{NULL, 0, NULL}
+};
+
+static const SUMI32WHEREKERNEL simdsum_kernels_i32_where_list[] = {
+	{"sumint_where_base", SIMDSUM_ISA_BASE, sumint_where_base},	// 32位整数数组条件求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumint_where_sse", SIMDSUM_ISA_SSE2, sumint_where_sse},	// 32位整数数组条件求和_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX2
+	{"sumint_where_avx2", SIMDSUM_ISA_AVX2, sumint_where_avx2},	// 32位整数数组条件求和_AVX2版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX2
+	{NULL, 0, NULL}
+};
+
+static const SUMF32WHEREKERNEL simdsum_kernels_f32_where_list[] = {
+	{"sumfloat_where_base", SIMDSUM_ISA_BASE, sumfloat_where_base},	// 单精度浮点数组条件求和_基本版.
+#ifdef INTRIN_SSE
+	{"sumfloat_where_sse", SIMDSUM_ISA_SSE, sumfloat_where_sse},	// 单精度浮点数组条件求和_SSE版.
+#endif	// #ifdef INTRIN_SSE
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumfloat_where_avx", SIMDSUM_ISA_AVX, sumfloat_where_avx},	// 单精度浮点数组条件求和_AVX版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+	{NULL, 0, NULL}
+};
+
+static const SUMF64WHEREKERNEL simdsum_kernels_f64_where_list[] = {
+	{"sumdouble_where_base", SIMDSUM_ISA_BASE, sumdouble_where_base},	// 双精度浮点数组条件求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumdouble_where_sse", SIMDSUM_ISA_SSE2, sumdouble_where_sse},	// 双精度浮点数组条件求和_SSE版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumdouble_where_avx", SIMDSUM_ISA_AVX, sumdouble_where_avx},	// 双精度浮点数组条件求和_AVX版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+	{NULL, 0, NULL}
+};
+
+static const SUMF32NANKERNEL simdsum_kernels_f32_nan_list[] = {
+	{"sumfloat_nan_base", SIMDSUM_ISA_BASE, sumfloat_nan_base},	// 单精度浮点数组跳过NaN求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumfloat_nan_sse", SIMDSUM_ISA_SSE2, sumfloat_nan_sse},	// 单精度浮点数组跳过NaN求和_SSE版.
+	{"sumfloat_nan_sse_4loop", SIMDSUM_ISA_SSE2, sumfloat_nan_sse_4loop},	// 单精度浮点数组跳过NaN求和_SSE四路循环展开版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumfloat_nan_avx", SIMDSUM_ISA_AVX, sumfloat_nan_avx},	// 单精度浮点数组跳过NaN求和_AVX版.
+	{"sumfloat_nan_avx_4loop", SIMDSUM_ISA_AVX, sumfloat_nan_avx_4loop},	// 单精度浮点数组跳过NaN求和_AVX四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+	{NULL, 0, NULL}
+};
+
+static const SUMF64NANKERNEL simdsum_kernels_f64_nan_list[] = {
+	{"sumdouble_nan_base", SIMDSUM_ISA_BASE, sumdouble_nan_base},	// 双精度浮点数组跳过NaN求和_基本版.
+#ifdef INTRIN_SSE2
+	{"sumdouble_nan_sse", SIMDSUM_ISA_SSE2, sumdouble_nan_sse},	// 双精度浮点数组跳过NaN求和_SSE版.
+	{"sumdouble_nan_sse_4loop", SIMDSUM_ISA_SSE2, sumdouble_nan_sse_4loop},	// 双精度浮点数组跳过NaN求和_SSE四路循环展开版.
+#endif	// #ifdef INTRIN_SSE2
+#ifdef SIMDSUM_HAVE_AVX
+	{"sumdouble_nan_avx", SIMDSUM_ISA_AVX, sumdouble_nan_avx},	// 双精度浮点数组跳过NaN求和_AVX版.
+	{"sumdouble_nan_avx_4loop", SIMDSUM_ISA_AVX, sumdouble_nan_avx_4loop},	// 双精度浮点数组跳过NaN求和_AVX四路循环展开版.
+#endif	// #ifdef SIMDSUM_HAVE_AVX
+	{NULL, 0, NULL}
+};
+
+const SUMI32KERNEL* simdsum_kernels_i32(void)
+{
+	return simdsum_kernels_i32_list;
+}
+
+const SUMF32KERNEL* simdsum_kernels_f32(void)
+{
+	return simdsum_kernels_f32_list;
+}
+
+const SUMF64KERNEL* simdsum_kernels_f64(void)
+{
+	return simdsum_kernels_f64_list;
+}
+
+const SUMI32WIDEKERNEL* simdsum_kernels_i32_wide(void)
+{
+	return simdsum_kernels_i32_wide_list;
+}
+
+const SUMI32SEGKERNEL* simdsum_kernels_i32_seg(void)
+{
+	return simdsum_kernels_i32_seg_list;
+}
+
+const SUMF32SEGKERNEL* simdsum_kernels_f32_seg(void)
+{
+	return simdsum_kernels_f32_seg_list;
+}
+
+const SUMF64SEGKERNEL* simdsum_kernels_f64_seg(void)
+{
+	return simdsum_kernels_f64_seg_list;
+}
+
+const SUMI32STATSKERNEL* simdsum_kernels_i32_stats(void)
+{
+	return simdsum_kernels_i32_stats_list;
+}
+
+const SUMF32STATSKERNEL* simdsum_kernels_f32_stats(void)
+{
+	return simdsum_kernels_f32_stats_list;
+}
+
+const SUMF64STATSKERNEL* simdsum_kernels_f64_stats(void)
+{
+	return simdsum_kernels_f64_stats_list;
+}
+
+const DOTF32KERNEL* simdsum_kernels_f32_dot(void)
+{
+	return simdsum_kernels_f32_dot_list;
+}
+
+const DOTF64KERNEL* simdsum_kernels_f64_dot(void)
+{
+	return simdsum_kernels_f64_dot_list;
+}
+
+const SCANI32KERNEL* simdsum_kernels_i32_scan(void)
+{
+	return simdsum_kernels_i32_scan_list;
+}
+
+const SCANI64KERNEL* simdsum_kernels_i64_scan(void)
+{
+	return simdsum_kernels_i64_scan_list;
+}
+
+const SCANF32KERNEL* simdsum_kernels_f32_scan(void)
+{
+	return simdsum_kernels_f32_scan_list;
+}
+
+const SCANF64KERNEL* simdsum_kernels_f64_scan(void)
+{
+	return simdsum_kernels_f64_scan_list;
+}
+
+const SUMI32STRIDEKERNEL* simdsum_kernels_i32_stride(void)
+{
+	return simdsum_kernels_i32_stride_list;
+}
+
+const SUMF32STRIDEKERNEL* simdsum_kernels_f32_stride(void)
+{
+	return simdsum_kernels_f32_stride_list;
+}
+
+const SUMF64STRIDEKERNEL* simdsum_kernels_f64_stride(void)
+{
+	return simdsum_kernels_f64_stride_list;
+}
+
+const SUMF16KERNEL* simdsum_kernels_f16(void)
+{
+	return simdsum_kernels_f16_list;
+}
+
+const SUMF16KERNEL* simdsum_kernels_bf16(void)
+{
+	return simdsum_kernels_bf16_list;
+}
+
+const SUMU8KERNEL* simdsum_kernels_u8(void)
+{
+	return simdsum_kernels_u8_list;
+}
+
+const SUMI8KERNEL* simdsum_kernels_i8(void)
+{
+	return simdsum_kernels_i8_list;
+}
+
+const SUMI16KERNEL* simdsum_kernels_i16(void)
+{
+	return simdsum_kernels_i16_list;
+}
+
+const SUMI64KERNEL* simdsum_kernels_i64(void)
+{
+	return simdsum_kernels_i64_list;
+}
+
+const SUMU64KERNEL* simdsum_kernels_u64(void)
+{
+	return simdsum_kernels_u64_list;
+}
+
+const SUMI32WHEREKERNEL* simdsum_kernels_i32_where(void)
+{
+	return simdsum_kernels_i32_where_list;
+}
+
+const SUMF32WHEREKERNEL* simdsum_kernels_f32_where(void)
+{
+	return simdsum_kernels_f32_where_list;
+}
+
+const SUMF64WHEREKERNEL* simdsum_kernels_f64_where(void)
+{
+	return simdsum_kernels_f64_where_list;
+}
+
+const SUMF32NANKERNEL* simdsum_kernels_f32_nan(void)
+{
+	return simdsum_kernels_f32_nan_list;
+}
+
+const SUMF64NANKERNEL* simdsum_kernels_f64_nan(void)
+{
+	return simdsum_kernels_f64_nan_list;
+}
@@ -0,0 +1,914 @@
+﻿#ifndef __SIMDSUM_H_INCLUDED
+#define __SIMDSUM_H_INCLUDED
+
+#include <stddef.h>
+
+#include "stdint.h"
+
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+////////////////////////////////////////
+// ISA: 指令集级别.
+////////////////////////////////////////
+
+// 求和内核所需的指令集级别. simdsum_isa 函数的返回值.
+#define SIMDSUM_ISA_BASE	0	// 基本版, 不使用SIMD.
+#define SIMDSUM_ISA_MMX	1	// MMX
+#define SIMDSUM_ISA_SSE	2	// SSE
+#define SIMDSUM_ISA_SSE2	3	// SSE2
+#define SIMDSUM_ISA_SSE41	4	// SSE4.1
+#define SIMDSUM_ISA_AVX	5	// AVX
+#define SIMDSUM_ISA_F16C	6	// AVX + F16C
+#define SIMDSUM_ISA_FMA	7	// AVX + F16C + FMA3. 支持FMA3的处理器都支持F16C.
+#define SIMDSUM_ISA_AVX2	8	// AVX2. 也包含F16C与FMA3（与x86-64-v3相同）.
+#define SIMDSUM_ISA_AVX512	9	// AVX-512F + AVX-512BW + AVX-512DQ
+#define SIMDSUM_ISA_MAX	SIMDSUM_ISA_AVX512	// 最高级别.
+
+// 强制使用较低指令集级别的环境变量名. 取值为 simdsum_isa_name 返回的名称, 例如 "sse2".
+#define SIMDSUM_ENV_ISA	"SIMDSUM_ISA"
+
+
+// 取得当前使用的指令集级别.
+//
+// result: 返回求和函数实际使用的指令集级别. 即硬件级别与环境变量SIMDSUM_ISA中的较小者. 详见SIMDSUM_ISA_常数.
+// phwisa: 返回硬件（含操作系统）支持的指令集级别. 详见SIMDSUM_ISA_常数.
+int	simdsum_isa(int* phwisa);
+
+// 取得指令集级别的名称.
+//
+// result: 返回名称. 级别无效时返回空串.
+// isa: 指令集级别. 详见SIMDSUM_ISA_常数.
+const char* simdsum_isa_name(int isa);
+
+
+////////////////////////////////////////
+// simd_sum: 运行时分派的求和函数.
+////////////////////////////////////////
+
+// 数组求和. 在加载时根据CPUID选定最佳内核, 之后每次调用只是一次间接跳转.
+//
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+int32_t simd_sum_i32(const int32_t* pbuf, size_t cntbuf);
+float simd_sum_f32(const float* pbuf, size_t cntbuf);
+double simd_sum_f64(const double* pbuf, size_t cntbuf);
+
+// 浮点数组补偿求和. 每个SIMD通道都带补偿变量, 精度接近Kahan-Neumaier算法.
+float simd_sum_f32_kahan(const float* pbuf, size_t cntbuf);
+double simd_sum_f64_kahan(const double* pbuf, size_t cntbuf);
+
+// 32位整数数组求和, 返回64位结果. 在SIMD通道内扩展为64位累加, 不会溢出.
+int64_t simd_sum_i32_wide(const int32_t* pbuf, size_t cntbuf);
+
+
+////////////////////////////////////////
+// simd_sum_seg: 分段求和. 一次调用求出许多小数组各自的和.
+////////////////////////////////////////
+
+// 分段求和. 各段在pbuf中依次存放, 由CSR式的偏移数组划分: 第i段为 pbuf[poffs[i]] ~ pbuf[poffs[i+1]-1].
+// 每次处理向量宽度个段, 各段的部分和最后一起转置求和并存储, 段尾用掩码处理. 比逐段调用 simd_sum_* 省去了每段的函数调用、对齐处理、逐个处理的剩余部分与水平求和.
+// 段可以为空（poffs[i]==poffs[i+1]）, 其和为0. 各段都不必对齐.
+//
+// pbuf: 数值数组.
+// poffs: 偏移数组. 共cntseg+1项, 须单调不减.
+// cntseg: 段数.
+// psums: 返回各段之和. 共cntseg项.
+void simd_sum_seg_i32(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums);
+void simd_sum_seg_f32(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums);
+void simd_sum_seg_f64(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums);
+
+
+////////////////////////////////////////
+// simd_sum_stats: 单遍统计. 一次读取求出元素数、和、最小值、最大值与平方和.
+////////////////////////////////////////
+
+// 统计量. 各部分的结果可用 simdsum_stats_merge 合并, 故可以分块（或分线程）统计后再合并.
+typedef struct tagSIMDSUM_STATS{
+	uint64_t	cnt;	// 元素数.
+	double	sum;	// 和.
+	double	min;	// 最小值. cnt为0时为+∞.
+	double	max;	// 最大值. cnt为0时为-∞.
+	double	sumsq;	// 平方和.
+	double	m2;	// 离差平方和, 即Σ(x-均值)². 用于求方差, 比 sumsq - sum²/cnt 精确.
+}SIMDSUM_STATS;
+
+// 数组的统计量. 各元素转为双精度后累加, 单精度与32位整数也不会因累加而损失精度.
+// 以第一个元素为原点平移后累加 x-K 与 (x-K)², 方差不受相消误差影响. 平方用FMA（若支持）.
+// 不处理NaN: 含NaN时最小值与最大值无意义.
+//
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+// pst: 返回统计量.
+void simd_sum_stats_i32(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void simd_sum_stats_f32(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void simd_sum_stats_f64(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+
+// 置为空的统计量（cnt为0）.
+void simdsum_stats_init(SIMDSUM_STATS* pst);
+
+// 合并统计量: 把psrc并入pdst. 离差平方和用Chan等人的成对合并公式, 结果与一次统计整个数组相同（舍入误差除外）.
+void simdsum_stats_merge(SIMDSUM_STATS* pdst, const SIMDSUM_STATS* psrc);
+
+// 均值. cnt为0时返回0.
+double simdsum_stats_mean(const SIMDSUM_STATS* pst);
+
+// 方差.
+//
+// result: 返回 m2/(cnt-ddof). cnt不大于ddof时返回0.
+// pst: 统计量.
+// ddof: 自由度的减少量. 0为总体方差, 1为样本方差.
+double simdsum_stats_var(const SIMDSUM_STATS* pst, int ddof);
+
+// 由平移后的累加结果填写统计量. 供各统计内核使用.
+//
+// pst: 返回统计量.
+// cnt: 元素数. 须大于0.
+// k: 原点K.
+// s: Σ(x-K).
+// q: Σ(x-K)².
+// xmin, xmax: 最小值与最大值.
+void simdsum_stats_set(SIMDSUM_STATS* pst, uint64_t cnt, double k, double s, double q, double xmin, double xmax);
+
+
+////////////////////////////////////////
+// simd_dot: 点积（加权和）.
+////////////////////////////////////////
+
+// 点积, 即 Σpa[i]*pb[i]. 累加类型与元素类型相同. 有FMA时用融合乘加, 结果的舍入与标量版不同.
+//
+// result: 返回点积.
+// pa, pb: 两个数组的首地址. 长度均为cntbuf.
+// cntbuf: 数组长度.
+float simd_dot_f32(const float* pa, const float* pb, size_t cntbuf);
+double simd_dot_f64(const double* pa, const double* pb, size_t cntbuf);
+
+
+////////////////////////////////////////
+// simd_scan: 前缀和（扫描）. 求各位置的累计和.
+////////////////////////////////////////
+
+// 前缀和. 含自身时 pdst[i] = init + psrc[0] + ... + psrc[i], 不含自身时 pdst[i] = init + psrc[0] + ... + psrc[i-1].
+// 例如由各记录的长度求各记录的偏移, 就是不含自身的前缀和.
+// pdst可以等于psrc, 即原地计算. 其他情况下两者不能重叠.
+// 整数溢出时回绕. 浮点的累加顺序与逐个相加不同, 结果的舍入可能不同.
+//
+// result: 返回 init 加上全部元素之和. 分块计算时可作为下一块的init.
+// pdst: 返回前缀和.
+// psrc: 源数组.
+// cntbuf: 数组长度.
+// init: 初值.
+// excl: 非0表示不含自身（exclusive）, 0表示含自身（inclusive）.
+int32_t simd_scan_i32(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl);
+int64_t simd_scan_i64(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl);
+float simd_scan_f32(float* pdst, const float* psrc, size_t cntbuf, float init, int excl);
+double simd_scan_f64(double* pdst, const double* psrc, size_t cntbuf, double init, int excl);
+
+
+////////////////////////////////////////
+// simd_sum_stride: 结构体数组（AoS）中某个字段的求和.
+////////////////////////////////////////
+
+// 字段求和. 第i个记录的字段位于 (const char*)pbase + i*cbstride + cboffset.
+// 例如 struct { int32_t id; float price; int32_t qty; } 数组的price字段, cbstride为结构体大小, cboffset为price的偏移.
+// 按步长选择方法: 步长整除向量宽度时连续加载, 字段总在相同的通道, 无需重排; 其他小步长在有AVX2时用聚集加载;
+// 步长不小于缓存行时逐个读取并软件预取（预取距离见 simdsum_prefetch_setdist）.
+// 只需求和时, 比先把字段复制为连续数组（转为SoA）再用 simd_sum_* 少一遍读写.
+// 字段可以不按元素大小对齐. 整数溢出时回绕. 浮点的累加顺序与逐个相加不同, 结果的舍入可能不同.
+//
+// result: 返回字段之和.
+// pbase: 第一个记录的地址.
+// cntrec: 记录数.
+// cbstride: 步长, 即相邻记录的字节距离.
+// cboffset: 字段在记录内的字节偏移.
+int32_t simd_sum_stride_i32(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+float simd_sum_stride_f32(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+double simd_sum_stride_f64(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+
+
+////////////////////////////////////////
+// simd_sum_f16: 16位浮点数组求和.
+////////////////////////////////////////
+
+// 16位浮点数组求和. 加载时转为单精度, 用单精度累加; 与先转为float数组再用 simd_sum_f32 求和相比, 读取的字节数只有一半.
+// f16为IEEE 754半精度（binary16）, 用F16C的VCVTPH2PS转换. bf16为bfloat16, 即float的高16位, 低16位补0就是float, 只需整数的交错或移位.
+//
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址. 各元素为16位浮点数的位模式.
+// cntbuf: 数组长度.
+float simd_sum_f16(const uint16_t* pbuf, size_t cntbuf);
+float simd_sum_bf16(const uint16_t* pbuf, size_t cntbuf);
+
+// 16位浮点数与float的转换. 转为float是精确的. 由float转换时舍入到最近（正好居中时取偶数）, f16超出范围时为无穷大. NaN仍为NaN.
+float simdsum_f16_to_f32(uint16_t h);
+float simdsum_bf16_to_f32(uint16_t h);
+uint16_t simdsum_f32_to_f16(float x);
+uint16_t simdsum_f32_to_bf16(float x);
+
+
+////////////////////////////////////////
+// simd_sum_u8: 8位、16位整数数组求和.
+////////////////////////////////////////
+
+// 窄整数数组求和. 在寄存器内加宽, 结果为64位, 不会溢出.
+// 与先把数组加宽为int32再求和相比, 读取的字节数只有1/4（8位）或1/2（16位）.
+// u8用PSADBW, 每个向量一条指令就得到64位通道的部分和. i8先异或0x80转为无符号再用PSADBW, 最后减去128×元素数.
+// i16用PMADDWD与全1相乘, 相邻两个元素相加为32位, 每累加一段再扩展为64位.
+//
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址. 可以是任意地址.
+// cntbuf: 数组长度.
+uint64_t simd_sum_u8(const uint8_t* pbuf, size_t cntbuf);
+int64_t simd_sum_i8(const int8_t* pbuf, size_t cntbuf);
+int64_t simd_sum_i16(const int16_t* pbuf, size_t cntbuf);
+
+
+////////////////////////////////////////
+// simd_sum_i64: 64位整数数组求和.
+////////////////////////////////////////
+
+// 64位整数数组求和. 适用于时间戳、字节计数、金额等以int64保存的数据. 有符号版溢出时回绕.
+// 无符号版逐通道统计进位, 得到精确的128位结果: 总和 = *pcarry × 2^64 + 返回值.
+//
+// result: 返回数组求和结果. 无符号版为总和的低64位.
+// pbuf: 数组的首地址. 可以是任意地址.
+// cntbuf: 数组长度.
+// pcarry: 返回进位次数（总和的高64位）. 非0表示64位结果已溢出. 可以为NULL.
+int64_t simd_sum_i64(const int64_t* pbuf, size_t cntbuf);
+uint64_t simd_sum_u64(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry);
+
+
+////////////////////////////////////////
+// simd_sum_where: 条件求和. 相当于 SUM(val) WHERE lo <= key < hi.
+////////////////////////////////////////
+
+// 区间边界的类型. 默认为 lo <= key < hi.
+#define SIMDSUM_WHERE_LO_OPEN	1	// 下界不含等号: key > lo.
+#define SIMDSUM_WHERE_HI_CLOSED	2	// 上界含等号: key <= hi.
+
+// 条件求和. 对key落在区间内的元素, 求值之和. 条件可以在值本身上（单列）, 也可以在另一列上.
+// 循环内没有分支: 每个向量比较得到掩码, 与值按位与后再累加. 故耗时与选择率无关, 也不受分支预测失败的影响.
+// 例如 SUM(x) WHERE x > t: pkey为NULL, lo为t, hi为最大值（浮点为INFINITY）, flags为 SIMDSUM_WHERE_LO_OPEN|SIMDSUM_WHERE_HI_CLOSED.
+// 浮点的key为NaN时条件不成立. 整数溢出时回绕.
+//
+// result: 返回满足条件的元素之和.
+// pval: 值数组. 可以是任意地址.
+// pkey: 条件数组, 长度与pval相同. 为NULL时对pval本身判断.
+// cntbuf: 数组长度.
+// lo: 区间的下界.
+// hi: 区间的上界.
+// flags: 边界类型. 详见SIMDSUM_WHERE_常数.
+int32_t simd_sum_where_i32(const int32_t* pval, const int32_t* pkey, size_t cntbuf, int32_t lo, int32_t hi, int flags);
+float simd_sum_where_f32(const float* pval, const float* pkey, size_t cntbuf, float lo, float hi, int flags);
+double simd_sum_where_f64(const double* pval, const double* pkey, size_t cntbuf, double lo, double hi, int flags);
+
+
+////////////////////////////////////////
+// simd_sum_nan: 跳过NaN的浮点数组求和. 相当于 numpy.nansum.
+////////////////////////////////////////
+
+// 跳过NaN求和, 并统计参与求和的元素个数. 普通的 simd_sum_f32/f64 遇到任一NaN, 结果就是NaN.
+// 循环内用有序比较（x与自身比较）得到掩码, 把NaN清为0后再累加, 没有分支, 耗时接近普通求和.
+// 无穷大照常参与求和. 全部为NaN时返回0, 个数为0. 可用 总和/个数 求忽略缺失值的平均值.
+//
+// result: 返回非NaN元素之和.
+// pbuf: 数组的首地址. 可以是任意地址.
+// cntbuf: 数组长度.
+// pcnt: 返回非NaN元素的个数. 可以为NULL.
+float simd_sum_f32_nan(const float* pbuf, size_t cntbuf, size_t* pcnt);
+double simd_sum_f64_nan(const double* pbuf, size_t cntbuf, size_t* pcnt);
+
+
+////////////////////////////////////////
+// simd_sum_nta: 带软件预取的流式求和. 适用于远大于末级缓存的数组.
+////////////////////////////////////////
+
+#define SIMDSUM_PREFETCH_DIST	1024	// 默认预取距离（字节）.
+#define SIMDSUM_ENV_PREFETCH	"SIMDSUM_PFDIST"	// 设置预取距离的环境变量名. 取值为字节数.
+
+// 数组求和_流式. 按预取距离用PREFETCHNTA提前预取, 数据不进入（或很快逐出）L2/L3, 扫描大数组时不会冲掉其他数据.
+// 未用MOVNTDQA: 它的非临时提示只对WC内存有效, 对普通的WB内存等同于普通加载.
+// 指令集低于AVX时使用 simd_sum_* 的内核.
+//
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+int32_t simd_sum_i32_nta(const int32_t* pbuf, size_t cntbuf);
+float simd_sum_f32_nta(const float* pbuf, size_t cntbuf);
+double simd_sum_f64_nta(const double* pbuf, size_t cntbuf);
+
+// 设置预取距离. 影响 simd_sum_*_nta 与各预取版内核（*_pf, *_nta）. 默认为 SIMDSUM_PREFETCH_DIST, 或环境变量SIMDSUM_PFDIST的值.
+//
+// cbdist: 预取距离（字节）.
+void simdsum_prefetch_setdist(size_t cbdist);
+
+// 取得预取距离（字节）.
+size_t simdsum_prefetch_dist(void);
+
+// 取得缓存行大小（字节）. 由CPUID检测（CPUF_CLFlush, 其次为CPUF_Cache_LineSize）, 无法检测时为 SIMDSUM_CACHELINE.
+size_t simdsum_cacheline(void);
+
+////////////////////////////////////////
+// simd_sum_file: 内存映射文件求和.
+////////////////////////////////////////
+
+// 对原始二进制文件求和. 文件内容为主机字节序的数组, 末尾不足一个元素的字节被忽略.
+// 用mmap只读映射整个文件, 并用madvise提示顺序访问（MADV_SEQUENTIAL）与透明大页（MADV_HUGEPAGE）. 映射的页面直接交给 simd_sum_* 求和, 不经过read()复制到缓冲区.
+// 32位整数文件用 simd_sum_i32_wide 求和, 结果为64位, 不会溢出. 32位程序无法映射超过地址空间的文件.
+//
+// result: 成功时返回0, 否则返回错误码（UNIX下为errno, Windows下为GetLastError）.
+// szpath: 文件路径.
+// psum: 返回求和结果.
+// pcnt: 返回元素数. 可以为NULL.
+int simd_sum_file_i32(const char* szpath, int64_t* psum, size_t* pcnt);
+int simd_sum_file_f32(const char* szpath, float* psum, size_t* pcnt);
+int simd_sum_file_f64(const char* szpath, double* psum, size_t* pcnt);
+
+////////////////////////////////////////
+// simd_sum_fd: 流水线读取求和. 读取与求和重叠进行.
+////////////////////////////////////////
+
+#define SIMDSUM_INGEST_CHUNK	(256*1024)	// 默认的块大小（字节）. 整个环形缓冲区（块大小×块数）应小于L2, 否则刚读入的块在求和前就被挤出缓存.
+#define SIMDSUM_INGEST_DEPTH	4	// 默认的环形缓冲区块数.
+#define SIMDSUM_INGEST_MAXDEPTH	64	// 环形缓冲区的最大块数.
+
+// 流水线参数. 为0的成员使用默认值.
+typedef struct tagSIMDSUM_INGEST{
+	size_t	cbchunk;	// 块大小（字节）. 向上取整为4096的倍数.
+	int	depth;	// 环形缓冲区的块数. 为1时不创建I/O线程, 在调用线程中读一块求一块（串行）.
+	uint64_t	cblimit;	// 最多读取的字节数. 0表示读到文件结尾. 对/dev/zero等无尽的输入必须设置.
+}SIMDSUM_INGEST;
+
+// 从文件描述符读取原始二进制数组并求和. 适用于管道、套接字、设备等无法映射的输入.
+// I/O线程用read()把数据按块读入环形缓冲区, 调用线程在每块读满后立即用 simd_sum_* 求和.
+// 缓冲区全满时I/O线程等待（背压）, 全空时调用线程等待. 有两个以上逻辑处理器时, 吞吐量接近读取与求和中较慢的一方, 而不是两者串行时的调和组合.
+// 末尾不足一个元素的字节被忽略. 多个线程同时调用时会依次执行.
+//
+// result: 成功时返回0, 否则返回错误码（errno）. 出错之前读到的数据仍会求和.
+// fd: 文件描述符. Windows下为CRT的文件描述符（_open）.
+// pcfg: 流水线参数. 可以为NULL, 表示全部使用默认值.
+// psum: 返回求和结果.
+// pcb: 返回读取的字节数. 可以为NULL.
+int simd_sum_fd_i32(int fd, const SIMDSUM_INGEST* pcfg, int64_t* psum, uint64_t* pcb);
+int simd_sum_fd_f32(int fd, const SIMDSUM_INGEST* pcfg, float* psum, uint64_t* pcb);
+int simd_sum_fd_f64(int fd, const SIMDSUM_INGEST* pcfg, double* psum, uint64_t* pcb);
+
+////////////////////////////////////////
+// simdsum_arena: 大页内存区. 用于扫描大数组时减少TLB缺失.
+////////////////////////////////////////
+
+#define SIMDSUM_HUGEPAGE	(2*1024*1024)	// 大页大小. 内存区按它对齐, 大小也向上取整为它的倍数.
+#define SIMDSUM_ARENA_ALIGN	64	// simdsum_arena_alloc 返回的地址按它对齐.
+
+// 页面类型.
+#define SIMDSUM_PAGE_4K	0	// 普通页（4KB）. 会禁止透明大页, 以便与大页对比.
+#define SIMDSUM_PAGE_THP	1	// 透明大页. 用madvise(MADV_HUGEPAGE)提示内核, 缺页时尽量分配2MB页.
+#define SIMDSUM_PAGE_HUGETLB	2	// 预留大页. 用mmap(MAP_HUGETLB)从vm.nr_hugepages预留的大页中分配. Windows下为MEM_LARGE_PAGES.
+
+// 内存区. 一次映射整块内存, 之后按顺序切分, 只能整体释放.
+typedef struct tagSIMDSUM_ARENA{
+	char*	pbase;	// 首地址. 按 SIMDSUM_HUGEPAGE 对齐.
+	size_t	cb;	// 字节数.
+	size_t	cbused;	// 已分配的字节数.
+	int	page;	// 实际的页面类型. 详见SIMDSUM_PAGE_常数.
+}SIMDSUM_ARENA;
+
+// 创建内存区. 所需的页面类型不可用时逐级退回: 预留大页 → 透明大页 → 普通页. 实际类型见 pa->page.
+// 预留大页须先由管理员设置vm.nr_hugepages（Windows下须有SeLockMemoryPrivilege权限）; Windows没有透明大页.
+//
+// result: 成功时返回0, 否则返回错误码（UNIX下为errno, Windows下为GetLastError）.
+// pa: 返回内存区.
+// cb: 字节数.
+// page: 所需的页面类型. 详见SIMDSUM_PAGE_常数.
+int simdsum_arena_init(SIMDSUM_ARENA* pa, size_t cb, int page);
+
+// 从内存区分配. 地址按 SIMDSUM_ARENA_ALIGN 对齐.
+//
+// result: 返回首地址. 剩余空间不足时返回NULL.
+// pa: 内存区.
+// cb: 字节数.
+void* simdsum_arena_alloc(SIMDSUM_ARENA* pa, size_t cb);
+
+// 清空内存区. 之前分配的内存全部失效, 但页面仍保留.
+void simdsum_arena_reset(SIMDSUM_ARENA* pa);
+
+// 释放内存区.
+void simdsum_arena_free(SIMDSUM_ARENA* pa);
+
+// 取得页面类型的名称, 为"4k", "thp"或"hugetlb".
+//
+// result: 返回名称. 类型无效时返回空串.
+// page: 页面类型. 详见SIMDSUM_PAGE_常数.
+const char* simdsum_page_name(int page);
+
+////////////////////////////////////////
+// simd_stream: STREAM式带宽基准. 用于衡量求和内核离内存带宽上限还有多远.
+////////////////////////////////////////
+
+// 只读. 读取整个数组.
+//
+// result: 返回各元素按位或的结果. 只用于防止调用被优化掉.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+uint64_t simd_stream_read(const double* pbuf, size_t cntbuf);
+
+// 复制. pdst[i] = psrc[i]. 数组不能重叠.
+void simd_stream_copy(double* pdst, const double* psrc, size_t cntbuf);
+
+// 三元组. pa[i] = pb[i] + s*pc[i]. 数组不能重叠.
+void simd_stream_triad(double* pa, const double* pb, const double* pc, double s, size_t cntbuf);
+
+
+////////////////////////////////////////
+// simd_sum_mt: 多线程并行求和.
+////////////////////////////////////////
+
+#define SIMDSUM_CACHELINE	64	// 缓存行大小. 用于对齐分块边界与填充部分和.
+#define SIMDSUM_MT_MAXTHREADS	64	// 线程池的最大线程数.
+#define SIMDSUM_MT_THRESHOLD	(1024*1024)	// 默认阈值（字节）. 数据量小于它时不使用多线程.
+
+// 初始化线程池. 可以不调用, 首次需要多线程时会自动按逻辑处理器数初始化. 已初始化时不会改变线程数.
+//
+// result: 返回线程池的线程数（含调用线程）.
+// nthreads: 线程数. 0表示使用逻辑处理器数.
+int simdsum_mt_init(int nthreads);
+
+// 释放线程池. 之后再次调用并行求和时会重新创建.
+void simdsum_mt_exit(void);
+
+// 设置阈值. 数据量小于阈值时直接在调用线程中求和, 不做任何同步.
+//
+// cbthreshold: 阈值（字节）. 默认为 SIMDSUM_MT_THRESHOLD.
+void simdsum_mt_setthreshold(size_t cbthreshold);
+
+// 并行数组求和. 将数组按缓存行对齐分块, 由线程池中的线程各自调用 simd_sum_* 求部分和, 再合并.
+// 多个线程同时调用时会依次执行.
+//
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+// nthreads: 使用的线程数（含调用线程）. 0表示使用线程池的全部线程.
+int32_t simd_sum_i32_mt(const int32_t* pbuf, size_t cntbuf, int nthreads);
+float simd_sum_f32_mt(const float* pbuf, size_t cntbuf, int nthreads);
+double simd_sum_f64_mt(const double* pbuf, size_t cntbuf, int nthreads);
+
+// 并行前缀和. 分两遍: 第一遍各线程求各块之和, 由此得到各块的初值; 第二遍各线程用 simd_scan_* 计算各块的前缀和.
+// 源数组读取两次, 目标数组只写一次. pdst可以等于psrc. 浮点时各块之和的累加顺序不同, 结果与 simd_scan_* 可能略有差异.
+//
+// nthreads: 使用的线程数（含调用线程）. 0表示使用线程池的全部线程.
+// 其余参数与返回值同 simd_scan_*.
+int32_t simd_scan_i32_mt(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl, int nthreads);
+int64_t simd_scan_i64_mt(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl, int nthreads);
+float simd_scan_f32_mt(float* pdst, const float* psrc, size_t cntbuf, float init, int excl, int nthreads);
+double simd_scan_f64_mt(double* pdst, const double* psrc, size_t cntbuf, double init, int excl, int nthreads);
+
+
+////////////////////////////////////////
+// kernels: 各指令集的求和内核.
+////////////////////////////////////////
+
+// 求和内核的函数类型.
+typedef int32_t (*SUMI32PROC)(const int32_t* pbuf, size_t cntbuf);
+typedef float (*SUMF32PROC)(const float* pbuf, size_t cntbuf);
+typedef double (*SUMF64PROC)(const double* pbuf, size_t cntbuf);
+typedef int64_t (*SUMI32WIDEPROC)(const int32_t* pbuf, size_t cntbuf);
+typedef void (*SUMI32SEGPROC)(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums);
+typedef void (*SUMF32SEGPROC)(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums);
+typedef void (*SUMF64SEGPROC)(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums);
+typedef void (*SUMI32STATSPROC)(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+typedef void (*SUMF32STATSPROC)(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+typedef void (*SUMF64STATSPROC)(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+typedef float (*DOTF32PROC)(const float* pa, const float* pb, size_t cntbuf);
+typedef double (*DOTF64PROC)(const double* pa, const double* pb, size_t cntbuf);
+typedef int32_t (*SCANI32PROC)(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl);
+typedef int64_t (*SCANI64PROC)(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl);
+typedef float (*SCANF32PROC)(float* pdst, const float* psrc, size_t cntbuf, float init, int excl);
+typedef double (*SCANF64PROC)(double* pdst, const double* psrc, size_t cntbuf, double init, int excl);
+typedef int32_t (*SUMI32STRIDEPROC)(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+typedef float (*SUMF32STRIDEPROC)(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+typedef double (*SUMF64STRIDEPROC)(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+typedef float (*SUMF16PROC)(const uint16_t* pbuf, size_t cntbuf);	// f16与bf16共用.
+typedef uint64_t (*SUMU8PROC)(const uint8_t* pbuf, size_t cntbuf);
+typedef int64_t (*SUMI8PROC)(const int8_t* pbuf, size_t cntbuf);
+typedef int64_t (*SUMI16PROC)(const int16_t* pbuf, size_t cntbuf);
+typedef int64_t (*SUMI64PROC)(const int64_t* pbuf, size_t cntbuf);
+typedef uint64_t (*SUMU64PROC)(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry);
+typedef int32_t (*SUMI32WHEREPROC)(const int32_t* pval, const int32_t* pkey, size_t cntbuf, int32_t lo, int32_t hi, int flags);
+typedef float (*SUMF32WHEREPROC)(const float* pval, const float* pkey, size_t cntbuf, float lo, float hi, int flags);
+typedef double (*SUMF64WHEREPROC)(const double* pval, const double* pkey, size_t cntbuf, double lo, double hi, int flags);
+typedef float (*SUMF32NANPROC)(const float* pbuf, size_t cntbuf, size_t* pcnt);
+typedef double (*SUMF64NANPROC)(const double* pbuf, size_t cntbuf, size_t* pcnt);
+typedef uint64_t (*STREAMREADPROC)(const double* pbuf, size_t cntbuf);
+typedef void (*STREAMCOPYPROC)(double* pdst, const double* psrc, size_t cntbuf);
+typedef void (*STREAMTRIADPROC)(double* pa, const double* pb, const double* pc, double s, size_t cntbuf);
+
+// 求和内核的描述. 内核表以 szName为NULL 的项结尾.
+typedef struct tagSUMI32KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMI32PROC	proc;	// 函数.
+}SUMI32KERNEL;
+typedef struct tagSUMF32KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF32PROC	proc;	// 函数.
+}SUMF32KERNEL;
+typedef struct tagSUMF64KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF64PROC	proc;	// 函数.
+}SUMF64KERNEL;
+typedef struct tagSUMI32WIDEKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMI32WIDEPROC	proc;	// 函数.
+}SUMI32WIDEKERNEL;
+typedef struct tagSUMI32SEGKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMI32SEGPROC	proc;	// 函数.
+}SUMI32SEGKERNEL;
+typedef struct tagSUMF32SEGKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF32SEGPROC	proc;	// 函数.
+}SUMF32SEGKERNEL;
+typedef struct tagSUMF64SEGKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF64SEGPROC	proc;	// 函数.
+}SUMF64SEGKERNEL;
+typedef struct tagSUMI32STATSKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMI32STATSPROC	proc;	// 函数.
+}SUMI32STATSKERNEL;
+typedef struct tagSUMF32STATSKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF32STATSPROC	proc;	// 函数.
+}SUMF32STATSKERNEL;
+typedef struct tagSUMF64STATSKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF64STATSPROC	proc;	// 函数.
+}SUMF64STATSKERNEL;
+typedef struct tagDOTF32KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	DOTF32PROC	proc;	// 函数.
+}DOTF32KERNEL;
+typedef struct tagDOTF64KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	DOTF64PROC	proc;	// 函数.
+}DOTF64KERNEL;
+typedef struct tagSCANI32KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SCANI32PROC	proc;	// 函数.
+}SCANI32KERNEL;
+typedef struct tagSCANI64KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SCANI64PROC	proc;	// 函数.
+}SCANI64KERNEL;
+typedef struct tagSCANF32KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SCANF32PROC	proc;	// 函数.
+}SCANF32KERNEL;
+typedef struct tagSCANF64KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SCANF64PROC	proc;	// 函数.
+}SCANF64KERNEL;
+typedef struct tagSUMI32STRIDEKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMI32STRIDEPROC	proc;	// 函数.
+}SUMI32STRIDEKERNEL;
+typedef struct tagSUMF32STRIDEKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF32STRIDEPROC	proc;	// 函数.
+}SUMF32STRIDEKERNEL;
+typedef struct tagSUMF64STRIDEKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF64STRIDEPROC	proc;	// 函数.
+}SUMF64STRIDEKERNEL;
+typedef struct tagSUMF16KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF16PROC	proc;	// 函数.
+}SUMF16KERNEL;
+typedef struct tagSUMU8KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMU8PROC	proc;	// 函数.
+}SUMU8KERNEL;
+typedef struct tagSUMI8KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMI8PROC	proc;	// 函数.
+}SUMI8KERNEL;
+typedef struct tagSUMI16KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMI16PROC	proc;	// 函数.
+}SUMI16KERNEL;
+typedef struct tagSUMI64KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMI64PROC	proc;	// 函数.
+}SUMI64KERNEL;
+typedef struct tagSUMU64KERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMU64PROC	proc;	// 函数.
+}SUMU64KERNEL;
+typedef struct tagSUMI32WHEREKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMI32WHEREPROC	proc;	// 函数.
+}SUMI32WHEREKERNEL;
+typedef struct tagSUMF32WHEREKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF32WHEREPROC	proc;	// 函数.
+}SUMF32WHEREKERNEL;
+typedef struct tagSUMF64WHEREKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF64WHEREPROC	proc;	// 函数.
+}SUMF64WHEREKERNEL;
+typedef struct tagSUMF32NANKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF32NANPROC	proc;	// 函数.
+}SUMF32NANKERNEL;
+typedef struct tagSUMF64NANKERNEL{
+	const char*	szName;	// 名称.
+	int	isa;	// 所需的指令集级别. 详见SIMDSUM_ISA_常数.
+	SUMF64NANPROC	proc;	// 函数.
+}SUMF64NANKERNEL;
+
+// 数组开头需要单独处理的元素数, 处理后的地址按cbalign字节对齐. cbalign须为2的幂. 结果不超过cnt.
+// 各SIMD内核都先处理未对齐的开头, 再用对齐的地址批量处理, 最后处理剩下的. 故数组可以从任意地址开始.
+// 若地址未按元素大小对齐, 则无法对齐, 批量处理时用的非对齐加载指令仍能正确运行.
+#define SIMDSUM_HEADCNT(p, cnt, cbalign)	( ((((size_t)0-(size_t)(p)) & ((cbalign)-1)) / sizeof(*(p)) < (size_t)(cnt)) ? ((((size_t)0-(size_t)(p)) & ((cbalign)-1)) / sizeof(*(p))) : (size_t)(cnt) )
+
+// 取得全部已编译的内核. 调用者需自行用 simdsum_isa 判断能否运行.
+const SUMI32KERNEL* simdsum_kernels_i32(void);
+const SUMF32KERNEL* simdsum_kernels_f32(void);
+const SUMF64KERNEL* simdsum_kernels_f64(void);
+const SUMI32WIDEKERNEL* simdsum_kernels_i32_wide(void);
+const SUMI32SEGKERNEL* simdsum_kernels_i32_seg(void);
+const SUMF32SEGKERNEL* simdsum_kernels_f32_seg(void);
+const SUMF64SEGKERNEL* simdsum_kernels_f64_seg(void);
+const SUMI32STATSKERNEL* simdsum_kernels_i32_stats(void);
+const SUMF32STATSKERNEL* simdsum_kernels_f32_stats(void);
+const SUMF64STATSKERNEL* simdsum_kernels_f64_stats(void);
+const DOTF32KERNEL* simdsum_kernels_f32_dot(void);
+const DOTF64KERNEL* simdsum_kernels_f64_dot(void);
+const SCANI32KERNEL* simdsum_kernels_i32_scan(void);
+const SCANI64KERNEL* simdsum_kernels_i64_scan(void);
+const SCANF32KERNEL* simdsum_kernels_f32_scan(void);
+const SCANF64KERNEL* simdsum_kernels_f64_scan(void);
+const SUMI32STRIDEKERNEL* simdsum_kernels_i32_stride(void);
+const SUMF32STRIDEKERNEL* simdsum_kernels_f32_stride(void);
+const SUMF64STRIDEKERNEL* simdsum_kernels_f64_stride(void);
+const SUMF16KERNEL* simdsum_kernels_f16(void);
+const SUMF16KERNEL* simdsum_kernels_bf16(void);
+const SUMU8KERNEL* simdsum_kernels_u8(void);
+const SUMI8KERNEL* simdsum_kernels_i8(void);
+const SUMI16KERNEL* simdsum_kernels_i16(void);
+const SUMI64KERNEL* simdsum_kernels_i64(void);
+const SUMU64KERNEL* simdsum_kernels_u64(void);
+const SUMI32WHEREKERNEL* simdsum_kernels_i32_where(void);
+const SUMF32WHEREKERNEL* simdsum_kernels_f32_where(void);
+const SUMF64WHEREKERNEL* simdsum_kernels_f64_where(void);
+const SUMF32NANKERNEL* simdsum_kernels_f32_nan(void);
+const SUMF64NANKERNEL* simdsum_kernels_f64_nan(void);
+
+// sumint: 32位整数数组求和.
+int32_t sumint_base(const int32_t* pbuf, size_t cntbuf);
+int32_t sumint_mmx(const int32_t* pbuf, size_t cntbuf);
+int32_t sumint_mmx_4loop(const int32_t* pbuf, size_t cntbuf);
+int32_t sumint_sse(const int32_t* pbuf, size_t cntbuf);
+int32_t sumint_sse_4loop(const int32_t* pbuf, size_t cntbuf);
+int32_t sumint_avx2(const int32_t* pbuf, size_t cntbuf);
+int32_t sumint_avx2_4loop(const int32_t* pbuf, size_t cntbuf);
+int32_t sumint_avx2_pf(const int32_t* pbuf, size_t cntbuf);
+int32_t sumint_avx2_nta(const int32_t* pbuf, size_t cntbuf);
+int32_t sumint_avx512(const int32_t* pbuf, size_t cntbuf);
+int32_t sumint_avx512_4loop(const int32_t* pbuf, size_t cntbuf);
+int32_t sumint_avx512_pf(const int32_t* pbuf, size_t cntbuf);
+int32_t sumint_avx512_nta(const int32_t* pbuf, size_t cntbuf);
+
+// sumint_wide: 32位整数数组求和_64位结果.
+int64_t sumint_wide_base(const int32_t* pbuf, size_t cntbuf);
+int64_t sumint_wide_sse41(const int32_t* pbuf, size_t cntbuf);
+int64_t sumint_wide_avx2(const int32_t* pbuf, size_t cntbuf);
+int64_t sumint_wide_avx2_movsx(const int32_t* pbuf, size_t cntbuf);
+
+// sumfloat: 单精度浮点数组求和.
+float sumfloat_base(const float* pbuf, size_t cntbuf);
+float sumfloat_sse(const float* pbuf, size_t cntbuf);
+float sumfloat_sse_4loop(const float* pbuf, size_t cntbuf);
+float sumfloat_avx(const float* pbuf, size_t cntbuf);
+float sumfloat_avx_4loop(const float* pbuf, size_t cntbuf);
+float sumfloat_avx_pf(const float* pbuf, size_t cntbuf);
+float sumfloat_avx_nta(const float* pbuf, size_t cntbuf);
+float sumfloat_avx512(const float* pbuf, size_t cntbuf);
+float sumfloat_avx512_4loop(const float* pbuf, size_t cntbuf);
+float sumfloat_avx512_pf(const float* pbuf, size_t cntbuf);
+float sumfloat_avx512_nta(const float* pbuf, size_t cntbuf);
+float sumfloat_kahan_base(const float* pbuf, size_t cntbuf);
+float sumfloat_kahan_sse(const float* pbuf, size_t cntbuf);
+float sumfloat_kahan_avx(const float* pbuf, size_t cntbuf);
+
+// sumdouble: 双精度浮点数组求和.
+double sumdouble_base(const double* pbuf, size_t cntbuf);
+double sumdouble_sse(const double* pbuf, size_t cntbuf);
+double sumdouble_sse_4loop(const double* pbuf, size_t cntbuf);
+double sumdouble_avx(const double* pbuf, size_t cntbuf);
+double sumdouble_avx_4loop(const double* pbuf, size_t cntbuf);
+double sumdouble_avx_pf(const double* pbuf, size_t cntbuf);
+double sumdouble_avx_nta(const double* pbuf, size_t cntbuf);
+double sumdouble_avx512(const double* pbuf, size_t cntbuf);
+double sumdouble_avx512_4loop(const double* pbuf, size_t cntbuf);
+double sumdouble_avx512_pf(const double* pbuf, size_t cntbuf);
+double sumdouble_avx512_nta(const double* pbuf, size_t cntbuf);
+double sumdouble_kahan_base(const double* pbuf, size_t cntbuf);
+double sumdouble_kahan_sse(const double* pbuf, size_t cntbuf);
+double sumdouble_kahan_avx(const double* pbuf, size_t cntbuf);
+
+// sum_seg: 分段求和.
+void sumint_seg_base(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums);
+void sumint_seg_sse(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums);
+void sumint_seg_avx2(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums);
+void sumint_seg_avx512(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums);
+void sumfloat_seg_base(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums);
+void sumfloat_seg_sse(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums);
+void sumfloat_seg_avx(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums);
+void sumfloat_seg_avx512(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums);
+void sumdouble_seg_base(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums);
+void sumdouble_seg_sse(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums);
+void sumdouble_seg_avx(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums);
+void sumdouble_seg_avx512(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums);
+
+// sum_stats: 单遍统计.
+void sumint_stats_base(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumint_stats_sse(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumint_stats_avx(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumint_stats_fma(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumint_stats_avx512(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumfloat_stats_base(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumfloat_stats_sse(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumfloat_stats_avx(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumfloat_stats_fma(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumfloat_stats_avx512(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumdouble_stats_base(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumdouble_stats_sse(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumdouble_stats_avx(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumdouble_stats_fma(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+void sumdouble_stats_avx512(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst);
+
+// dot: 点积.
+float dotfloat_base(const float* pa, const float* pb, size_t cntbuf);
+float dotfloat_sse_4loop(const float* pa, const float* pb, size_t cntbuf);
+float dotfloat_sse_8loop(const float* pa, const float* pb, size_t cntbuf);
+float dotfloat_avx_4loop(const float* pa, const float* pb, size_t cntbuf);
+float dotfloat_avx_8loop(const float* pa, const float* pb, size_t cntbuf);
+float dotfloat_fma_4loop(const float* pa, const float* pb, size_t cntbuf);
+float dotfloat_fma_8loop(const float* pa, const float* pb, size_t cntbuf);
+double dotdouble_base(const double* pa, const double* pb, size_t cntbuf);
+double dotdouble_sse_4loop(const double* pa, const double* pb, size_t cntbuf);
+double dotdouble_sse_8loop(const double* pa, const double* pb, size_t cntbuf);
+double dotdouble_avx_4loop(const double* pa, const double* pb, size_t cntbuf);
+double dotdouble_avx_8loop(const double* pa, const double* pb, size_t cntbuf);
+double dotdouble_fma_4loop(const double* pa, const double* pb, size_t cntbuf);
+double dotdouble_fma_8loop(const double* pa, const double* pb, size_t cntbuf);
+
+// scan: 前缀和.
+int32_t scanint_base(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl);
+int32_t scanint_sse(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl);
+int32_t scanint_avx2(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl);
+int64_t scanint64_base(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl);
+int64_t scanint64_sse(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl);
+int64_t scanint64_avx2(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl);
+float scanfloat_base(float* pdst, const float* psrc, size_t cntbuf, float init, int excl);
+float scanfloat_sse(float* pdst, const float* psrc, size_t cntbuf, float init, int excl);
+float scanfloat_avx2(float* pdst, const float* psrc, size_t cntbuf, float init, int excl);
+double scandouble_base(double* pdst, const double* psrc, size_t cntbuf, double init, int excl);
+double scandouble_sse(double* pdst, const double* psrc, size_t cntbuf, double init, int excl);
+double scandouble_avx2(double* pdst, const double* psrc, size_t cntbuf, double init, int excl);
+
+// sum_stride: 结构体数组中某个字段的求和.
+int32_t sumint_stride_base(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+int32_t sumint_stride_sse(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+int32_t sumint_stride_avx2(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+float sumfloat_stride_base(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+float sumfloat_stride_sse(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+float sumfloat_stride_avx(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+float sumfloat_stride_avx2(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+double sumdouble_stride_base(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+double sumdouble_stride_sse(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+double sumdouble_stride_avx(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+double sumdouble_stride_avx2(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset);
+
+// sumhalf: 半精度浮点数组求和. sumbf16: bfloat16数组求和.
+float sumhalf_base(const uint16_t* pbuf, size_t cntbuf);
+float sumhalf_f16c(const uint16_t* pbuf, size_t cntbuf);
+float sumhalf_f16c_4loop(const uint16_t* pbuf, size_t cntbuf);
+float sumhalf_avx512(const uint16_t* pbuf, size_t cntbuf);
+float sumhalf_avx512_4loop(const uint16_t* pbuf, size_t cntbuf);
+float sumbf16_base(const uint16_t* pbuf, size_t cntbuf);
+float sumbf16_sse(const uint16_t* pbuf, size_t cntbuf);
+float sumbf16_sse_4loop(const uint16_t* pbuf, size_t cntbuf);
+float sumbf16_avx2(const uint16_t* pbuf, size_t cntbuf);
+float sumbf16_avx2_4loop(const uint16_t* pbuf, size_t cntbuf);
+float sumbf16_avx512(const uint16_t* pbuf, size_t cntbuf);
+float sumbf16_avx512_4loop(const uint16_t* pbuf, size_t cntbuf);
+
+// sumuint8, sumint8, sumint16: 8位、16位整数数组求和_64位结果.
+uint64_t sumuint8_base(const uint8_t* pbuf, size_t cntbuf);
+uint64_t sumuint8_sse(const uint8_t* pbuf, size_t cntbuf);
+uint64_t sumuint8_sse_4loop(const uint8_t* pbuf, size_t cntbuf);
+uint64_t sumuint8_avx2(const uint8_t* pbuf, size_t cntbuf);
+uint64_t sumuint8_avx2_4loop(const uint8_t* pbuf, size_t cntbuf);
+int64_t sumint8_base(const int8_t* pbuf, size_t cntbuf);
+int64_t sumint8_sse(const int8_t* pbuf, size_t cntbuf);
+int64_t sumint8_sse_4loop(const int8_t* pbuf, size_t cntbuf);
+int64_t sumint8_avx2(const int8_t* pbuf, size_t cntbuf);
+int64_t sumint8_avx2_4loop(const int8_t* pbuf, size_t cntbuf);
+int64_t sumint16_base(const int16_t* pbuf, size_t cntbuf);
+int64_t sumint16_sse(const int16_t* pbuf, size_t cntbuf);
+int64_t sumint16_sse_4loop(const int16_t* pbuf, size_t cntbuf);
+int64_t sumint16_avx2(const int16_t* pbuf, size_t cntbuf);
+int64_t sumint16_avx2_4loop(const int16_t* pbuf, size_t cntbuf);
+
+// sumint64, sumuint64: 64位整数数组求和. 无符号版统计进位.
+int64_t sumint64_base(const int64_t* pbuf, size_t cntbuf);
+int64_t sumint64_sse(const int64_t* pbuf, size_t cntbuf);
+int64_t sumint64_sse_4loop(const int64_t* pbuf, size_t cntbuf);
+int64_t sumint64_avx2(const int64_t* pbuf, size_t cntbuf);
+int64_t sumint64_avx2_4loop(const int64_t* pbuf, size_t cntbuf);
+int64_t sumint64_avx512(const int64_t* pbuf, size_t cntbuf);
+int64_t sumint64_avx512_4loop(const int64_t* pbuf, size_t cntbuf);
+uint64_t sumuint64_base(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry);
+uint64_t sumuint64_sse(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry);
+uint64_t sumuint64_sse_4loop(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry);
+uint64_t sumuint64_avx2(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry);
+uint64_t sumuint64_avx2_4loop(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry);
+uint64_t sumuint64_avx512(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry);
+uint64_t sumuint64_avx512_4loop(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry);
+
+// sum_where: 条件求和.
+int32_t sumint_where_base(const int32_t* pval, const int32_t* pkey, size_t cntbuf, int32_t lo, int32_t hi, int flags);
+int32_t sumint_where_sse(const int32_t* pval, const int32_t* pkey, size_t cntbuf, int32_t lo, int32_t hi, int flags);
+int32_t sumint_where_avx2(const int32_t* pval, const int32_t* pkey, size_t cntbuf, int32_t lo, int32_t hi, int flags);
+float sumfloat_where_base(const float* pval, const float* pkey, size_t cntbuf, float lo, float hi, int flags);
+float sumfloat_where_sse(const float* pval, const float* pkey, size_t cntbuf, float lo, float hi, int flags);
+float sumfloat_where_avx(const float* pval, const float* pkey, size_t cntbuf, float lo, float hi, int flags);
+double sumdouble_where_base(const double* pval, const double* pkey, size_t cntbuf, double lo, double hi, int flags);
+double sumdouble_where_sse(const double* pval, const double* pkey, size_t cntbuf, double lo, double hi, int flags);
+double sumdouble_where_avx(const double* pval, const double* pkey, size_t cntbuf, double lo, double hi, int flags);
+
+// sum_nan: 跳过NaN求和. pcnt返回非NaN元素的个数.
+float sumfloat_nan_base(const float* pbuf, size_t cntbuf, size_t* pcnt);
+float sumfloat_nan_sse(const float* pbuf, size_t cntbuf, size_t* pcnt);
+float sumfloat_nan_sse_4loop(const float* pbuf, size_t cntbuf, size_t* pcnt);
+float sumfloat_nan_avx(const float* pbuf, size_t cntbuf, size_t* pcnt);
+float sumfloat_nan_avx_4loop(const float* pbuf, size_t cntbuf, size_t* pcnt);
+double sumdouble_nan_base(const double* pbuf, size_t cntbuf, size_t* pcnt);
+double sumdouble_nan_sse(const double* pbuf, size_t cntbuf, size_t* pcnt);
+double sumdouble_nan_sse_4loop(const double* pbuf, size_t cntbuf, size_t* pcnt);
+double sumdouble_nan_avx(const double* pbuf, size_t cntbuf, size_t* pcnt);
+double sumdouble_nan_avx_4loop(const double* pbuf, size_t cntbuf, size_t* pcnt);
+
+// stream: STREAM式带宽基准.
+uint64_t stream_read_base(const double* pbuf, size_t cntbuf);
+uint64_t stream_read_sse(const double* pbuf, size_t cntbuf);
+uint64_t stream_read_avx(const double* pbuf, size_t cntbuf);
+uint64_t stream_read_avx512(const double* pbuf, size_t cntbuf);
+void stream_copy_base(double* pdst, const double* psrc, size_t cntbuf);
+void stream_copy_sse(double* pdst, const double* psrc, size_t cntbuf);
+void stream_copy_avx(double* pdst, const double* psrc, size_t cntbuf);
+void stream_copy_avx512(double* pdst, const double* psrc, size_t cntbuf);
+void stream_triad_base(double* pa, const double* pb, const double* pc, double s, size_t cntbuf);
+void stream_triad_sse(double* pa, const double* pb, const double* pc, double s, size_t cntbuf);
+void stream_triad_avx(double* pa, const double* pb, const double* pc, double s, size_t cntbuf);
+void stream_triad_avx512(double* pa, const double* pb, const double* pc, double s, size_t cntbuf);
+
+
+#if defined __cplusplus
+};
+#endif
+
+#endif	// #ifndef __SIMDSUM_H_INCLUDED
@@ -0,0 +1,132 @@
+﻿#include <stddef.h>
+
+#include "simdsum.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <errno.h>
+	#include <sys/mman.h>
+#endif	// #if defined(_WIN32)
+
+
+//////////////////////////////////////////////////
+// 映射
+//////////////////////////////////////////////////
+
+// 将cb向上取整为cbalign的倍数. cbalign须为2的幂.
+#define SIMDSUM_ARENA_ROUND(cb, cbalign)	(((cb) + (cbalign)-1) & ~(size_t)((cbalign)-1))
+
+#if !defined(_WIN32)
+// 映射匿名内存, 首地址按 SIMDSUM_HUGEPAGE 对齐. 透明大页只用于对齐的2MB区间, 故多映射一个大页, 再解除首尾多余的部分.
+//
+// result: 返回首地址. 失败时返回NULL, 并设置errno.
+// cb: 字节数. 须为 SIMDSUM_HUGEPAGE 的倍数.
+static char* simdsum_arena_map(size_t cb)
+{
+	size_t cbhead;	// 首部多余的字节数.
+	char* p = (char*)mmap(NULL, cb + SIMDSUM_HUGEPAGE, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+	if (MAP_FAILED==(void*)p)	return NULL;
+	cbhead = (SIMDSUM_HUGEPAGE - ((size_t)p & (SIMDSUM_HUGEPAGE-1))) & (SIMDSUM_HUGEPAGE-1);
+	if (0!=cbhead)	munmap(p, cbhead);
+	munmap(p + cbhead + cb, SIMDSUM_HUGEPAGE - cbhead);
+	return p + cbhead;
+}
+#endif	// #if !defined(_WIN32)
+
+
+//////////////////////////////////////////////////
+// simdsum_arena: 大页内存区
+//////////////////////////////////////////////////
+
+int simdsum_arena_init(SIMDSUM_ARENA* pa, size_t cb, int page)
+{
+	char* p = NULL;
+	int kind = page;	// 实际的页面类型.
+#if defined(_WIN32)
+	SIZE_T cblarge;	// 大页大小.
+#endif	// #if defined(_WIN32)
+	pa->pbase = NULL;
+	pa->cb = 0;
+	pa->cbused = 0;
+	pa->page = SIMDSUM_PAGE_4K;
+	if (0==cb)	cb = 1;
+	cb = SIMDSUM_ARENA_ROUND(cb, SIMDSUM_HUGEPAGE);
+#if defined(_WIN32)
+	if (SIMDSUM_PAGE_HUGETLB==page)
+	{
+		cblarge = GetLargePageMinimum();
+		if (0!=cblarge)
+		{
+			p = (char*)VirtualAlloc(NULL, SIMDSUM_ARENA_ROUND(cb, cblarge), MEM_RESERVE|MEM_COMMIT|MEM_LARGE_PAGES, PAGE_READWRITE);
+			if (NULL!=p)	cb = SIMDSUM_ARENA_ROUND(cb, cblarge);
+		}
+	}
+	if (NULL==p)
+	{
+		kind = SIMDSUM_PAGE_4K;
+		p = (char*)VirtualAlloc(NULL, cb, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
+		if (NULL==p)	return (int)GetLastError();
+	}
+#else
+#ifdef MAP_HUGETLB
+	if (SIMDSUM_PAGE_HUGETLB==page)
+	{
+		p = (char*)mmap(NULL, cb, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+		if (MAP_FAILED==(void*)p)	p = NULL;	// 通常是没有预留大页.
+	}
+#endif	// #ifdef MAP_HUGETLB
+	if (NULL==p)
+	{
+		if (SIMDSUM_PAGE_HUGETLB==kind)	kind = SIMDSUM_PAGE_THP;
+		p = simdsum_arena_map(cb);
+		if (NULL==p)	return errno;
+#ifdef MADV_HUGEPAGE
+		if (SIMDSUM_PAGE_THP==kind && 0!=madvise(p, cb, MADV_HUGEPAGE))	kind = SIMDSUM_PAGE_4K;	// 内核未启用透明大页.
+#else
+		kind = SIMDSUM_PAGE_4K;
+#endif	// #ifdef MADV_HUGEPAGE
+#ifdef MADV_NOHUGEPAGE
+		// 透明大页设为always时, 普通的映射也会用大页.
+		if (SIMDSUM_PAGE_4K==page)	madvise(p, cb, MADV_NOHUGEPAGE);
+#endif	// #ifdef MADV_NOHUGEPAGE
+	}
+#endif	// #if defined(_WIN32)
+	pa->pbase = p;
+	pa->cb = cb;
+	pa->page = kind;
+	return 0;
+}
+
+void* simdsum_arena_alloc(SIMDSUM_ARENA* pa, size_t cb)
+{
+	size_t ofs = SIMDSUM_ARENA_ROUND(pa->cbused, SIMDSUM_ARENA_ALIGN);
+	if (ofs > pa->cb || cb > pa->cb - ofs)	return NULL;
+	pa->cbused = ofs + cb;
+	return pa->pbase + ofs;
+}
+
+void simdsum_arena_reset(SIMDSUM_ARENA* pa)
+{
+	pa->cbused = 0;
+}
+
+void simdsum_arena_free(SIMDSUM_ARENA* pa)
+{
+	if (NULL==pa->pbase)	return;
+#if defined(_WIN32)
+	VirtualFree(pa->pbase, 0, MEM_RELEASE);
+#else
+	munmap(pa->pbase, pa->cb);
+#endif	// #if defined(_WIN32)
+	pa->pbase = NULL;
+	pa->cb = 0;
+	pa->cbused = 0;
+}
+
+const char* simdsum_page_name(int page)
+{
+	static const char* const s_szName[] = {"4k", "thp", "hugetlb"};
+	if (page<SIMDSUM_PAGE_4K || page>SIMDSUM_PAGE_HUGETLB)	return "";
+	return s_szName[page];
+}
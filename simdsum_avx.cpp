@@ -0,0 +1,236 @@
+﻿#include "simdsum_kernel.hpp"
+
+
+//////////////////////////////////////////////////
+// sumfloat: 单精度浮点数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX
+// 单精度浮点数组求和_AVX版.
+float sumfloat_avx(const float* pbuf, size_t cntbuf)
+{
+	return sum_kernel<float, float, SIMDSUM_ISA_AVX, 1>(pbuf, cntbuf);
+}
+
+// 单精度浮点数组求和_AVX四路循环展开版.
+float sumfloat_avx_4loop(const float* pbuf, size_t cntbuf)
+{
+	return sum_kernel<float, float, SIMDSUM_ISA_AVX, 4>(pbuf, cntbuf);
+}
+
+// 单精度浮点数组求和_AVX预取版. 按预取距离用PREFETCHT0预取到各级缓存.
+float sumfloat_avx_pf(const float* pbuf, size_t cntbuf)
+{
+	return sum_kernel<float, float, SIMDSUM_ISA_AVX, 4, _MM_HINT_T0>(pbuf, cntbuf, simdsum_prefetch_dist(), simdsum_cacheline());
+}
+
+// 单精度浮点数组求和_AVX非临时预取版. 用PREFETCHNTA预取, 尽量不占用L2/L3.
+float sumfloat_avx_nta(const float* pbuf, size_t cntbuf)
+{
+	return sum_kernel<float, float, SIMDSUM_ISA_AVX, 4, _MM_HINT_NTA>(pbuf, cntbuf, simdsum_prefetch_dist(), simdsum_cacheline());
+}
+
+// 单精度浮点数组求和_AVX补偿求和版. 每个通道各有补偿变量, 四路循环展开以掩盖加法延迟.
+float sumfloat_kahan_avx(const float* pbuf, size_t cntbuf)
+{
+	return sum_kernel_kahan<float, SIMDSUM_ISA_AVX, 4>(pbuf, cntbuf);
+}
+#endif	// #ifdef INTRIN_AVX
+
+//////////////////////////////////////////////////
+// sumdouble: 双精度浮点数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX
+// 双精度浮点数组求和_AVX版.
+double sumdouble_avx(const double* pbuf, size_t cntbuf)
+{
+	return sum_kernel<double, double, SIMDSUM_ISA_AVX, 1>(pbuf, cntbuf);
+}
+
+// 双精度浮点数组求和_AVX四路循环展开版.
+double sumdouble_avx_4loop(const double* pbuf, size_t cntbuf)
+{
+	return sum_kernel<double, double, SIMDSUM_ISA_AVX, 4>(pbuf, cntbuf);
+}
+
+// 双精度浮点数组求和_AVX预取版. 按预取距离用PREFETCHT0预取到各级缓存.
+double sumdouble_avx_pf(const double* pbuf, size_t cntbuf)
+{
+	return sum_kernel<double, double, SIMDSUM_ISA_AVX, 4, _MM_HINT_T0>(pbuf, cntbuf, simdsum_prefetch_dist(), simdsum_cacheline());
+}
+
+// 双精度浮点数组求和_AVX非临时预取版. 用PREFETCHNTA预取, 尽量不占用L2/L3.
+double sumdouble_avx_nta(const double* pbuf, size_t cntbuf)
+{
+	return sum_kernel<double, double, SIMDSUM_ISA_AVX, 4, _MM_HINT_NTA>(pbuf, cntbuf, simdsum_prefetch_dist(), simdsum_cacheline());
+}
+
+// 双精度浮点数组求和_AVX补偿求和版. 每个通道各有补偿变量, 四路循环展开以掩盖加法延迟.
+double sumdouble_kahan_avx(const double* pbuf, size_t cntbuf)
+{
+	return sum_kernel_kahan<double, SIMDSUM_ISA_AVX, 4>(pbuf, cntbuf);
+}
+#endif	// #ifdef INTRIN_AVX
+
+//////////////////////////////////////////////////
+// sum_seg: 分段求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX
+// 单精度浮点数组分段求和_AVX版.
+void sumfloat_seg_avx(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums)
+{
+	sum_seg<float, float, SIMDSUM_ISA_AVX, 2>(pbuf, poffs, cntseg, psums);
+}
+
+// 双精度浮点数组分段求和_AVX版.
+void sumdouble_seg_avx(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums)
+{
+	sum_seg<double, double, SIMDSUM_ISA_AVX, 4>(pbuf, poffs, cntseg, psums);
+}
+#endif	// #ifdef INTRIN_AVX
+
+//////////////////////////////////////////////////
+// sum_stats: 单遍统计的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX
+// 32位整数数组统计_AVX版.
+void sumint_stats_avx(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	stats_kernel<int32_t, SIMDSUM_ISA_AVX, 2>(pbuf, cntbuf, pst);
+}
+
+// 单精度浮点数组统计_AVX版.
+void sumfloat_stats_avx(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	stats_kernel<float, SIMDSUM_ISA_AVX, 2>(pbuf, cntbuf, pst);
+}
+
+// 双精度浮点数组统计_AVX版.
+void sumdouble_stats_avx(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	stats_kernel<double, SIMDSUM_ISA_AVX, 2>(pbuf, cntbuf, pst);
+}
+#endif	// #ifdef INTRIN_AVX
+
+//////////////////////////////////////////////////
+// dot: 点积的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX
+// 单精度浮点点积_AVX四路循环展开版.
+float dotfloat_avx_4loop(const float* pa, const float* pb, size_t cntbuf)
+{
+	return dot_kernel<float, SIMDSUM_ISA_AVX, 4>(pa, pb, cntbuf);
+}
+
+// 单精度浮点点积_AVX八路循环展开版.
+float dotfloat_avx_8loop(const float* pa, const float* pb, size_t cntbuf)
+{
+	return dot_kernel<float, SIMDSUM_ISA_AVX, 8>(pa, pb, cntbuf);
+}
+
+// 双精度浮点点积_AVX四路循环展开版.
+double dotdouble_avx_4loop(const double* pa, const double* pb, size_t cntbuf)
+{
+	return dot_kernel<double, SIMDSUM_ISA_AVX, 4>(pa, pb, cntbuf);
+}
+
+// 双精度浮点点积_AVX八路循环展开版.
+double dotdouble_avx_8loop(const double* pa, const double* pb, size_t cntbuf)
+{
+	return dot_kernel<double, SIMDSUM_ISA_AVX, 8>(pa, pb, cntbuf);
+}
+#endif	// #ifdef INTRIN_AVX
+
+//////////////////////////////////////////////////
+// sum_stride: 结构体数组中某个字段求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX
+// 单精度浮点字段求和_AVX版. 步长为4、8、16、32字节时按向量处理.
+float sumfloat_stride_avx(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	return sum_stride<float, SIMDSUM_ISA_AVX, false>(pbase, cntrec, cbstride, cboffset);
+}
+
+// 双精度浮点字段求和_AVX版. 步长为8、16、32字节时按向量处理.
+double sumdouble_stride_avx(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	return sum_stride<double, SIMDSUM_ISA_AVX, false>(pbase, cntrec, cbstride, cboffset);
+}
+#endif	// #ifdef INTRIN_AVX
+
+//////////////////////////////////////////////////
+// sum_where: 条件求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX
+// 单精度浮点数组条件求和_AVX版. 四路循环展开.
+float sumfloat_where_avx(const float* pval, const float* pkey, size_t cntbuf, float lo, float hi, int flags)
+{
+	return sum_where<float, SIMDSUM_ISA_AVX, 4>(pval, pkey, cntbuf, lo, hi, flags);
+}
+
+// 双精度浮点数组条件求和_AVX版. 四路循环展开.
+double sumdouble_where_avx(const double* pval, const double* pkey, size_t cntbuf, double lo, double hi, int flags)
+{
+	return sum_where<double, SIMDSUM_ISA_AVX, 4>(pval, pkey, cntbuf, lo, hi, flags);
+}
+#endif	// #ifdef INTRIN_AVX
+
+//////////////////////////////////////////////////
+// sum_nan: 跳过NaN求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX
+// 单精度浮点数组跳过NaN求和_AVX版.
+float sumfloat_nan_avx(const float* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	return sum_nan<float, SIMDSUM_ISA_AVX, 1>(pbuf, cntbuf, pcnt);
+}
+
+// 单精度浮点数组跳过NaN求和_AVX四路循环展开版.
+float sumfloat_nan_avx_4loop(const float* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	return sum_nan<float, SIMDSUM_ISA_AVX, 4>(pbuf, cntbuf, pcnt);
+}
+
+// 双精度浮点数组跳过NaN求和_AVX版.
+double sumdouble_nan_avx(const double* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	return sum_nan<double, SIMDSUM_ISA_AVX, 1>(pbuf, cntbuf, pcnt);
+}
+
+// 双精度浮点数组跳过NaN求和_AVX四路循环展开版.
+double sumdouble_nan_avx_4loop(const double* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	return sum_nan<double, SIMDSUM_ISA_AVX, 4>(pbuf, cntbuf, pcnt);
+}
+#endif	// #ifdef INTRIN_AVX
+
+//////////////////////////////////////////////////
+// stream: STREAM式带宽基准的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX
+// 只读_AVX版.
+uint64_t stream_read_avx(const double* pbuf, size_t cntbuf)
+{
+	return stream_read<SIMDSUM_ISA_AVX, 4>(pbuf, cntbuf);
+}
+
+// 复制_AVX版.
+void stream_copy_avx(double* pdst, const double* psrc, size_t cntbuf)
+{
+	stream_copy<SIMDSUM_ISA_AVX, 4>(pdst, psrc, cntbuf);
+}
+
+// 三元组_AVX版.
+void stream_triad_avx(double* pa, const double* pb, const double* pc, double s, size_t cntbuf)
+{
+	stream_triad<SIMDSUM_ISA_AVX, 4>(pa, pb, pc, s, cntbuf);
+}
+#endif	// #ifdef INTRIN_AVX
@@ -0,0 +1,297 @@
+﻿#include "simdsum_kernel.hpp"
+
+
+//////////////////////////////////////////////////
+// sumint: 32位整数数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX2
+// 32位整数数组求和_AVX2版.
+int32_t sumint_avx2(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int32_t, SIMDSUM_ISA_AVX2, 1>(pbuf, cntbuf);
+}
+
+// 32位整数数组求和_AVX2四路循环展开版.
+int32_t sumint_avx2_4loop(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int32_t, SIMDSUM_ISA_AVX2, 4>(pbuf, cntbuf);
+}
+
+// 32位整数数组求和_AVX2预取版. 按预取距离用PREFETCHT0预取到各级缓存.
+int32_t sumint_avx2_pf(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int32_t, SIMDSUM_ISA_AVX2, 4, _MM_HINT_T0>(pbuf, cntbuf, simdsum_prefetch_dist(), simdsum_cacheline());
+}
+
+// 32位整数数组求和_AVX2非临时预取版. 用PREFETCHNTA预取, 尽量不占用L2/L3.
+int32_t sumint_avx2_nta(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int32_t, SIMDSUM_ISA_AVX2, 4, _MM_HINT_NTA>(pbuf, cntbuf, simdsum_prefetch_dist(), simdsum_cacheline());
+}
+#endif	// #ifdef INTRIN_AVX2
+
+//////////////////////////////////////////////////
+// sumint_wide: 32位整数数组求和_64位结果的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX2
+// 每段的最大块数. 段内各通道的高16位之和、低16位之和均不会溢出32位（合并4个累加器之后也不会）.
+#define SUMINT_WIDE_FLUSH	16384
+
+// 将一段的32位累加结果转为64位.
+// ySum为各通道int32_t的环绕和, yHigh为各通道 (x>>16) 之和（算术右移）.
+// 因 x = (x>>16)*65536 + (x&0xFFFF), 故低16位之和等于 ySum - (yHigh<<16), 它不超过32位无符号数的范围, 环绕减法的结果即为准确值.
+static __m256i sumint_wide_flush_avx2(__m256i ySum, __m256i yHigh)
+{
+	__m256i yLow = _mm256_sub_epi32(ySum, _mm256_slli_epi32(yHigh, 16));	// 低16位之和. 无符号.
+	__m256i yiqLow = _mm256_add_epi64(_mm256_cvtepu32_epi64(_mm256_castsi256_si128(yLow)), _mm256_cvtepu32_epi64(_mm256_extracti128_si256(yLow, 1)));	// [AVX2] VPMOVZXDQ. 零扩展.
+	__m256i yiqHigh = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(yHigh)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(yHigh, 1)));	// [AVX2] VPMOVSXDQ. 符号扩展.
+	return _mm256_add_epi64(yiqLow, _mm256_slli_epi64(yiqHigh, 16));
+}
+
+// 32位整数数组求和_64位结果_AVX2版. 分段换算的算法不适合通用模板, 故手写.
+// 内循环只做32位加法: 一路累加int32_t本身（环绕）, 一路累加其高16位. 每段结束时再换算为64位, 避免了逐个符号扩展的混洗指令.
+int64_t sumint_wide_avx2(const int32_t* pbuf, size_t cntbuf)
+{
+	int64_t s = 0;	// 求和变量.
+	size_t i;
+	size_t nBlockWidth = 8*4;	// 块宽. AVX寄存器能一次处理8个int32_t，然后循环展开4次.
+	size_t cntHead = SIMDSUM_HEADCNT(pbuf, cntbuf, 32);	// 开头未对齐的数量.
+	size_t cntBlock = (cntbuf-cntHead) / nBlockWidth;	// 块数.
+	size_t cntRem = (cntbuf-cntHead) % nBlockWidth;	// 剩余数量.
+	size_t cntSeg;	// 本段的块数.
+	__m256i yidSum, yidSum1, yidSum2, yidSum3;	// 求和变量. 32位环绕和.
+	__m256i yidHigh, yidHigh1, yidHigh2, yidHigh3;	// 高16位之和.
+	__m256i yidLoad, yidLoad1, yidLoad2, yidLoad3;	// 加载.
+	__m256i yiqTotal = _mm256_setzero_si256();	// 64位总和.
+	const __m256i* p = (const __m256i*)(pbuf+cntHead);	// AVX批量处理时所用的指针.
+	const int32_t* q;	// 单个数据处理时所用指针.
+	const int64_t* r;	// 将AVX变量上的多个数值合并时所用指针.
+
+	// AVX批量处理. 分段进行.
+	while(cntBlock>0)
+	{
+		cntSeg = (cntBlock<SUMINT_WIDE_FLUSH) ? cntBlock : SUMINT_WIDE_FLUSH;
+		cntBlock -= cntSeg;
+		yidSum = yidSum1 = yidSum2 = yidSum3 = _mm256_setzero_si256();
+		yidHigh = yidHigh1 = yidHigh2 = yidHigh3 = _mm256_setzero_si256();
+		for(i=0; i<cntSeg; ++i)
+		{
+			yidLoad = _mm256_loadu_si256(p);	// [AVX] VMOVDQU. 加载.
+			yidLoad1 = _mm256_loadu_si256(p+1);
+			yidLoad2 = _mm256_loadu_si256(p+2);
+			yidLoad3 = _mm256_loadu_si256(p+3);
+			yidSum = _mm256_add_epi32(yidSum, yidLoad);	// [AVX2] VPADDD. 32位整数紧缩环绕加法.
+			yidSum1 = _mm256_add_epi32(yidSum1, yidLoad1);
+			yidSum2 = _mm256_add_epi32(yidSum2, yidLoad2);
+			yidSum3 = _mm256_add_epi32(yidSum3, yidLoad3);
+			yidHigh = _mm256_add_epi32(yidHigh, _mm256_srai_epi32(yidLoad, 16));	// [AVX2] VPSRAD. 算术右移.
+			yidHigh1 = _mm256_add_epi32(yidHigh1, _mm256_srai_epi32(yidLoad1, 16));
+			yidHigh2 = _mm256_add_epi32(yidHigh2, _mm256_srai_epi32(yidLoad2, 16));
+			yidHigh3 = _mm256_add_epi32(yidHigh3, _mm256_srai_epi32(yidLoad3, 16));
+			p += 4;	// 四路循环展开.
+		}
+		// 合并本段, 并转为64位.
+		yidSum = _mm256_add_epi32(_mm256_add_epi32(yidSum, yidSum1), _mm256_add_epi32(yidSum2, yidSum3));
+		yidHigh = _mm256_add_epi32(_mm256_add_epi32(yidHigh, yidHigh1), _mm256_add_epi32(yidHigh2, yidHigh3));
+		yiqTotal = _mm256_add_epi64(yiqTotal, sumint_wide_flush_avx2(yidSum, yidHigh));
+	}
+	// 合并.
+	r = (const int64_t*)&yiqTotal;
+	s = r[0] + r[1] + r[2] + r[3];
+
+	// 处理开头未对齐的.
+	for(i=0; i<cntHead; ++i)
+	{
+		s += pbuf[i];
+	}
+
+	// 处理剩下的.
+	q = (const int32_t*)p;
+	for(i=0; i<cntRem; ++i)
+	{
+		s += q[i];
+	}
+
+	return s;
+}
+
+// 32位整数数组求和_64位结果_AVX2符号扩展版. 用VPMOVSXDQ逐个符号扩展, 用于和分段版对比.
+int64_t sumint_wide_avx2_movsx(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int64_t, SIMDSUM_ISA_AVX2, 4>(pbuf, cntbuf);
+}
+#endif	// #ifdef INTRIN_AVX2
+
+//////////////////////////////////////////////////
+// sum_seg: 分段求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX2
+// 32位整数数组分段求和_AVX2版.
+void sumint_seg_avx2(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums)
+{
+	sum_seg<int32_t, int32_t, SIMDSUM_ISA_AVX2, 2>(pbuf, poffs, cntseg, psums);
+}
+#endif	// #ifdef INTRIN_AVX2
+
+//////////////////////////////////////////////////
+// scan: 前缀和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX2
+// 32位整数前缀和_AVX2版.
+int32_t scanint_avx2(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl)
+{
+	if (excl)	return scan_kernel<int32_t, SIMDSUM_ISA_AVX2, true>(pdst, psrc, cntbuf, init);
+	return scan_kernel<int32_t, SIMDSUM_ISA_AVX2, false>(pdst, psrc, cntbuf, init);
+}
+
+// 64位整数前缀和_AVX2版.
+int64_t scanint64_avx2(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl)
+{
+	if (excl)	return scan_kernel<int64_t, SIMDSUM_ISA_AVX2, true>(pdst, psrc, cntbuf, init);
+	return scan_kernel<int64_t, SIMDSUM_ISA_AVX2, false>(pdst, psrc, cntbuf, init);
+}
+
+// 单精度浮点前缀和_AVX2版.
+float scanfloat_avx2(float* pdst, const float* psrc, size_t cntbuf, float init, int excl)
+{
+	if (excl)	return scan_kernel<float, SIMDSUM_ISA_AVX2, true>(pdst, psrc, cntbuf, init);
+	return scan_kernel<float, SIMDSUM_ISA_AVX2, false>(pdst, psrc, cntbuf, init);
+}
+
+// 双精度浮点前缀和_AVX2版.
+double scandouble_avx2(double* pdst, const double* psrc, size_t cntbuf, double init, int excl)
+{
+	if (excl)	return scan_kernel<double, SIMDSUM_ISA_AVX2, true>(pdst, psrc, cntbuf, init);
+	return scan_kernel<double, SIMDSUM_ISA_AVX2, false>(pdst, psrc, cntbuf, init);
+}
+#endif	// #ifdef INTRIN_AVX2
+
+//////////////////////////////////////////////////
+// sum_stride: 结构体数组中某个字段求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX2
+// 32位整数字段求和_AVX2版. 步长整除32字节时按向量处理, 其他小于缓存行的步长用VPGATHERDD.
+int32_t sumint_stride_avx2(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	return sum_stride<int32_t, SIMDSUM_ISA_AVX2, true>(pbase, cntrec, cbstride, cboffset);
+}
+
+// 单精度浮点字段求和_AVX2版. 按向量处理时只用AVX的浮点加法, 其他小于缓存行的步长用VGATHERDPS.
+float sumfloat_stride_avx2(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	return sum_stride<float, SIMDSUM_ISA_AVX, true>(pbase, cntrec, cbstride, cboffset);
+}
+
+// 双精度浮点字段求和_AVX2版. 其他小于缓存行的步长用VGATHERDPD.
+double sumdouble_stride_avx2(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	return sum_stride<double, SIMDSUM_ISA_AVX, true>(pbase, cntrec, cbstride, cboffset);
+}
+#endif	// #ifdef INTRIN_AVX2
+
+//////////////////////////////////////////////////
+// sumbf16: bfloat16数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX2
+// bfloat16数组求和_AVX2版.
+float sumbf16_avx2(const uint16_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<bf16_t, float, SIMDSUM_ISA_AVX2, 1>((const bf16_t*)pbuf, cntbuf);
+}
+
+// bfloat16数组求和_AVX2四路循环展开版.
+float sumbf16_avx2_4loop(const uint16_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<bf16_t, float, SIMDSUM_ISA_AVX2, 4>((const bf16_t*)pbuf, cntbuf);
+}
+#endif	// #ifdef INTRIN_AVX2
+
+//////////////////////////////////////////////////
+// sumuint8, sumint8, sumint16: 窄整数数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX2
+// 无符号8位整数数组求和_AVX2版. 用VPSADBW.
+uint64_t sumuint8_avx2(const uint8_t* pbuf, size_t cntbuf)
+{
+	return sum_narrow<uint8_t, uint64_t, SIMDSUM_ISA_AVX2, 1>(pbuf, cntbuf);
+}
+
+// 无符号8位整数数组求和_AVX2四路循环展开版.
+uint64_t sumuint8_avx2_4loop(const uint8_t* pbuf, size_t cntbuf)
+{
+	return sum_narrow<uint8_t, uint64_t, SIMDSUM_ISA_AVX2, 4>(pbuf, cntbuf);
+}
+
+// 有符号8位整数数组求和_AVX2版.
+int64_t sumint8_avx2(const int8_t* pbuf, size_t cntbuf)
+{
+	return sum_narrow<int8_t, int64_t, SIMDSUM_ISA_AVX2, 1>(pbuf, cntbuf);
+}
+
+// 有符号8位整数数组求和_AVX2四路循环展开版.
+int64_t sumint8_avx2_4loop(const int8_t* pbuf, size_t cntbuf)
+{
+	return sum_narrow<int8_t, int64_t, SIMDSUM_ISA_AVX2, 4>(pbuf, cntbuf);
+}
+
+// 有符号16位整数数组求和_AVX2版. 用VPMADDWD, 每段结束时以VPMOVSXDQ扩展.
+int64_t sumint16_avx2(const int16_t* pbuf, size_t cntbuf)
+{
+	return sum_narrow<int16_t, int64_t, SIMDSUM_ISA_AVX2, 1>(pbuf, cntbuf);
+}
+
+// 有符号16位整数数组求和_AVX2四路循环展开版.
+int64_t sumint16_avx2_4loop(const int16_t* pbuf, size_t cntbuf)
+{
+	return sum_narrow<int16_t, int64_t, SIMDSUM_ISA_AVX2, 4>(pbuf, cntbuf);
+}
+#endif	// #ifdef INTRIN_AVX2
+
+//////////////////////////////////////////////////
+// sumint64, sumuint64: 64位整数数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX2
+// 64位整数数组求和_AVX2版.
+int64_t sumint64_avx2(const int64_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int64_t, int64_t, SIMDSUM_ISA_AVX2, 1>(pbuf, cntbuf);
+}
+
+// 64位整数数组求和_AVX2四路循环展开版.
+int64_t sumint64_avx2_4loop(const int64_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int64_t, int64_t, SIMDSUM_ISA_AVX2, 4>(pbuf, cntbuf);
+}
+
+// 无符号64位整数数组求和_AVX2版. 用VPCMPGTQ检测进位.
+uint64_t sumuint64_avx2(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry)
+{
+	return sum_carry<SIMDSUM_ISA_AVX2, 1>(pbuf, cntbuf, pcarry);
+}
+
+// 无符号64位整数数组求和_AVX2四路循环展开版.
+uint64_t sumuint64_avx2_4loop(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry)
+{
+	return sum_carry<SIMDSUM_ISA_AVX2, 4>(pbuf, cntbuf, pcarry);
+}
+#endif	// #ifdef INTRIN_AVX2
+
+//////////////////////////////////////////////////
+// sum_where: 条件求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX2
+// 32位整数数组条件求和_AVX2版. 四路循环展开.
+int32_t sumint_where_avx2(const int32_t* pval, const int32_t* pkey, size_t cntbuf, int32_t lo, int32_t hi, int flags)
+{
+	return sum_where<int32_t, SIMDSUM_ISA_AVX2, 4>(pval, pkey, cntbuf, lo, hi, flags);
+}
+#endif	// #ifdef INTRIN_AVX2
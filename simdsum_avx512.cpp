@@ -0,0 +1,224 @@
+﻿#include "simdsum_kernel.hpp"
+
+
+//////////////////////////////////////////////////
+// sumint: 32位整数数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX512F
+// 32位整数数组求和_AVX-512版. 未对齐的开头与剩余部分都用掩码加载处理, 不再逐个处理.
+int32_t sumint_avx512(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int32_t, SIMDSUM_ISA_AVX512, 1>(pbuf, cntbuf);
+}
+
+// 32位整数数组求和_AVX-512四路循环展开版.
+int32_t sumint_avx512_4loop(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int32_t, SIMDSUM_ISA_AVX512, 4>(pbuf, cntbuf);
+}
+
+// 32位整数数组求和_AVX-512预取版. 按预取距离用PREFETCHT0预取到各级缓存.
+int32_t sumint_avx512_pf(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int32_t, SIMDSUM_ISA_AVX512, 4, _MM_HINT_T0>(pbuf, cntbuf, simdsum_prefetch_dist(), simdsum_cacheline());
+}
+
+// 32位整数数组求和_AVX-512非临时预取版. 用PREFETCHNTA预取, 尽量不占用L2/L3.
+int32_t sumint_avx512_nta(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int32_t, SIMDSUM_ISA_AVX512, 4, _MM_HINT_NTA>(pbuf, cntbuf, simdsum_prefetch_dist(), simdsum_cacheline());
+}
+#endif	// #ifdef INTRIN_AVX512F
+
+//////////////////////////////////////////////////
+// sumfloat: 单精度浮点数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX512F
+// 单精度浮点数组求和_AVX-512版. 未对齐的开头与剩余部分都用掩码加载处理, 不再逐个处理.
+float sumfloat_avx512(const float* pbuf, size_t cntbuf)
+{
+	return sum_kernel<float, float, SIMDSUM_ISA_AVX512, 1>(pbuf, cntbuf);
+}
+
+// 单精度浮点数组求和_AVX-512四路循环展开版.
+float sumfloat_avx512_4loop(const float* pbuf, size_t cntbuf)
+{
+	return sum_kernel<float, float, SIMDSUM_ISA_AVX512, 4>(pbuf, cntbuf);
+}
+
+// 单精度浮点数组求和_AVX-512预取版. 按预取距离用PREFETCHT0预取到各级缓存.
+float sumfloat_avx512_pf(const float* pbuf, size_t cntbuf)
+{
+	return sum_kernel<float, float, SIMDSUM_ISA_AVX512, 4, _MM_HINT_T0>(pbuf, cntbuf, simdsum_prefetch_dist(), simdsum_cacheline());
+}
+
+// 单精度浮点数组求和_AVX-512非临时预取版. 用PREFETCHNTA预取, 尽量不占用L2/L3.
+float sumfloat_avx512_nta(const float* pbuf, size_t cntbuf)
+{
+	return sum_kernel<float, float, SIMDSUM_ISA_AVX512, 4, _MM_HINT_NTA>(pbuf, cntbuf, simdsum_prefetch_dist(), simdsum_cacheline());
+}
+#endif	// #ifdef INTRIN_AVX512F
+
+//////////////////////////////////////////////////
+// sumdouble: 双精度浮点数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX512F
+// 双精度浮点数组求和_AVX-512版. 未对齐的开头与剩余部分都用掩码加载处理, 不再逐个处理.
+double sumdouble_avx512(const double* pbuf, size_t cntbuf)
+{
+	return sum_kernel<double, double, SIMDSUM_ISA_AVX512, 1>(pbuf, cntbuf);
+}
+
+// 双精度浮点数组求和_AVX-512四路循环展开版.
+double sumdouble_avx512_4loop(const double* pbuf, size_t cntbuf)
+{
+	return sum_kernel<double, double, SIMDSUM_ISA_AVX512, 4>(pbuf, cntbuf);
+}
+
+// 双精度浮点数组求和_AVX-512预取版. 按预取距离用PREFETCHT0预取到各级缓存.
+double sumdouble_avx512_pf(const double* pbuf, size_t cntbuf)
+{
+	return sum_kernel<double, double, SIMDSUM_ISA_AVX512, 4, _MM_HINT_T0>(pbuf, cntbuf, simdsum_prefetch_dist(), simdsum_cacheline());
+}
+
+// 双精度浮点数组求和_AVX-512非临时预取版. 用PREFETCHNTA预取, 尽量不占用L2/L3.
+double sumdouble_avx512_nta(const double* pbuf, size_t cntbuf)
+{
+	return sum_kernel<double, double, SIMDSUM_ISA_AVX512, 4, _MM_HINT_NTA>(pbuf, cntbuf, simdsum_prefetch_dist(), simdsum_cacheline());
+}
+#endif	// #ifdef INTRIN_AVX512F
+
+//////////////////////////////////////////////////
+// sumhalf, sumbf16: 16位浮点数组求和的函数
+//////////////////////////////////////////////////
+
+#if defined(INTRIN_AVX512F) && defined(INTRIN_AVX512BW)
+// 半精度浮点数组求和_AVX-512版. 一次转换16个. 开头与剩余部分用按16位屏蔽的掩码加载.
+float sumhalf_avx512(const uint16_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<half_t, float, SIMDSUM_ISA_AVX512, 1>((const half_t*)pbuf, cntbuf);
+}
+
+// 半精度浮点数组求和_AVX-512四路循环展开版.
+float sumhalf_avx512_4loop(const uint16_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<half_t, float, SIMDSUM_ISA_AVX512, 4>((const half_t*)pbuf, cntbuf);
+}
+
+// bfloat16数组求和_AVX-512版. 每次加载32个.
+float sumbf16_avx512(const uint16_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<bf16_t, float, SIMDSUM_ISA_AVX512, 1>((const bf16_t*)pbuf, cntbuf);
+}
+
+// bfloat16数组求和_AVX-512四路循环展开版.
+float sumbf16_avx512_4loop(const uint16_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<bf16_t, float, SIMDSUM_ISA_AVX512, 4>((const bf16_t*)pbuf, cntbuf);
+}
+#endif	// #if defined(INTRIN_AVX512F) && defined(INTRIN_AVX512BW)
+
+//////////////////////////////////////////////////
+// sumint64, sumuint64: 64位整数数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX512F
+// 64位整数数组求和_AVX-512版. 开头与剩余部分用掩码加载.
+int64_t sumint64_avx512(const int64_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int64_t, int64_t, SIMDSUM_ISA_AVX512, 1>(pbuf, cntbuf);
+}
+
+// 64位整数数组求和_AVX-512四路循环展开版.
+int64_t sumint64_avx512_4loop(const int64_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int64_t, int64_t, SIMDSUM_ISA_AVX512, 4>(pbuf, cntbuf);
+}
+
+// 无符号64位整数数组求和_AVX-512版. VPCMPUQ得到进位掩码, 按掩码给计数加1.
+uint64_t sumuint64_avx512(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry)
+{
+	return sum_carry<SIMDSUM_ISA_AVX512, 1>(pbuf, cntbuf, pcarry);
+}
+
+// 无符号64位整数数组求和_AVX-512四路循环展开版.
+uint64_t sumuint64_avx512_4loop(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry)
+{
+	return sum_carry<SIMDSUM_ISA_AVX512, 4>(pbuf, cntbuf, pcarry);
+}
+#endif	// #ifdef INTRIN_AVX512F
+
+//////////////////////////////////////////////////
+// sum_seg: 分段求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX512F
+// 32位整数数组分段求和_AVX-512版. 段尾用掩码加载, 不必回退到逐个处理.
+void sumint_seg_avx512(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums)
+{
+	sum_seg<int32_t, int32_t, SIMDSUM_ISA_AVX512, 2>(pbuf, poffs, cntseg, psums);
+}
+
+// 单精度浮点数组分段求和_AVX-512版.
+void sumfloat_seg_avx512(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums)
+{
+	sum_seg<float, float, SIMDSUM_ISA_AVX512, 2>(pbuf, poffs, cntseg, psums);
+}
+
+// 双精度浮点数组分段求和_AVX-512版.
+void sumdouble_seg_avx512(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums)
+{
+	sum_seg<double, double, SIMDSUM_ISA_AVX512, 4>(pbuf, poffs, cntseg, psums);
+}
+#endif	// #ifdef INTRIN_AVX512F
+
+//////////////////////////////////////////////////
+// sum_stats: 单遍统计的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX512F
+// 32位整数数组统计_AVX-512版.
+void sumint_stats_avx512(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	stats_kernel<int32_t, SIMDSUM_ISA_AVX512, 4>(pbuf, cntbuf, pst);
+}
+
+// 单精度浮点数组统计_AVX-512版.
+void sumfloat_stats_avx512(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	stats_kernel<float, SIMDSUM_ISA_AVX512, 4>(pbuf, cntbuf, pst);
+}
+
+// 双精度浮点数组统计_AVX-512版.
+void sumdouble_stats_avx512(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	stats_kernel<double, SIMDSUM_ISA_AVX512, 4>(pbuf, cntbuf, pst);
+}
+#endif	// #ifdef INTRIN_AVX512F
+
+//////////////////////////////////////////////////
+// stream: STREAM式带宽基准的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_AVX512F
+// 只读_AVX-512版.
+uint64_t stream_read_avx512(const double* pbuf, size_t cntbuf)
+{
+	return stream_read<SIMDSUM_ISA_AVX512, 4>(pbuf, cntbuf);
+}
+
+// 复制_AVX-512版.
+void stream_copy_avx512(double* pdst, const double* psrc, size_t cntbuf)
+{
+	stream_copy<SIMDSUM_ISA_AVX512, 4>(pdst, psrc, cntbuf);
+}
+
+// 三元组_AVX-512版.
+void stream_triad_avx512(double* pa, const double* pb, const double* pc, double s, size_t cntbuf)
+{
+	stream_triad<SIMDSUM_ISA_AVX512, 4>(pa, pb, pc, s, cntbuf);
+}
+#endif	// #ifdef INTRIN_AVX512F
@@ -0,0 +1,740 @@
+﻿#include <string.h>
+
+#include "simdsum.h"
+
+
+//////////////////////////////////////////////////
+// sumint: 32位整数数组求和的函数
+//////////////////////////////////////////////////
+
+// 32位整数数组求和_基本版.
+//
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+int32_t sumint_base(const int32_t* pbuf, size_t cntbuf)
+{
+	int32_t s = 0;	// 求和变量.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += pbuf[i];
+	}
+	return s;
+}
+
+//////////////////////////////////////////////////
+// sumint_wide: 32位整数数组求和_64位结果的函数
+//////////////////////////////////////////////////
+
+// 32位整数数组求和_64位结果_基本版.
+//
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+int64_t sumint_wide_base(const int32_t* pbuf, size_t cntbuf)
+{
+	int64_t s = 0;	// 求和变量.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += pbuf[i];
+	}
+	return s;
+}
+
+//////////////////////////////////////////////////
+// sumfloat: 单精度浮点数组求和的函数
+//////////////////////////////////////////////////
+
+// 单精度浮点数组求和_基本版.
+//
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+float sumfloat_base(const float* pbuf, size_t cntbuf)
+{
+	float s = 0;	// 求和变量.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += pbuf[i];
+	}
+	return s;
+}
+
+// 单精度浮点数组求和_补偿求和基本版.
+// 用TwoSum算法求出每次加法的精确舍入误差并累加到补偿变量, 最后再加回.
+// 精度与Kahan-Neumaier算法相当, 但误差与两个加数的大小关系无关, 不需要比较与选择, 便于SIMD化.
+float sumfloat_kahan_base(const float* pbuf, size_t cntbuf)
+{
+	float s = 0;	// 求和变量.
+	float c = 0;	// 补偿变量. 累积舍入误差.
+	float t;	// 新的和.
+	float bp;	// 加数中实际被加上的部分.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		t = s + pbuf[i];
+		bp = t - s;
+		c += (s - (t - bp)) + (pbuf[i] - bp);
+		s = t;
+	}
+	return s + c;
+}
+
+//////////////////////////////////////////////////
+// sumdouble: 双精度浮点数组求和的函数
+//////////////////////////////////////////////////
+
+// 双精度浮点数组求和_基本版.
+//
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+double sumdouble_base(const double* pbuf, size_t cntbuf)
+{
+	double s = 0;	// 求和变量.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += pbuf[i];
+	}
+	return s;
+}
+
+// 双精度浮点数组求和_补偿求和基本版.
+double sumdouble_kahan_base(const double* pbuf, size_t cntbuf)
+{
+	double s = 0;	// 求和变量.
+	double c = 0;	// 补偿变量. 累积舍入误差.
+	double t;	// 新的和.
+	double bp;	// 加数中实际被加上的部分.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		t = s + pbuf[i];
+		bp = t - s;
+		c += (s - (t - bp)) + (pbuf[i] - bp);
+		s = t;
+	}
+	return s + c;
+}
+
+//////////////////////////////////////////////////
+// sum_seg: 分段求和的函数
+//////////////////////////////////////////////////
+
+// 32位整数数组分段求和_基本版.
+//
+// pbuf: 数值数组.
+// poffs: 偏移数组. 第i段为 pbuf[poffs[i]] ~ pbuf[poffs[i+1]-1].
+// cntseg: 段数.
+// psums: 返回各段之和.
+void sumint_seg_base(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums)
+{
+	size_t i;
+	for(i=0; i<cntseg; ++i)
+	{
+		psums[i] = sumint_base(pbuf + poffs[i], poffs[i+1] - poffs[i]);
+	}
+}
+
+// 单精度浮点数组分段求和_基本版.
+void sumfloat_seg_base(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums)
+{
+	size_t i;
+	for(i=0; i<cntseg; ++i)
+	{
+		psums[i] = sumfloat_base(pbuf + poffs[i], poffs[i+1] - poffs[i]);
+	}
+}
+
+// 双精度浮点数组分段求和_基本版.
+void sumdouble_seg_base(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums)
+{
+	size_t i;
+	for(i=0; i<cntseg; ++i)
+	{
+		psums[i] = sumdouble_base(pbuf + poffs[i], poffs[i+1] - poffs[i]);
+	}
+}
+
+//////////////////////////////////////////////////
+// sum_stats: 单遍统计的函数
+//////////////////////////////////////////////////
+
+// 32位整数数组统计_基本版.
+// 以第一个元素K为原点累加 x-K 与 (x-K)², 再由 simdsum_stats_set 求出和与平方和.
+//
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+// pst: 返回统计量.
+void sumint_stats_base(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	double k, x, d;
+	double s = 0;	// Σ(x-K).
+	double q = 0;	// Σ(x-K)².
+	double xmin, xmax;
+	size_t i;
+	if (0==cntbuf)
+	{
+		simdsum_stats_init(pst);
+		return;
+	}
+	k = xmin = xmax = (double)pbuf[0];
+	for(i=0; i<cntbuf; ++i)
+	{
+		x = (double)pbuf[i];
+		d = x - k;
+		s += d;
+		q += d*d;
+		if (x < xmin)	xmin = x;
+		if (x > xmax)	xmax = x;
+	}
+	simdsum_stats_set(pst, cntbuf, k, s, q, xmin, xmax);
+}
+
+// 单精度浮点数组统计_基本版.
+void sumfloat_stats_base(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	double k, x, d;
+	double s = 0;	// Σ(x-K).
+	double q = 0;	// Σ(x-K)².
+	double xmin, xmax;
+	size_t i;
+	if (0==cntbuf)
+	{
+		simdsum_stats_init(pst);
+		return;
+	}
+	k = xmin = xmax = (double)pbuf[0];
+	for(i=0; i<cntbuf; ++i)
+	{
+		x = (double)pbuf[i];
+		d = x - k;
+		s += d;
+		q += d*d;
+		if (x < xmin)	xmin = x;
+		if (x > xmax)	xmax = x;
+	}
+	simdsum_stats_set(pst, cntbuf, k, s, q, xmin, xmax);
+}
+
+// 双精度浮点数组统计_基本版.
+void sumdouble_stats_base(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	double k, x, d;
+	double s = 0;	// Σ(x-K).
+	double q = 0;	// Σ(x-K)².
+	double xmin, xmax;
+	size_t i;
+	if (0==cntbuf)
+	{
+		simdsum_stats_init(pst);
+		return;
+	}
+	k = xmin = xmax = (double)pbuf[0];
+	for(i=0; i<cntbuf; ++i)
+	{
+		x = (double)pbuf[i];
+		d = x - k;
+		s += d;
+		q += d*d;
+		if (x < xmin)	xmin = x;
+		if (x > xmax)	xmax = x;
+	}
+	simdsum_stats_set(pst, cntbuf, k, s, q, xmin, xmax);
+}
+
+//////////////////////////////////////////////////
+// dot: 点积的函数
+//////////////////////////////////////////////////
+
+// 单精度浮点点积_基本版.
+//
+// result: 返回点积.
+// pa, pb: 两个数组的首地址.
+// cntbuf: 数组长度.
+float dotfloat_base(const float* pa, const float* pb, size_t cntbuf)
+{
+	float s = 0;	// 求和变量.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += pa[i] * pb[i];
+	}
+	return s;
+}
+
+// 双精度浮点点积_基本版.
+double dotdouble_base(const double* pa, const double* pb, size_t cntbuf)
+{
+	double s = 0;	// 求和变量.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += pa[i] * pb[i];
+	}
+	return s;
+}
+
+//////////////////////////////////////////////////
+// scan: 前缀和的函数
+//////////////////////////////////////////////////
+
+// 32位整数前缀和_基本版.
+//
+// result: 返回 init 加上全部元素之和.
+// pdst: 返回前缀和. 可以等于psrc.
+// psrc: 源数组.
+// cntbuf: 数组长度.
+// init: 初值.
+// excl: 非0表示不含自身.
+int32_t scanint_base(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl)
+{
+	int32_t s = init;	// 累计和.
+	int32_t x;
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		x = psrc[i];	// 先读后写, 原地计算时也正确.
+		if (excl)	pdst[i] = s;
+		s += x;
+		if (!excl)	pdst[i] = s;
+	}
+	return s;
+}
+
+// 64位整数前缀和_基本版.
+int64_t scanint64_base(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl)
+{
+	int64_t s = init;	// 累计和.
+	int64_t x;
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		x = psrc[i];	// 先读后写, 原地计算时也正确.
+		if (excl)	pdst[i] = s;
+		s += x;
+		if (!excl)	pdst[i] = s;
+	}
+	return s;
+}
+
+// 单精度浮点前缀和_基本版.
+float scanfloat_base(float* pdst, const float* psrc, size_t cntbuf, float init, int excl)
+{
+	float s = init;	// 累计和.
+	float x;
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		x = psrc[i];	// 先读后写, 原地计算时也正确.
+		if (excl)	pdst[i] = s;
+		s += x;
+		if (!excl)	pdst[i] = s;
+	}
+	return s;
+}
+
+// 双精度浮点前缀和_基本版.
+double scandouble_base(double* pdst, const double* psrc, size_t cntbuf, double init, int excl)
+{
+	double s = init;	// 累计和.
+	double x;
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		x = psrc[i];	// 先读后写, 原地计算时也正确.
+		if (excl)	pdst[i] = s;
+		s += x;
+		if (!excl)	pdst[i] = s;
+	}
+	return s;
+}
+
+//////////////////////////////////////////////////
+// sum_stride: 结构体数组中某个字段求和的函数
+//////////////////////////////////////////////////
+
+// 32位整数字段求和_基本版. 字段可以不按元素大小对齐, 故用memcpy读取.
+//
+// result: 返回字段之和.
+// pbase: 第一个记录的地址.
+// cntrec: 记录数.
+// cbstride: 步长（字节）.
+// cboffset: 字段在记录内的字节偏移.
+int32_t sumint_stride_base(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	int32_t s = 0;	// 求和变量.
+	int32_t x;
+	const char* p = (const char*)pbase + cboffset;
+	size_t i;
+	for(i=0; i<cntrec; ++i)
+	{
+		memcpy(&x, p, sizeof(x));
+		s += x;
+		p += cbstride;
+	}
+	return s;
+}
+
+// 单精度浮点字段求和_基本版.
+float sumfloat_stride_base(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	float s = 0;	// 求和变量.
+	float x;
+	const char* p = (const char*)pbase + cboffset;
+	size_t i;
+	for(i=0; i<cntrec; ++i)
+	{
+		memcpy(&x, p, sizeof(x));
+		s += x;
+		p += cbstride;
+	}
+	return s;
+}
+
+// 双精度浮点字段求和_基本版.
+double sumdouble_stride_base(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	double s = 0;	// 求和变量.
+	double x;
+	const char* p = (const char*)pbase + cboffset;
+	size_t i;
+	for(i=0; i<cntrec; ++i)
+	{
+		memcpy(&x, p, sizeof(x));
+		s += x;
+		p += cbstride;
+	}
+	return s;
+}
+
+//////////////////////////////////////////////////
+// sumhalf, sumbf16: 16位浮点数组求和的函数
+//////////////////////////////////////////////////
+
+// 半精度转为float. 半精度: 1位符号, 5位指数（偏置15）, 10位尾数.
+float simdsum_f16_to_f32(uint16_t h)
+{
+	uint32_t u = (uint32_t)(h & 0x8000) << 16;	// 符号.
+	uint32_t e = (h >> 10) & 0x1F;	// 指数.
+	uint32_t m = h & 0x3FF;	// 尾数.
+	float f;
+	if (0x1F==e)	u |= 0x7F800000 | (m << 13);	// 无穷大与NaN.
+	else if (0!=e)	u |= ((e + 127-15) << 23) | (m << 13);	// 规格化数. 调整指数的偏置.
+	else if (0!=m)	// 非规格化数: m * 2^-24. 在float中是规格化数, 直接用乘法转换.
+	{
+		f = (float)m * (1.0f / 16777216.0f);
+		return (h & 0x8000) ? -f : f;
+	}
+	memcpy(&f, &u, sizeof(f));
+	return f;
+}
+
+// bfloat16转为float. 低16位补0.
+float simdsum_bf16_to_f32(uint16_t h)
+{
+	uint32_t u = (uint32_t)h << 16;
+	float f;
+	memcpy(&f, &u, sizeof(f));
+	return f;
+}
+
+// float转为半精度. 舍入到最近, 正好居中时取偶数.
+uint16_t simdsum_f32_to_f16(float x)
+{
+	uint32_t u;
+	uint32_t sign;
+	uint32_t e;	// float的指数.
+	uint32_t m;	// 含隐含位的尾数.
+	uint32_t r;	// 结果（不含符号）.
+	uint32_t rem, half;	// 舍去的部分, 及其一半的位置.
+	memcpy(&u, &x, sizeof(u));
+	sign = (u >> 16) & 0x8000;
+	u &= 0x7FFFFFFF;
+	if (u >= 0x7F800000)	return (uint16_t)(sign | 0x7C00 | ((u > 0x7F800000) ? 0x200 : 0));	// 无穷大与NaN. NaN置尾数最高位, 以免变成无穷大.
+	if (u >= 0x477FF000)	return (uint16_t)(sign | 0x7C00);	// 不小于65520（65504与下一个2^16的中点）时舍入为无穷大.
+	e = u >> 23;
+	if (e < 113)	// 小于2^-14, 结果为非规格化数, 单位为2^-24.
+	{
+		if (e < 102)	return (uint16_t)sign;	// 小于2^-25, 舍入为0.
+		m = (u & 0x7FFFFF) | 0x800000;
+		r = m >> (126 - e);
+		rem = m & ((1U << (126 - e)) - 1);
+		half = 1U << (125 - e);
+	}
+	else	// 规格化数. 调整指数的偏置, 舍去尾数的低13位.
+	{
+		r = (u - ((127-15) << 23)) >> 13;
+		rem = u & 0x1FFF;
+		half = 0x1000;
+	}
+	if (rem > half || (rem == half && (r & 1)))	++r;	// 进位可能进入指数, 结果仍正确.
+	return (uint16_t)(sign | r);
+}
+
+// float转为bfloat16. 舍入到最近, 正好居中时取偶数.
+uint16_t simdsum_f32_to_bf16(float x)
+{
+	uint32_t u;
+	memcpy(&u, &x, sizeof(u));
+	if ((u & 0x7FFFFFFF) > 0x7F800000)	return (uint16_t)((u >> 16) | 0x40);	// NaN. 置尾数最高位, 以免舍去低位后变成无穷大.
+	u += 0x7FFF + ((u >> 16) & 1);
+	return (uint16_t)(u >> 16);
+}
+
+// 半精度浮点数组求和_基本版. 逐个转为float后累加.
+//
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址. 各元素为16位浮点数的位模式.
+// cntbuf: 数组长度.
+float sumhalf_base(const uint16_t* pbuf, size_t cntbuf)
+{
+	float s = 0;	// 求和变量.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += simdsum_f16_to_f32(pbuf[i]);
+	}
+	return s;
+}
+
+// bfloat16数组求和_基本版.
+float sumbf16_base(const uint16_t* pbuf, size_t cntbuf)
+{
+	float s = 0;	// 求和变量.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += simdsum_bf16_to_f32(pbuf[i]);
+	}
+	return s;
+}
+
+//////////////////////////////////////////////////
+// sumuint8, sumint8, sumint16: 窄整数数组求和的函数
+//////////////////////////////////////////////////
+
+// 无符号8位整数数组求和_基本版. 用64位累加.
+//
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+uint64_t sumuint8_base(const uint8_t* pbuf, size_t cntbuf)
+{
+	uint64_t s = 0;	// 求和变量.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += pbuf[i];
+	}
+	return s;
+}
+
+// 有符号8位整数数组求和_基本版.
+int64_t sumint8_base(const int8_t* pbuf, size_t cntbuf)
+{
+	int64_t s = 0;	// 求和变量.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += pbuf[i];
+	}
+	return s;
+}
+
+// 有符号16位整数数组求和_基本版.
+int64_t sumint16_base(const int16_t* pbuf, size_t cntbuf)
+{
+	int64_t s = 0;	// 求和变量.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += pbuf[i];
+	}
+	return s;
+}
+
+//////////////////////////////////////////////////
+// sumint64, sumuint64: 64位整数数组求和的函数
+//////////////////////////////////////////////////
+
+// 64位整数数组求和_基本版. 按无符号相加, 溢出时回绕.
+//
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+int64_t sumint64_base(const int64_t* pbuf, size_t cntbuf)
+{
+	uint64_t s = 0;	// 求和变量.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += (uint64_t)pbuf[i];
+	}
+	return (int64_t)s;
+}
+
+// 无符号64位整数数组求和_基本版. 和小于加数时说明产生了进位.
+//
+// result: 返回总和的低64位.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+// pcarry: 返回进位次数. 可以为NULL.
+uint64_t sumuint64_base(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry)
+{
+	uint64_t s = 0;	// 求和变量.
+	uint64_t c = 0;	// 进位次数.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		s += pbuf[i];
+		c += (s < pbuf[i]);
+	}
+	if (NULL!=pcarry)	*pcarry = c;
+	return s;
+}
+
+//////////////////////////////////////////////////
+// sum_where: 条件求和的函数
+//////////////////////////////////////////////////
+
+// 判断key是否在区间内. 用于各基本版.
+#define SIMDSUM_WHERE_PASS(k, lo, hi, flags)	( ((flags) & SIMDSUM_WHERE_LO_OPEN ? (k) > (lo) : (k) >= (lo)) && ((flags) & SIMDSUM_WHERE_HI_CLOSED ? (k) <= (hi) : (k) < (hi)) )
+
+// 32位整数数组条件求和_基本版. 逐个判断, 满足条件时累加.
+//
+// result: 返回满足条件的元素之和.
+// pval: 值数组.
+// pkey: 条件数组. 为NULL时对pval本身判断.
+// cntbuf: 数组长度.
+// lo: 区间的下界.
+// hi: 区间的上界.
+// flags: 边界类型. 详见SIMDSUM_WHERE_常数.
+int32_t sumint_where_base(const int32_t* pval, const int32_t* pkey, size_t cntbuf, int32_t lo, int32_t hi, int flags)
+{
+	int32_t s = 0;	// 求和变量.
+	size_t i;
+	if (NULL==pkey)	pkey = pval;
+	for(i=0; i<cntbuf; ++i)
+	{
+		if (SIMDSUM_WHERE_PASS(pkey[i], lo, hi, flags))	s += pval[i];
+	}
+	return s;
+}
+
+// 单精度浮点数组条件求和_基本版.
+float sumfloat_where_base(const float* pval, const float* pkey, size_t cntbuf, float lo, float hi, int flags)
+{
+	float s = 0;	// 求和变量.
+	size_t i;
+	if (NULL==pkey)	pkey = pval;
+	for(i=0; i<cntbuf; ++i)
+	{
+		if (SIMDSUM_WHERE_PASS(pkey[i], lo, hi, flags))	s += pval[i];
+	}
+	return s;
+}
+
+// 双精度浮点数组条件求和_基本版.
+double sumdouble_where_base(const double* pval, const double* pkey, size_t cntbuf, double lo, double hi, int flags)
+{
+	double s = 0;	// 求和变量.
+	size_t i;
+	if (NULL==pkey)	pkey = pval;
+	for(i=0; i<cntbuf; ++i)
+	{
+		if (SIMDSUM_WHERE_PASS(pkey[i], lo, hi, flags))	s += pval[i];
+	}
+	return s;
+}
+
+//////////////////////////////////////////////////
+// sum_nan: 跳过NaN求和的函数
+//////////////////////////////////////////////////
+
+// 单精度浮点数组跳过NaN求和_基本版. 逐个判断, 利用 NaN!=NaN 跳过NaN.
+//
+// result: 返回非NaN元素之和.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+// pcnt: 返回非NaN元素的个数. 可以为NULL.
+float sumfloat_nan_base(const float* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	float s = 0;	// 求和变量.
+	size_t n = 0;	// 计数.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		if (pbuf[i] == pbuf[i])
+		{
+			s += pbuf[i];
+			++n;
+		}
+	}
+	if (NULL!=pcnt)	*pcnt = n;
+	return s;
+}
+
+// 双精度浮点数组跳过NaN求和_基本版.
+double sumdouble_nan_base(const double* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	double s = 0;	// 求和变量.
+	size_t n = 0;	// 计数.
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		if (pbuf[i] == pbuf[i])
+		{
+			s += pbuf[i];
+			++n;
+		}
+	}
+	if (NULL!=pcnt)	*pcnt = n;
+	return s;
+}
+
+//////////////////////////////////////////////////
+// stream: STREAM式带宽基准的函数
+//////////////////////////////////////////////////
+
+// 只读_基本版.
+//
+// result: 返回各元素按位或的结果. 只用于防止调用被优化掉.
+// pbuf: 数组的首地址.
+// cntbuf: 数组长度.
+uint64_t stream_read_base(const double* pbuf, size_t cntbuf)
+{
+	uint64_t r = 0;	// 按位或的结果.
+	uint64_t u;
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		memcpy(&u, &pbuf[i], sizeof(u));
+		r |= u;
+	}
+	return r;
+}
+
+// 复制_基本版. pdst[i] = psrc[i].
+void stream_copy_base(double* pdst, const double* psrc, size_t cntbuf)
+{
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		pdst[i] = psrc[i];
+	}
+}
+
+// 三元组_基本版. pa[i] = pb[i] + s*pc[i].
+void stream_triad_base(double* pa, const double* pb, const double* pc, double s, size_t cntbuf)
+{
+	size_t i;
+	for(i=0; i<cntbuf; ++i)
+	{
+		pa[i] = pb[i] + s*pc[i];
+	}
+}
@@ -0,0 +1,20 @@
+﻿#include "simdsum_kernel.hpp"
+
+
+//////////////////////////////////////////////////
+// sumhalf: 半精度浮点数组求和的函数
+//////////////////////////////////////////////////
+
+#if defined(INTRIN_AVX) && defined(INTRIN_F16C)
+// 半精度浮点数组求和_F16C版.
+float sumhalf_f16c(const uint16_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<half_t, float, SIMDSUM_ISA_F16C, 1>((const half_t*)pbuf, cntbuf);
+}
+
+// 半精度浮点数组求和_F16C四路循环展开版.
+float sumhalf_f16c_4loop(const uint16_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<half_t, float, SIMDSUM_ISA_F16C, 4>((const half_t*)pbuf, cntbuf);
+}
+#endif	// #if defined(INTRIN_AVX) && defined(INTRIN_F16C)
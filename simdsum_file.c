@@ -0,0 +1,155 @@
+﻿#include <stddef.h>
+
+#include "simdsum.h"
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <errno.h>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif	// #if defined(_WIN32)
+
+
+//////////////////////////////////////////////////
+// 文件映射: 对 Win32 与 mmap 的简单封装
+//////////////////////////////////////////////////
+
+// 只读映射的文件.
+typedef struct tagSIMDSUM_FILEMAP{
+	const void*	p;	// 映射的首地址. 文件为空时为NULL.
+	size_t	cb;	// 文件的字节数.
+#if defined(_WIN32)
+	HANDLE	hFile;	// 文件句柄.
+	HANDLE	hMap;	// 映射句柄.
+#endif	// #if defined(_WIN32)
+}SIMDSUM_FILEMAP;
+
+// 只读映射整个文件, 并提示将顺序访问.
+//
+// result: 成功时返回0, 否则返回错误码.
+// szpath: 文件路径.
+// pmap: 返回映射信息.
+static int simdsum_file_map(const char* szpath, SIMDSUM_FILEMAP* pmap)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER cb;
+	int rt;
+	pmap->p = NULL;
+	pmap->cb = 0;
+	pmap->hMap = NULL;
+	pmap->hFile = CreateFileA(szpath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (INVALID_HANDLE_VALUE==pmap->hFile)	return (int)GetLastError();
+	if (!GetFileSizeEx(pmap->hFile, &cb))	goto fail;
+	if ((unsigned long long)cb.QuadPart > (size_t)-1)
+	{
+		SetLastError(ERROR_FILE_TOO_LARGE);
+		goto fail;
+	}
+	pmap->cb = (size_t)cb.QuadPart;
+	if (0==pmap->cb)	return 0;	// 空文件无法映射.
+	pmap->hMap = CreateFileMappingA(pmap->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (NULL==pmap->hMap)	goto fail;
+	pmap->p = MapViewOfFile(pmap->hMap, FILE_MAP_READ, 0, 0, 0);
+	if (NULL==pmap->p)	goto fail;
+	return 0;
+fail:
+	rt = (int)GetLastError();
+	if (NULL!=pmap->hMap)	CloseHandle(pmap->hMap);
+	CloseHandle(pmap->hFile);
+	return rt;
+#else
+	struct stat st;
+	void* p;
+	int rt;
+	int fd = open(szpath, O_RDONLY);
+	pmap->p = NULL;
+	pmap->cb = 0;
+	if (fd < 0)	return errno;
+	if (0!=fstat(fd, &st))	goto fail;
+	if ((unsigned long long)st.st_size > (size_t)-1)
+	{
+		errno = EFBIG;
+		goto fail;
+	}
+	pmap->cb = (size_t)st.st_size;
+	if (0==pmap->cb)	// 空文件无法映射.
+	{
+		close(fd);
+		return 0;
+	}
+	p = mmap(NULL, pmap->cb, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (MAP_FAILED==p)	goto fail;
+	close(fd);	// 映射不依赖于文件描述符.
+	// 只是提示, 失败（例如文件系统不支持大页）时忽略.
+	madvise(p, pmap->cb, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+	madvise(p, pmap->cb, MADV_HUGEPAGE);
+#endif	// #ifdef MADV_HUGEPAGE
+	pmap->p = p;
+	return 0;
+fail:
+	rt = errno;
+	close(fd);
+	return rt;
+#endif	// #if defined(_WIN32)
+}
+
+// 解除映射.
+static void simdsum_file_unmap(SIMDSUM_FILEMAP* pmap)
+{
+#if defined(_WIN32)
+	if (NULL!=pmap->p)	UnmapViewOfFile(pmap->p);
+	if (NULL!=pmap->hMap)	CloseHandle(pmap->hMap);
+	CloseHandle(pmap->hFile);
+#else
+	if (NULL!=pmap->p)	munmap((void*)pmap->p, pmap->cb);
+#endif	// #if defined(_WIN32)
+	pmap->p = NULL;
+}
+
+
+//////////////////////////////////////////////////
+// simd_sum_file: 文件求和
+//////////////////////////////////////////////////
+
+int simd_sum_file_i32(const char* szpath, int64_t* psum, size_t* pcnt)
+{
+	SIMDSUM_FILEMAP map;
+	size_t cnt;
+	int rt = simdsum_file_map(szpath, &map);
+	if (0!=rt)	return rt;
+	cnt = map.cb / sizeof(int32_t);
+	*psum = (0!=cnt) ? simd_sum_i32_wide((const int32_t*)map.p, cnt) : 0;
+	if (NULL!=pcnt)	*pcnt = cnt;
+	simdsum_file_unmap(&map);
+	return 0;
+}
+
+int simd_sum_file_f32(const char* szpath, float* psum, size_t* pcnt)
+{
+	SIMDSUM_FILEMAP map;
+	size_t cnt;
+	int rt = simdsum_file_map(szpath, &map);
+	if (0!=rt)	return rt;
+	cnt = map.cb / sizeof(float);
+	*psum = (0!=cnt) ? simd_sum_f32((const float*)map.p, cnt) : 0;
+	if (NULL!=pcnt)	*pcnt = cnt;
+	simdsum_file_unmap(&map);
+	return 0;
+}
+
+int simd_sum_file_f64(const char* szpath, double* psum, size_t* pcnt)
+{
+	SIMDSUM_FILEMAP map;
+	size_t cnt;
+	int rt = simdsum_file_map(szpath, &map);
+	if (0!=rt)	return rt;
+	cnt = map.cb / sizeof(double);
+	*psum = (0!=cnt) ? simd_sum_f64((const double*)map.p, cnt) : 0;
+	if (NULL!=pcnt)	*pcnt = cnt;
+	simdsum_file_unmap(&map);
+	return 0;
+}
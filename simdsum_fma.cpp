@@ -0,0 +1,56 @@
+﻿#include "simdsum_kernel.hpp"
+
+
+//////////////////////////////////////////////////
+// sum_stats: 单遍统计的函数
+//////////////////////////////////////////////////
+
+#if defined(INTRIN_AVX) && defined(INTRIN_FMA)
+// 32位整数数组统计_AVX+FMA版.
+void sumint_stats_fma(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	stats_kernel<int32_t, SIMDSUM_ISA_FMA, 2>(pbuf, cntbuf, pst);
+}
+
+// 单精度浮点数组统计_AVX+FMA版.
+void sumfloat_stats_fma(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	stats_kernel<float, SIMDSUM_ISA_FMA, 2>(pbuf, cntbuf, pst);
+}
+
+// 双精度浮点数组统计_AVX+FMA版.
+void sumdouble_stats_fma(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	stats_kernel<double, SIMDSUM_ISA_FMA, 2>(pbuf, cntbuf, pst);
+}
+#endif	// #if defined(INTRIN_AVX) && defined(INTRIN_FMA)
+
+//////////////////////////////////////////////////
+// dot: 点积的函数
+//////////////////////////////////////////////////
+
+#if defined(INTRIN_AVX) && defined(INTRIN_FMA)
+// 单精度浮点点积_AVX+FMA四路循环展开版.
+float dotfloat_fma_4loop(const float* pa, const float* pb, size_t cntbuf)
+{
+	return dot_kernel<float, SIMDSUM_ISA_FMA, 4>(pa, pb, cntbuf);
+}
+
+// 单精度浮点点积_AVX+FMA八路循环展开版.
+float dotfloat_fma_8loop(const float* pa, const float* pb, size_t cntbuf)
+{
+	return dot_kernel<float, SIMDSUM_ISA_FMA, 8>(pa, pb, cntbuf);
+}
+
+// 双精度浮点点积_AVX+FMA四路循环展开版.
+double dotdouble_fma_4loop(const double* pa, const double* pb, size_t cntbuf)
+{
+	return dot_kernel<double, SIMDSUM_ISA_FMA, 4>(pa, pb, cntbuf);
+}
+
+// 双精度浮点点积_AVX+FMA八路循环展开版.
+double dotdouble_fma_8loop(const double* pa, const double* pb, size_t cntbuf)
+{
+	return dot_kernel<double, SIMDSUM_ISA_FMA, 8>(pa, pb, cntbuf);
+}
+#endif	// #if defined(INTRIN_AVX) && defined(INTRIN_FMA)
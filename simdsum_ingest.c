@@ -0,0 +1,288 @@
+﻿#include <stddef.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#include "simdsum.h"
+#include "simdsum_thread.h"
+
+#if defined(_WIN32)
+	#include <io.h>
+	#include <malloc.h>
+#endif	// #if defined(_WIN32)
+
+
+//////////////////////////////////////////////////
+// 流水线
+//////////////////////////////////////////////////
+
+#define SIMDSUM_INGEST_ALIGN	4096	// 缓冲区的对齐字节数. 块大小也取整为它的倍数, 故除最后一块外, 块内都是完整的元素.
+
+#define SIMDSUM_INGEST_TYPE_I32	0	// 数据类型: int32_t.
+#define SIMDSUM_INGEST_TYPE_F32	1	// 数据类型: float.
+#define SIMDSUM_INGEST_TYPE_F64	2	// 数据类型: double.
+
+static MTMUTEX simdsum_ingest_call = MTMUTEX_INIT;	// 串行化调用者. 下面的状态每次只供一个流水线使用.
+static MTMUTEX simdsum_ingest_mutex = MTMUTEX_INIT;	// 保护下面的环形缓冲区状态.
+static MTCOND simdsum_ingest_cvfull = MTCOND_INIT;	// 有块被读满, 或读取已结束.
+static MTCOND simdsum_ingest_cvempty = MTCOND_INIT;	// 有块被消费.
+static int simdsum_ingest_nfull = 0;	// 已读满、尚未消费的块数.
+static int simdsum_ingest_eof = 0;	// 读取是否已结束（文件结束、达到限制或出错）.
+static int simdsum_ingest_err = 0;	// 读取的错误码.
+
+// 本次调用的参数. 在创建I/O线程之前写入.
+static char* simdsum_ingest_bufs[SIMDSUM_INGEST_MAXDEPTH];	// 环形缓冲区.
+static size_t simdsum_ingest_lens[SIMDSUM_INGEST_MAXDEPTH];	// 各块读到的字节数.
+static int simdsum_ingest_depth;	// 块数.
+static size_t simdsum_ingest_cbchunk;	// 块大小（字节）.
+static uint64_t simdsum_ingest_cblimit;	// 最多读取的字节数. 0表示不限制.
+static int simdsum_ingest_fd;	// 文件描述符.
+
+// 分配按 SIMDSUM_INGEST_ALIGN 对齐的内存.
+static void* simdsum_ingest_alloc(size_t cb)
+{
+#if defined(_WIN32)
+	return _aligned_malloc(cb, SIMDSUM_INGEST_ALIGN);
+#else
+	void* p = NULL;
+	if (0!=posix_memalign(&p, SIMDSUM_INGEST_ALIGN, cb))	return NULL;
+	return p;
+#endif	// #if defined(_WIN32)
+}
+
+static void simdsum_ingest_free(void* p)
+{
+#if defined(_WIN32)
+	_aligned_free(p);
+#else
+	free(p);
+#endif	// #if defined(_WIN32)
+}
+
+// 读满一块. 管道与套接字每次可能只返回一部分, 故循环读取.
+//
+// result: 返回读到的字节数. 小于cb表示已到结尾或出错.
+// p: 缓冲区.
+// cb: 要读的字节数.
+// perr: 出错时返回errno.
+static size_t simdsum_ingest_read(char* p, size_t cb, int* perr)
+{
+	size_t cbdone = 0;	// 已读的字节数.
+	while(cbdone < cb)
+	{
+#if defined(_WIN32)
+		int n = _read(simdsum_ingest_fd, p+cbdone, (unsigned)(cb-cbdone));
+#else
+		ssize_t n = read(simdsum_ingest_fd, p+cbdone, cb-cbdone);
+		if (n<0 && EINTR==errno)	continue;
+#endif	// #if defined(_WIN32)
+		if (n<0)
+		{
+			*perr = errno;
+			break;
+		}
+		if (0==n)	break;
+		cbdone += (size_t)n;
+	}
+	return cbdone;
+}
+
+// 读取下一块. 返回是否已结束.
+//
+// idx: 块的序号.
+// pcbleft: 剩余可读的字节数. 不限制时为0, 且不会改变.
+static int simdsum_ingest_fill(int idx, uint64_t* pcbleft)
+{
+	int err = 0;
+	size_t cb = simdsum_ingest_cbchunk;	// 要读的字节数.
+	size_t n;
+	if (0!=*pcbleft && *pcbleft < cb)	cb = (size_t)*pcbleft;
+	n = simdsum_ingest_read(simdsum_ingest_bufs[idx], cb, &err);
+	simdsum_ingest_lens[idx] = n;
+	if (0!=*pcbleft)
+	{
+		*pcbleft -= n;
+		if (0==*pcbleft)	return 1;
+	}
+	if (0!=err)	simdsum_ingest_err = err;
+	return (n<cb || 0!=err);
+}
+
+// I/O线程. 环形缓冲区全满时等待, 实现背压.
+#if defined(_WIN32)
+static DWORD WINAPI simdsum_ingest_reader(LPVOID param)
+#else
+static void* simdsum_ingest_reader(void* param)
+#endif	// #if defined(_WIN32)
+{
+	int idx = 0;	// 下一块的序号.
+	int eof;
+	uint64_t cbleft = simdsum_ingest_cblimit;
+	(void)param;
+	for(;;)
+	{
+		mt_lock(&simdsum_ingest_mutex);
+		while(simdsum_ingest_nfull >= simdsum_ingest_depth)	mt_wait(&simdsum_ingest_cvempty, &simdsum_ingest_mutex);
+		mt_unlock(&simdsum_ingest_mutex);
+
+		eof = simdsum_ingest_fill(idx, &cbleft);
+
+		mt_lock(&simdsum_ingest_mutex);
+		++simdsum_ingest_nfull;
+		if (eof)	simdsum_ingest_eof = 1;
+		mt_signal(&simdsum_ingest_cvfull);
+		mt_unlock(&simdsum_ingest_mutex);
+		if (eof)	break;
+		idx = (idx+1) % simdsum_ingest_depth;
+	}
+	return 0;
+}
+
+// 对一块求和, 累加到*pi或*pd.
+static void simdsum_ingest_sum(int type, const char* p, size_t cb, int64_t* pi, double* pd)
+{
+	switch(type)
+	{
+	case SIMDSUM_INGEST_TYPE_I32:
+		*pi += simd_sum_i32_wide((const int32_t*)p, cb/sizeof(int32_t));
+		break;
+	case SIMDSUM_INGEST_TYPE_F32:
+		*pd += simd_sum_f32((const float*)p, cb/sizeof(float));	// 各块之和用double累加, 减小舍入误差.
+		break;
+	default:
+		*pd += simd_sum_f64((const double*)p, cb/sizeof(double));
+		break;
+	}
+}
+
+// 运行流水线.
+//
+// result: 成功时返回0, 否则返回错误码.
+// type: 数据类型. 详见SIMDSUM_INGEST_TYPE_常数.
+// pi: 返回整数的和. 须先置0.
+// pd: 返回浮点数的和. 须先置0.
+// 其余参数与 simd_sum_fd_i32 相同.
+static int simdsum_ingest_run(int type, int fd, const SIMDSUM_INGEST* pcfg, int64_t* pi, double* pd, uint64_t* pcb)
+{
+	int i;
+	int rt;
+	int idx = 0;	// 下一个待消费块的序号.
+	int threaded = 0;	// 是否创建了I/O线程.
+	uint64_t cbtotal = 0;	// 读到的总字节数.
+	uint64_t cbleft;
+	MTTHREAD th;
+
+	mt_lock(&simdsum_ingest_call);
+	simdsum_ingest_fd = fd;
+	simdsum_ingest_cbchunk = (NULL!=pcfg && 0!=pcfg->cbchunk) ? pcfg->cbchunk : SIMDSUM_INGEST_CHUNK;
+	simdsum_ingest_cbchunk = (simdsum_ingest_cbchunk + SIMDSUM_INGEST_ALIGN-1) & ~(size_t)(SIMDSUM_INGEST_ALIGN-1);
+	simdsum_ingest_depth = (NULL!=pcfg && 0!=pcfg->depth) ? pcfg->depth : SIMDSUM_INGEST_DEPTH;
+	if (simdsum_ingest_depth > SIMDSUM_INGEST_MAXDEPTH)	simdsum_ingest_depth = SIMDSUM_INGEST_MAXDEPTH;
+	if (simdsum_ingest_depth < 1)	simdsum_ingest_depth = 1;
+	simdsum_ingest_cblimit = (NULL!=pcfg) ? pcfg->cblimit : 0;
+	simdsum_ingest_nfull = 0;
+	simdsum_ingest_eof = 0;
+	simdsum_ingest_err = 0;
+	for(i=0; i<simdsum_ingest_depth; ++i)
+	{
+		simdsum_ingest_bufs[i] = (char*)simdsum_ingest_alloc(simdsum_ingest_cbchunk);
+		if (NULL==simdsum_ingest_bufs[i])
+		{
+			if (0==i)
+			{
+				mt_unlock(&simdsum_ingest_call);
+				return ENOMEM;
+			}
+			simdsum_ingest_depth = i;	// 内存不足时少用几块.
+			break;
+		}
+	}
+
+	// 创建I/O线程. 只有一块或创建失败时, 在调用线程中读一块求一块.
+	if (simdsum_ingest_depth > 1)
+	{
+#if defined(_WIN32)
+		th = CreateThread(NULL, 0, simdsum_ingest_reader, NULL, 0, NULL);
+		threaded = (NULL!=th);
+#else
+		threaded = (0==pthread_create(&th, NULL, simdsum_ingest_reader, NULL));
+#endif	// #if defined(_WIN32)
+	}
+
+	if (threaded)
+	{
+		for(;;)
+		{
+			mt_lock(&simdsum_ingest_mutex);
+			while(0==simdsum_ingest_nfull && !simdsum_ingest_eof)	mt_wait(&simdsum_ingest_cvfull, &simdsum_ingest_mutex);
+			if (0==simdsum_ingest_nfull)	// 已结束, 且全部消费完.
+			{
+				mt_unlock(&simdsum_ingest_mutex);
+				break;
+			}
+			mt_unlock(&simdsum_ingest_mutex);
+
+			simdsum_ingest_sum(type, simdsum_ingest_bufs[idx], simdsum_ingest_lens[idx], pi, pd);
+			cbtotal += simdsum_ingest_lens[idx];
+			idx = (idx+1) % simdsum_ingest_depth;
+
+			mt_lock(&simdsum_ingest_mutex);
+			--simdsum_ingest_nfull;
+			mt_signal(&simdsum_ingest_cvempty);
+			mt_unlock(&simdsum_ingest_mutex);
+		}
+#if defined(_WIN32)
+		WaitForSingleObject(th, INFINITE);
+		CloseHandle(th);
+#else
+		pthread_join(th, NULL);
+#endif	// #if defined(_WIN32)
+	}
+	else
+	{
+		cbleft = simdsum_ingest_cblimit;
+		do
+		{
+			i = simdsum_ingest_fill(0, &cbleft);
+			simdsum_ingest_sum(type, simdsum_ingest_bufs[0], simdsum_ingest_lens[0], pi, pd);
+			cbtotal += simdsum_ingest_lens[0];
+		}while(!i);
+	}
+
+	for(i=0; i<simdsum_ingest_depth; ++i)	simdsum_ingest_free(simdsum_ingest_bufs[i]);
+	rt = simdsum_ingest_err;
+	mt_unlock(&simdsum_ingest_call);
+	if (NULL!=pcb)	*pcb = cbtotal;
+	return rt;
+}
+
+
+//////////////////////////////////////////////////
+// simd_sum_fd: 流水线读取求和
+//////////////////////////////////////////////////
+
+int simd_sum_fd_i32(int fd, const SIMDSUM_INGEST* pcfg, int64_t* psum, uint64_t* pcb)
+{
+	int64_t si = 0;
+	double sd = 0;
+	int rt = simdsum_ingest_run(SIMDSUM_INGEST_TYPE_I32, fd, pcfg, &si, &sd, pcb);
+	*psum = si;
+	return rt;
+}
+
+int simd_sum_fd_f32(int fd, const SIMDSUM_INGEST* pcfg, float* psum, uint64_t* pcb)
+{
+	int64_t si = 0;
+	double sd = 0;
+	int rt = simdsum_ingest_run(SIMDSUM_INGEST_TYPE_F32, fd, pcfg, &si, &sd, pcb);
+	*psum = (float)sd;
+	return rt;
+}
+
+int simd_sum_fd_f64(int fd, const SIMDSUM_INGEST* pcfg, double* psum, uint64_t* pcb)
+{
+	int64_t si = 0;
+	double sd = 0;
+	int rt = simdsum_ingest_run(SIMDSUM_INGEST_TYPE_F64, fd, pcfg, &si, &sd, pcb);
+	*psum = sd;
+	return rt;
+}
@@ -0,0 +1,2295 @@
+﻿#ifndef __SIMDSUM_KERNEL_HPP_INCLUDED
+#define __SIMDSUM_KERNEL_HPP_INCLUDED
+
+// 求和内核的模板. 仅供各指令集的内核文件(simdsum_*.cpp)使用.
+// 各内核文件的编译选项不同, 同一个模板实例在不同文件中生成的代码也不同.
+// 故全部放在无名名字空间中, 每个文件各有一份, 避免违反ODR（否则链接时只保留其中一份, 可能在不支持的CPU上执行高级指令）.
+
+#include <stddef.h>
+#include <string.h>
+#include <utility>
+
+#include "zintrin.h"
+#include "simdsum.h"
+
+
+namespace {
+
+// 标量读取一个元素. 数组可以从任意地址开始, 开头与剩下的元素未必按元素大小对齐, 直接解引用是未定义行为, 故用memcpy. 编译后仍是一条加载指令.
+template<typename T>
+inline T sum_get(const T* p)
+{
+	T x;
+	memcpy(&x, p, sizeof(T));
+	return x;
+}
+
+////////////////////////////////////////
+// SumTraits: 各指令集的向量操作.
+////////////////////////////////////////
+
+// 向量操作的特征类. T为元素类型, A为累加类型, ISA为指令集级别（详见SIMDSUM_ISA_常数）.
+// 特化需提供:
+//   vec_t: 向量类型.
+//   lanes: 每次加载的元素数.
+//   align: 批量处理时的对齐字节数.
+//   masked: 是否支持掩码加载. 支持时开头与剩余部分都用掩码加载处理, 否则逐个处理.
+//   zero(): 全0向量.
+//   load(p): 加载lanes个元素并转为累加类型. 不要求对齐.
+//   loadmask(p, n): 加载前n个元素, 其余为0. 仅masked时需要.
+//   add(a, b): 紧缩加法.
+//   sub(a, b): 紧缩减法. 仅补偿求和需要.
+//   reduce(a): 水平求和.
+//   leave(): 返回前的清理.
+// 分段求和（sum_seg）还需提供:
+//   loadlast(pend, n): 加载以pend结尾的lanes个元素, 只保留最后n个（0<n<lanes）, 其余为0. 仅非masked时需要.
+//   reduce_group(acc, pout): 对lanes个向量分别水平求和, 结果依次存入pout[0]~pout[lanes-1].
+// 双精度浮点的特化还需提供以下操作, 供STREAM式带宽基准使用:
+//   set1(x): 各通道均为x.
+//   mul(a, b): 紧缩乘法.
+//   or_bits(a, b): 按位或.
+//   store(p, a): 存储lanes个元素. 不要求对齐.
+// 单遍统计（stats_kernel, 仅双精度浮点）与点积（dot_kernel）还需提供:
+//   min(a, b), max(a, b): 紧缩最小值/最大值. 仅单遍统计需要.
+//   madd(a, b, c): a*b+c. 有FMA时为融合乘加, 只舍入一次.
+template<typename T, typename A, int ISA> struct SumTraits;
+
+// 尾部掩码表. 从 seg_mask32 + 8+n-lanes 开始加载lanes项, 得到只有最后n项为全1的掩码. seg_mask64 同理, 起点为 4+n-lanes.
+alignas(32) const int32_t seg_mask32[16] = {0, 0, 0, 0, 0, 0, 0, 0, -1, -1, -1, -1, -1, -1, -1, -1};
+alignas(32) const int64_t seg_mask64[8] = {0, 0, 0, 0, -1, -1, -1, -1};
+
+#ifdef INTRIN_AVX
+// 8个向量分别水平求和, 返回8个和. 两层VHADDPS之后, 每个128位半部各有4个向量的部分和, 再把两个半部相加.
+inline __m256 seg_reduce8_ps(const __m256* a)
+{
+	__m256 h0 = _mm256_hadd_ps(_mm256_hadd_ps(a[0], a[1]), _mm256_hadd_ps(a[2], a[3]));	// [AVX] VHADDPS. 半部内相邻求和.
+	__m256 h1 = _mm256_hadd_ps(_mm256_hadd_ps(a[4], a[5]), _mm256_hadd_ps(a[6], a[7]));
+	return _mm256_add_ps(_mm256_permute2f128_ps(h0, h1, 0x20), _mm256_permute2f128_ps(h0, h1, 0x31));	// [AVX] VPERM2F128. 取低半部/高半部.
+}
+
+// 4个向量分别水平求和, 返回4个和.
+inline __m256d seg_reduce4_pd(const __m256d* a)
+{
+	__m256d h0 = _mm256_hadd_pd(a[0], a[1]);	// [AVX] VHADDPD.
+	__m256d h1 = _mm256_hadd_pd(a[2], a[3]);
+	return _mm256_add_pd(_mm256_permute2f128_pd(h0, h1, 0x20), _mm256_permute2f128_pd(h0, h1, 0x31));	// [AVX] VPERM2F128.
+}
+#endif	// #ifdef INTRIN_AVX
+
+#ifdef INTRIN_AVX2
+// 8个向量分别水平求和, 返回8个和. 同 seg_reduce8_ps.
+inline __m256i seg_reduce8_epi32(const __m256i* a)
+{
+	__m256i h0 = _mm256_hadd_epi32(_mm256_hadd_epi32(a[0], a[1]), _mm256_hadd_epi32(a[2], a[3]));	// [AVX2] VPHADDD.
+	__m256i h1 = _mm256_hadd_epi32(_mm256_hadd_epi32(a[4], a[5]), _mm256_hadd_epi32(a[6], a[7]));
+	return _mm256_add_epi32(_mm256_permute2x128_si256(h0, h1, 0x20), _mm256_permute2x128_si256(h0, h1, 0x31));	// [AVX2] VPERM2I128.
+}
+#endif	// #ifdef INTRIN_AVX2
+
+#ifdef INTRIN_MMX
+// 32位整数_MMX.
+template<> struct SumTraits<int32_t, int32_t, SIMDSUM_ISA_MMX>
+{
+	typedef __m64 vec_t;
+	static constexpr size_t lanes = 2;
+	static constexpr size_t align = 8;
+	static constexpr bool masked = false;
+	static vec_t zero() { return _mm_setzero_si64(); }	// [MMX] PXOR.
+	static vec_t load(const int32_t* p) { vec_t v; memcpy(&v, p, sizeof(v)); return v; }	// [MMX] MOVQ. 地址未按4字节对齐时也无法按8字节对齐, 故用memcpy.
+	static vec_t add(vec_t a, vec_t b) { return _mm_add_pi32(a, b); }	// [MMX] PADDD. 32位整数紧缩环绕加法.
+	static int32_t reduce(vec_t a) { const int32_t* q = (const int32_t*)&a; return q[0] + q[1]; }
+	static void leave() { _mm_empty(); }	// [MMX] EMMS. 清理MMX状态.
+};
+#endif	// #ifdef INTRIN_MMX
+
+#ifdef INTRIN_SSE
+// 单精度浮点_SSE.
+template<> struct SumTraits<float, float, SIMDSUM_ISA_SSE>
+{
+	typedef __m128 vec_t;
+	static constexpr size_t lanes = 4;
+	static constexpr size_t align = 16;
+	static constexpr bool masked = false;
+	static vec_t zero() { return _mm_setzero_ps(); }	// [SSE] XORPS.
+	static vec_t load(const float* p) { return _mm_loadu_ps(p); }	// [SSE] MOVUPS.
+	static vec_t add(vec_t a, vec_t b) { return _mm_add_ps(a, b); }	// [SSE] ADDPS. 单精浮点紧缩加法.
+	static vec_t sub(vec_t a, vec_t b) { return _mm_sub_ps(a, b); }	// [SSE] SUBPS.
+	static float reduce(vec_t a) { const float* q = (const float*)&a; return q[0] + q[1] + q[2] + q[3]; }
+	static void leave() {}
+	static vec_t loadlast(const float* pend, size_t n) { return _mm_and_ps(_mm_loadu_ps(pend-4), _mm_loadu_ps((const float*)(seg_mask32 + 4+n))); }	// [SSE] ANDPS.
+	static vec_t madd(vec_t a, vec_t b, vec_t c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }	// [SSE] MULPS + ADDPS.
+	static void reduce_group(const vec_t* acc, float* pout)
+	{
+		vec_t r0 = acc[0], r1 = acc[1], r2 = acc[2], r3 = acc[3];
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);	// [SSE] UNPCKLPS/UNPCKHPS/MOVLHPS/MOVHLPS. 转置后第i个通道属于第i个向量.
+		_mm_storeu_ps(pout, _mm_add_ps(_mm_add_ps(r0, r1), _mm_add_ps(r2, r3)));
+	}
+};
+#endif	// #ifdef INTRIN_SSE
+
+#ifdef INTRIN_SSE2
+// 32位整数_SSE2.
+template<> struct SumTraits<int32_t, int32_t, SIMDSUM_ISA_SSE2>
+{
+	typedef __m128i vec_t;
+	static constexpr size_t lanes = 4;
+	static constexpr size_t align = 16;
+	static constexpr bool masked = false;
+	static vec_t zero() { return _mm_setzero_si128(); }	// [SSE2] PXOR.
+	static vec_t load(const int32_t* p) { return _mm_loadu_si128((const __m128i*)p); }	// [SSE2] MOVDQU.
+	static vec_t add(vec_t a, vec_t b) { return _mm_add_epi32(a, b); }	// [SSE2] PADDD. 32位整数紧缩环绕加法.
+	static int32_t reduce(vec_t a) { const int32_t* q = (const int32_t*)&a; return q[0] + q[1] + q[2] + q[3]; }
+	static void leave() {}
+	static vec_t loadlast(const int32_t* pend, size_t n) { return _mm_and_si128(load(pend-4), _mm_loadu_si128((const __m128i*)(seg_mask32 + 4+n))); }	// [SSE2] PAND.
+	static void reduce_group(const vec_t* acc, int32_t* pout)
+	{
+		// 4x4转置: 先按32位交错, 再按64位交错.
+		vec_t t0 = _mm_unpacklo_epi32(acc[0], acc[1]);	// [SSE2] PUNPCKLDQ.
+		vec_t t1 = _mm_unpacklo_epi32(acc[2], acc[3]);
+		vec_t t2 = _mm_unpackhi_epi32(acc[0], acc[1]);	// [SSE2] PUNPCKHDQ.
+		vec_t t3 = _mm_unpackhi_epi32(acc[2], acc[3]);
+		vec_t s0 = _mm_add_epi32(_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1));	// [SSE2] PUNPCKLQDQ/PUNPCKHQDQ.
+		vec_t s1 = _mm_add_epi32(_mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3));
+		_mm_storeu_si128((__m128i*)pout, _mm_add_epi32(s0, s1));
+	}
+};
+
+// 双精度浮点_SSE2.
+template<> struct SumTraits<double, double, SIMDSUM_ISA_SSE2>
+{
+	typedef __m128d vec_t;
+	static constexpr size_t lanes = 2;
+	static constexpr size_t align = 16;
+	static constexpr bool masked = false;
+	static vec_t zero() { return _mm_setzero_pd(); }	// [SSE2] XORPD.
+	static vec_t load(const double* p) { return _mm_loadu_pd(p); }	// [SSE2] MOVUPD.
+	static vec_t add(vec_t a, vec_t b) { return _mm_add_pd(a, b); }	// [SSE2] ADDPD. 双精浮点紧缩加法.
+	static vec_t sub(vec_t a, vec_t b) { return _mm_sub_pd(a, b); }	// [SSE2] SUBPD.
+	static double reduce(vec_t a) { const double* q = (const double*)&a; return q[0] + q[1]; }
+	static void leave() {}
+	static vec_t loadlast(const double* pend, size_t n) { return _mm_and_pd(load(pend-2), _mm_loadu_pd((const double*)(seg_mask64 + 2+n))); }	// [SSE2] ANDPD.
+	static void reduce_group(const vec_t* acc, double* pout) { _mm_storeu_pd(pout, _mm_add_pd(_mm_unpacklo_pd(acc[0], acc[1]), _mm_unpackhi_pd(acc[0], acc[1]))); }	// [SSE2] UNPCKLPD/UNPCKHPD.
+	static vec_t set1(double x) { return _mm_set1_pd(x); }
+	static vec_t mul(vec_t a, vec_t b) { return _mm_mul_pd(a, b); }	// [SSE2] MULPD.
+	static vec_t or_bits(vec_t a, vec_t b) { return _mm_or_pd(a, b); }	// [SSE2] ORPD.
+	static void store(double* p, vec_t a) { _mm_storeu_pd(p, a); }	// [SSE2] MOVUPD.
+	static vec_t min(vec_t a, vec_t b) { return _mm_min_pd(a, b); }	// [SSE2] MINPD.
+	static vec_t max(vec_t a, vec_t b) { return _mm_max_pd(a, b); }	// [SSE2] MAXPD.
+	static vec_t madd(vec_t a, vec_t b, vec_t c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }	// [SSE2] MULPD + ADDPD.
+};
+
+// 64位整数_SSE2.
+template<> struct SumTraits<int64_t, int64_t, SIMDSUM_ISA_SSE2>
+{
+	typedef __m128i vec_t;
+	static constexpr size_t lanes = 2;
+	static constexpr size_t align = 16;
+	static constexpr bool masked = false;
+	static vec_t zero() { return _mm_setzero_si128(); }	// [SSE2] PXOR.
+	static vec_t load(const int64_t* p) { return _mm_loadu_si128((const __m128i*)p); }	// [SSE2] MOVDQU.
+	static vec_t add(vec_t a, vec_t b) { return _mm_add_epi64(a, b); }	// [SSE2] PADDQ. 64位整数紧缩环绕加法.
+	static int64_t reduce(vec_t a) { const uint64_t* q = (const uint64_t*)&a; return (int64_t)(q[0] + q[1]); }
+	static void leave() {}
+};
+#endif	// #ifdef INTRIN_SSE2
+
+#ifdef INTRIN_SSE4_1
+// 32位整数累加为64位_SSE4.1. 加载时符号扩展.
+template<> struct SumTraits<int32_t, int64_t, SIMDSUM_ISA_SSE41>
+{
+	typedef __m128i vec_t;
+	static constexpr size_t lanes = 2;
+	static constexpr size_t align = 16;
+	static constexpr bool masked = false;
+	static vec_t zero() { return _mm_setzero_si128(); }	// [SSE2] PXOR.
+	static vec_t load(const int32_t* p) { return _mm_cvtepi32_epi64(_mm_loadl_epi64((const __m128i*)p)); }	// [SSE4.1] PMOVSXDQ. 加载2个int32_t并符号扩展.
+	static vec_t add(vec_t a, vec_t b) { return _mm_add_epi64(a, b); }	// [SSE2] PADDQ. 64位整数紧缩加法.
+	static int64_t reduce(vec_t a) { const int64_t* q = (const int64_t*)&a; return q[0] + q[1]; }
+	static void leave() {}
+};
+#endif	// #ifdef INTRIN_SSE4_1
+
+#ifdef INTRIN_AVX
+// 单精度浮点_AVX.
+template<> struct SumTraits<float, float, SIMDSUM_ISA_AVX>
+{
+	typedef __m256 vec_t;
+	static constexpr size_t lanes = 8;
+	static constexpr size_t align = 32;
+	static constexpr bool masked = false;
+	static vec_t zero() { return _mm256_setzero_ps(); }	// [AVX] VXORPS.
+	static vec_t load(const float* p) { return _mm256_loadu_ps(p); }	// [AVX] VMOVUPS.
+	static vec_t add(vec_t a, vec_t b) { return _mm256_add_ps(a, b); }	// [AVX] VADDPS. 单精浮点紧缩加法.
+	static vec_t sub(vec_t a, vec_t b) { return _mm256_sub_ps(a, b); }	// [AVX] VSUBPS.
+	static float reduce(vec_t a) { const float* q = (const float*)&a; return q[0] + q[1] + q[2] + q[3] + q[4] + q[5] + q[6] + q[7]; }
+	static void leave() {}
+	static vec_t loadlast(const float* pend, size_t n) { return _mm256_and_ps(load(pend-8), _mm256_loadu_ps((const float*)(seg_mask32 + n))); }	// [AVX] VANDPS.
+	static void reduce_group(const vec_t* acc, float* pout) { _mm256_storeu_ps(pout, seg_reduce8_ps(acc)); }
+	static vec_t madd(vec_t a, vec_t b, vec_t c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }	// [AVX] VMULPS + VADDPS.
+};
+
+// 双精度浮点_AVX.
+template<> struct SumTraits<double, double, SIMDSUM_ISA_AVX>
+{
+	typedef __m256d vec_t;
+	static constexpr size_t lanes = 4;
+	static constexpr size_t align = 32;
+	static constexpr bool masked = false;
+	static vec_t zero() { return _mm256_setzero_pd(); }	// [AVX] VXORPD.
+	static vec_t load(const double* p) { return _mm256_loadu_pd(p); }	// [AVX] VMOVUPD.
+	static vec_t add(vec_t a, vec_t b) { return _mm256_add_pd(a, b); }	// [AVX] VADDPD. 双精浮点紧缩加法.
+	static vec_t sub(vec_t a, vec_t b) { return _mm256_sub_pd(a, b); }	// [AVX] VSUBPD.
+	static double reduce(vec_t a) { const double* q = (const double*)&a; return q[0] + q[1] + q[2] + q[3]; }
+	static void leave() {}
+	static vec_t loadlast(const double* pend, size_t n) { return _mm256_and_pd(load(pend-4), _mm256_loadu_pd((const double*)(seg_mask64 + n))); }	// [AVX] VANDPD.
+	static void reduce_group(const vec_t* acc, double* pout) { _mm256_storeu_pd(pout, seg_reduce4_pd(acc)); }
+	static vec_t set1(double x) { return _mm256_set1_pd(x); }
+	static vec_t mul(vec_t a, vec_t b) { return _mm256_mul_pd(a, b); }	// [AVX] VMULPD.
+	static vec_t or_bits(vec_t a, vec_t b) { return _mm256_or_pd(a, b); }	// [AVX] VORPD.
+	static void store(double* p, vec_t a) { _mm256_storeu_pd(p, a); }	// [AVX] VMOVUPD.
+	static vec_t min(vec_t a, vec_t b) { return _mm256_min_pd(a, b); }	// [AVX] VMINPD.
+	static vec_t max(vec_t a, vec_t b) { return _mm256_max_pd(a, b); }	// [AVX] VMAXPD.
+	static vec_t madd(vec_t a, vec_t b, vec_t c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }	// [AVX] VMULPD + VADDPD.
+};
+#endif	// #ifdef INTRIN_AVX
+
+#if defined(INTRIN_AVX) && defined(INTRIN_FMA)
+// 单精度浮点_AVX+FMA. 只有乘加不同.
+template<> struct SumTraits<float, float, SIMDSUM_ISA_FMA> : SumTraits<float, float, SIMDSUM_ISA_AVX>
+{
+	static vec_t madd(vec_t a, vec_t b, vec_t c) { return _mm256_fmadd_ps(a, b, c); }	// [FMA] VFMADD231PS.
+};
+
+// 双精度浮点_AVX+FMA.
+template<> struct SumTraits<double, double, SIMDSUM_ISA_FMA> : SumTraits<double, double, SIMDSUM_ISA_AVX>
+{
+	static vec_t madd(vec_t a, vec_t b, vec_t c) { return _mm256_fmadd_pd(a, b, c); }	// [FMA] VFMADD231PD.
+};
+#endif	// #if defined(INTRIN_AVX) && defined(INTRIN_FMA)
+
+#ifdef INTRIN_AVX2
+// 32位整数_AVX2.
+template<> struct SumTraits<int32_t, int32_t, SIMDSUM_ISA_AVX2>
+{
+	typedef __m256i vec_t;
+	static constexpr size_t lanes = 8;
+	static constexpr size_t align = 32;
+	static constexpr bool masked = false;
+	static vec_t zero() { return _mm256_setzero_si256(); }	// [AVX] VPXOR.
+	static vec_t load(const int32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }	// [AVX] VMOVDQU.
+	static vec_t add(vec_t a, vec_t b) { return _mm256_add_epi32(a, b); }	// [AVX2] VPADDD. 32位整数紧缩环绕加法.
+	static int32_t reduce(vec_t a) { const int32_t* q = (const int32_t*)&a; return q[0] + q[1] + q[2] + q[3] + q[4] + q[5] + q[6] + q[7]; }
+	static void leave() {}
+	static vec_t loadlast(const int32_t* pend, size_t n) { return _mm256_and_si256(load(pend-8), _mm256_loadu_si256((const __m256i*)(seg_mask32 + n))); }	// [AVX2] VPAND.
+	static void reduce_group(const vec_t* acc, int32_t* pout) { _mm256_storeu_si256((__m256i*)pout, seg_reduce8_epi32(acc)); }
+};
+
+// 32位整数累加为64位_AVX2. 加载时符号扩展.
+template<> struct SumTraits<int32_t, int64_t, SIMDSUM_ISA_AVX2>
+{
+	typedef __m256i vec_t;
+	static constexpr size_t lanes = 4;
+	static constexpr size_t align = 32;
+	static constexpr bool masked = false;
+	static vec_t zero() { return _mm256_setzero_si256(); }	// [AVX] VPXOR.
+	static vec_t load(const int32_t* p) { return _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)p)); }	// [AVX2] VPMOVSXDQ. 加载4个int32_t并符号扩展.
+	static vec_t add(vec_t a, vec_t b) { return _mm256_add_epi64(a, b); }	// [AVX2] VPADDQ. 64位整数紧缩加法.
+	static int64_t reduce(vec_t a) { const int64_t* q = (const int64_t*)&a; return q[0] + q[1] + q[2] + q[3]; }
+	static void leave() {}
+};
+
+// 64位整数_AVX2.
+template<> struct SumTraits<int64_t, int64_t, SIMDSUM_ISA_AVX2>
+{
+	typedef __m256i vec_t;
+	static constexpr size_t lanes = 4;
+	static constexpr size_t align = 32;
+	static constexpr bool masked = false;
+	static vec_t zero() { return _mm256_setzero_si256(); }	// [AVX] VPXOR.
+	static vec_t load(const int64_t* p) { return _mm256_loadu_si256((const __m256i*)p); }	// [AVX] VMOVDQU.
+	static vec_t add(vec_t a, vec_t b) { return _mm256_add_epi64(a, b); }	// [AVX2] VPADDQ. 64位整数紧缩环绕加法.
+	static int64_t reduce(vec_t a) { const uint64_t* q = (const uint64_t*)&a; return (int64_t)(q[0] + q[1] + q[2] + q[3]); }
+	static void leave() {}
+};
+#endif	// #ifdef INTRIN_AVX2
+
+#ifdef INTRIN_AVX512F
+// 32位整数_AVX-512.
+template<> struct SumTraits<int32_t, int32_t, SIMDSUM_ISA_AVX512>
+{
+	typedef __m512i vec_t;
+	static constexpr size_t lanes = 16;
+	static constexpr size_t align = 64;
+	static constexpr bool masked = true;
+	static vec_t zero() { return _mm512_setzero_si512(); }	// [AVX-512F] VPXORD.
+	static vec_t load(const int32_t* p) { return _mm512_loadu_si512(p); }	// [AVX-512F] VMOVDQU32.
+	static vec_t loadmask(const int32_t* p, size_t n) { return _mm512_maskz_loadu_epi32((__mmask16)((1U<<n) - 1), p); }	// [AVX-512F] VMOVDQU32 {k}{z}. 被屏蔽的元素不会访问内存.
+	static vec_t add(vec_t a, vec_t b) { return _mm512_add_epi32(a, b); }	// [AVX-512F] VPADDD. 32位整数紧缩环绕加法.
+	static int32_t reduce(vec_t a) { return _mm512_reduce_add_epi32(a); }	// [AVX-512F] 序列指令, 水平求和.
+	static void leave() {}
+	static void reduce_group(const vec_t* acc, int32_t* pout)
+	{
+		__m256i y[16];	// 各向量的高低半部之和.
+		for(size_t i=0; i<16; ++i)	y[i] = _mm256_add_epi32(_mm512_castsi512_si256(acc[i]), _mm512_extracti64x4_epi64(acc[i], 1));	// [AVX-512F] VEXTRACTI64X4.
+		_mm256_storeu_si256((__m256i*)pout, seg_reduce8_epi32(y));
+		_mm256_storeu_si256((__m256i*)(pout+8), seg_reduce8_epi32(y+8));
+	}
+};
+
+// 单精度浮点_AVX-512.
+template<> struct SumTraits<float, float, SIMDSUM_ISA_AVX512>
+{
+	typedef __m512 vec_t;
+	static constexpr size_t lanes = 16;
+	static constexpr size_t align = 64;
+	static constexpr bool masked = true;
+	static vec_t zero() { return _mm512_setzero_ps(); }	// [AVX-512F] VXORPS.
+	static vec_t load(const float* p) { return _mm512_loadu_ps(p); }	// [AVX-512F] VMOVUPS.
+	static vec_t loadmask(const float* p, size_t n) { return _mm512_maskz_loadu_ps((__mmask16)((1U<<n) - 1), p); }	// [AVX-512F] VMOVUPS {k}{z}.
+	static vec_t add(vec_t a, vec_t b) { return _mm512_add_ps(a, b); }	// [AVX-512F] VADDPS. 单精浮点紧缩加法.
+	static vec_t sub(vec_t a, vec_t b) { return _mm512_sub_ps(a, b); }	// [AVX-512F] VSUBPS.
+	static float reduce(vec_t a) { return _mm512_reduce_add_ps(a); }	// [AVX-512F] 序列指令, 水平求和.
+	static void leave() {}
+	static void reduce_group(const vec_t* acc, float* pout)
+	{
+		__m256 y[16];	// 各向量的高低半部之和.
+		for(size_t i=0; i<16; ++i)	y[i] = _mm256_add_ps(_mm512_castps512_ps256(acc[i]), _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(acc[i]), 1)));	// [AVX-512F] VEXTRACTF64X4.
+		_mm256_storeu_ps(pout, seg_reduce8_ps(y));
+		_mm256_storeu_ps(pout+8, seg_reduce8_ps(y+8));
+	}
+};
+
+// 双精度浮点_AVX-512.
+template<> struct SumTraits<double, double, SIMDSUM_ISA_AVX512>
+{
+	typedef __m512d vec_t;
+	static constexpr size_t lanes = 8;
+	static constexpr size_t align = 64;
+	static constexpr bool masked = true;
+	static vec_t zero() { return _mm512_setzero_pd(); }	// [AVX-512F] VXORPD.
+	static vec_t load(const double* p) { return _mm512_loadu_pd(p); }	// [AVX-512F] VMOVUPD.
+	static vec_t loadmask(const double* p, size_t n) { return _mm512_maskz_loadu_pd((__mmask8)((1U<<n) - 1), p); }	// [AVX-512F] VMOVUPD {k}{z}.
+	static vec_t add(vec_t a, vec_t b) { return _mm512_add_pd(a, b); }	// [AVX-512F] VADDPD. 双精浮点紧缩加法.
+	static vec_t sub(vec_t a, vec_t b) { return _mm512_sub_pd(a, b); }	// [AVX-512F] VSUBPD.
+	static double reduce(vec_t a) { return _mm512_reduce_add_pd(a); }	// [AVX-512F] 序列指令, 水平求和.
+	static void leave() {}
+	static void reduce_group(const vec_t* acc, double* pout)
+	{
+		__m256d y[8];	// 各向量的高低半部之和.
+		for(size_t i=0; i<8; ++i)	y[i] = _mm256_add_pd(_mm512_castpd512_pd256(acc[i]), _mm512_extractf64x4_pd(acc[i], 1));	// [AVX-512F] VEXTRACTF64X4.
+		_mm256_storeu_pd(pout, seg_reduce4_pd(y));
+		_mm256_storeu_pd(pout+4, seg_reduce4_pd(y+4));
+	}
+	static vec_t set1(double x) { return _mm512_set1_pd(x); }
+	static vec_t mul(vec_t a, vec_t b) { return _mm512_mul_pd(a, b); }	// [AVX-512F] VMULPD.
+	static vec_t or_bits(vec_t a, vec_t b) { return _mm512_or_pd(a, b); }	// [AVX-512DQ] VORPD.
+	static void store(double* p, vec_t a) { _mm512_storeu_pd(p, a); }	// [AVX-512F] VMOVUPD.
+	static vec_t min(vec_t a, vec_t b) { return _mm512_min_pd(a, b); }	// [AVX-512F] VMINPD.
+	static vec_t max(vec_t a, vec_t b) { return _mm512_max_pd(a, b); }	// [AVX-512F] VMAXPD.
+	static vec_t madd(vec_t a, vec_t b, vec_t c) { return _mm512_fmadd_pd(a, b, c); }	// [AVX-512F] VFMADD231PD.
+};
+
+// 64位整数_AVX-512.
+template<> struct SumTraits<int64_t, int64_t, SIMDSUM_ISA_AVX512>
+{
+	typedef __m512i vec_t;
+	static constexpr size_t lanes = 8;
+	static constexpr size_t align = 64;
+	static constexpr bool masked = true;
+	static vec_t zero() { return _mm512_setzero_si512(); }	// [AVX-512F] VPXORQ.
+	static vec_t load(const int64_t* p) { return _mm512_loadu_si512(p); }	// [AVX-512F] VMOVDQU64.
+	static vec_t loadmask(const int64_t* p, size_t n) { return _mm512_maskz_loadu_epi64((__mmask8)((1U<<n) - 1), p); }	// [AVX-512F] VMOVDQU64 {k}{z}.
+	static vec_t add(vec_t a, vec_t b) { return _mm512_add_epi64(a, b); }	// [AVX-512F] VPADDQ. 64位整数紧缩环绕加法.
+	static int64_t reduce(vec_t a) { return _mm512_reduce_add_epi64(a); }	// [AVX-512F] 序列指令, 水平求和.
+	static void leave() {}
+};
+#endif	// #ifdef INTRIN_AVX512F
+
+// 16位浮点的元素类型. 布局与uint16_t相同, 只用于选择 SumTraits 的特化. 逐个处理时转为float.
+struct half_t
+{
+	uint16_t u;
+	operator float() const { return simdsum_f16_to_f32(u); }
+};
+struct bf16_t
+{
+	uint16_t u;
+	operator float() const { return simdsum_bf16_to_f32(u); }
+};
+
+// 16位浮点累加为单精度. 都继承同一指令集的单精度特化, 只换掉加载（及对齐、掩码加载）.
+// bf16与0交错（PUNPCKLWD/PUNPCKHWD, 0在低16位）之后, 每个32位通道就是对应的float, 无需移位.
+// 交错只在各128位内进行, 通道的顺序被打乱, 但求和与顺序无关. 两半加载后先相加, 故lanes为float的2倍.
+
+#ifdef INTRIN_SSE2
+// bfloat16_SSE2.
+template<> struct SumTraits<bf16_t, float, SIMDSUM_ISA_SSE2> : SumTraits<float, float, SIMDSUM_ISA_SSE>
+{
+	static constexpr size_t lanes = 8;
+	static vec_t load(const bf16_t* p)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i*)p);	// [SSE2] MOVDQU.
+		__m128i z = _mm_setzero_si128();
+		return _mm_add_ps(_mm_castsi128_ps(_mm_unpacklo_epi16(z, x)), _mm_castsi128_ps(_mm_unpackhi_epi16(z, x)));	// [SSE2] PUNPCKLWD/PUNPCKHWD.
+	}
+};
+#endif	// #ifdef INTRIN_SSE2
+
+#if defined(INTRIN_AVX) && defined(INTRIN_F16C)
+// 半精度浮点_F16C. 一次转换8个, 只加载16字节.
+template<> struct SumTraits<half_t, float, SIMDSUM_ISA_F16C> : SumTraits<float, float, SIMDSUM_ISA_AVX>
+{
+	static constexpr size_t align = 16;
+	static vec_t load(const half_t* p) { return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)p)); }	// [F16C] VCVTPH2PS.
+};
+#endif	// #if defined(INTRIN_AVX) && defined(INTRIN_F16C)
+
+#ifdef INTRIN_AVX2
+// bfloat16_AVX2.
+template<> struct SumTraits<bf16_t, float, SIMDSUM_ISA_AVX2> : SumTraits<float, float, SIMDSUM_ISA_AVX>
+{
+	static constexpr size_t lanes = 16;
+	static vec_t load(const bf16_t* p)
+	{
+		__m256i x = _mm256_loadu_si256((const __m256i*)p);	// [AVX] VMOVDQU.
+		__m256i z = _mm256_setzero_si256();
+		return _mm256_add_ps(_mm256_castsi256_ps(_mm256_unpacklo_epi16(z, x)), _mm256_castsi256_ps(_mm256_unpackhi_epi16(z, x)));	// [AVX2] VPUNPCKLWD/VPUNPCKHWD.
+	}
+};
+#endif	// #ifdef INTRIN_AVX2
+
+#if defined(INTRIN_AVX512F) && defined(INTRIN_AVX512BW)
+// 半精度浮点_AVX-512. 掩码加载按16位元素屏蔽, 需要AVX-512BW.
+template<> struct SumTraits<half_t, float, SIMDSUM_ISA_AVX512> : SumTraits<float, float, SIMDSUM_ISA_AVX512>
+{
+	static constexpr size_t align = 32;
+	static vec_t load(const half_t* p) { return _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)p)); }	// [AVX-512F] VCVTPH2PS.
+	static vec_t loadmask(const half_t* p, size_t n) { return _mm512_cvtph_ps(_mm512_castsi512_si256(_mm512_maskz_loadu_epi16((__mmask32)((1U<<n) - 1), p))); }	// [AVX-512BW] VMOVDQU16 {k}{z}.
+};
+
+// bfloat16_AVX-512.
+template<> struct SumTraits<bf16_t, float, SIMDSUM_ISA_AVX512> : SumTraits<float, float, SIMDSUM_ISA_AVX512>
+{
+	static constexpr size_t lanes = 32;
+	static vec_t unpack(__m512i x)
+	{
+		__m512i z = _mm512_setzero_si512();
+		return _mm512_add_ps(_mm512_castsi512_ps(_mm512_unpacklo_epi16(z, x)), _mm512_castsi512_ps(_mm512_unpackhi_epi16(z, x)));	// [AVX-512BW] VPUNPCKLWD/VPUNPCKHWD.
+	}
+	static vec_t load(const bf16_t* p) { return unpack(_mm512_loadu_si512(p)); }	// [AVX-512F] VMOVDQU32.
+	static vec_t loadmask(const bf16_t* p, size_t n) { return unpack(_mm512_maskz_loadu_epi16((__mmask32)((1U<<n) - 1), p)); }	// [AVX-512BW] VMOVDQU16 {k}{z}.
+};
+#endif	// #if defined(INTRIN_AVX512F) && defined(INTRIN_AVX512BW)
+
+
+////////////////////////////////////////
+// sum_kernel: 数组求和.
+////////////////////////////////////////
+
+// 批量处理一块: 每路累加器各加一个向量. 用参数包在编译期展开.
+template<typename Tr, typename T, size_t... I>
+inline void sum_step(typename Tr::vec_t* acc, const T* p, std::index_sequence<I...>)
+{
+	((acc[I] = Tr::add(acc[I], Tr::load(p + I*Tr::lanes))), ...);
+}
+
+// 两两合并N个累加器. 编译期递归, 4个时的顺序为 (0~1), (2~3), (0~3).
+template<typename Tr, size_t N>
+inline typename Tr::vec_t sum_merge(const typename Tr::vec_t* acc)
+{
+	if constexpr (N==1)	return acc[0];
+	else	return Tr::add(sum_merge<Tr, N/2>(acc), sum_merge<Tr, N-N/2>(acc + N/2));
+}
+
+// 不预取. sum_kernel 的PF参数.
+constexpr int SUM_PF_NONE = -1;
+
+// 数组求和. 先处理未对齐的开头, 再用UNROLL个累加器循环展开批量处理, 最后处理剩下的.
+//
+// T: 元素类型. A: 累加类型. ISA: 指令集级别. UNROLL: 循环展开次数.
+// PF: 软件预取的提示, 例如 _MM_HINT_T0、_MM_HINT_NTA（GCC下为枚举, 故用auto）. 为SUM_PF_NONE时不预取, 只依赖硬件预取.
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址. 可以是任意地址.
+// cntbuf: 数组长度.
+// cbdist: 预取距离（字节）. 批量处理每一块时, 预取其后cbdist字节处的各缓存行. 预取越过数组末尾也不会出错.
+// cbline: 缓存行大小（字节）.
+template<typename T, typename A, int ISA, size_t UNROLL, auto PF = SUM_PF_NONE>
+A sum_kernel(const T* pbuf, size_t cntbuf, size_t cbdist = 0, size_t cbline = SIMDSUM_CACHELINE)
+{
+	typedef SumTraits<T, A, ISA> Tr;
+	typedef typename Tr::vec_t V;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	A s = 0;	// 求和变量.
+	size_t i;
+	size_t cntHead = SIMDSUM_HEADCNT(pbuf, cntbuf, Tr::align);	// 开头未对齐的数量.
+	size_t cntBlock = (cntbuf-cntHead) / nBlockWidth;	// 块数.
+	size_t cntRem = (cntbuf-cntHead) % nBlockWidth;	// 剩余数量.
+	V acc[UNROLL];	// 求和变量. 多个累加器以掩盖加法延迟.
+	const T* p = pbuf+cntHead;	// 批量处理时所用的指针.
+	static_assert(UNROLL>=1, "UNROLL must be positive.");
+
+	for(i=0; i<UNROLL; ++i)	acc[i] = Tr::zero();
+	if constexpr (Tr::masked)	// 处理开头未对齐的. 用掩码加载, 之后的批量处理都是对齐的.
+	{
+		acc[0] = Tr::add(acc[0], Tr::loadmask(pbuf, cntHead));
+	}
+
+	// 批量处理.
+	for(i=0; i<cntBlock; ++i)
+	{
+		if constexpr (PF != SUM_PF_NONE)
+		{
+			for(size_t k=0; k<nBlockWidth*sizeof(T); k+=cbline)	_mm_prefetch((const char*)p + cbdist + k, PF);	// [SSE] PREFETCHh.
+		}
+		sum_step<Tr>(acc, p, std::make_index_sequence<UNROLL>());
+		p += nBlockWidth;
+	}
+	// 处理剩下的完整向量.
+	for(i=0; i<cntRem/Tr::lanes; ++i)
+	{
+		acc[0] = Tr::add(acc[0], Tr::load(p));
+		p += Tr::lanes;
+	}
+	cntRem %= Tr::lanes;
+	if constexpr (Tr::masked)	// 最后不足一个向量的部分用掩码加载.
+	{
+		acc[UNROLL-1] = Tr::add(acc[UNROLL-1], Tr::loadmask(p, cntRem));
+	}
+
+	// 合并.
+	s = Tr::reduce(sum_merge<Tr, UNROLL>(acc));
+
+	if constexpr (!Tr::masked)	// 不支持掩码时逐个处理.
+	{
+		// 处理开头未对齐的.
+		for(i=0; i<cntHead; ++i)
+		{
+			s += sum_get(pbuf+i);
+		}
+
+		// 处理剩下的.
+		for(i=0; i<cntRem; ++i)
+		{
+			s += sum_get(p+i);
+		}
+	}
+
+	Tr::leave();
+	return s;
+}
+
+
+////////////////////////////////////////
+// sum_narrow: 8位、16位整数数组求和.
+////////////////////////////////////////
+
+// 窄整数求和的向量操作. T为元素类型, ISA为指令集级别. 特化需提供:
+//   vec_t: 向量类型.
+//   lanes: 每个向量的元素数.
+//   flush: 每段最多累加的向量数（每路累加器）, 之后用widen转为64位. 为0表示累加器本身就是64位通道, 无需分段.
+//   bias: 加载时给每个元素加的偏置. 结果再减去 bias×批量处理的元素数.
+//   zero(): 全0向量.
+//   step(acc, p): 加载lanes个元素, 加宽后加到acc.
+//   widen(a): 把一段的累加器转为64位通道.
+//   add64(a, b): 64位通道相加.
+//   reduce(a): 64位通道水平求和.
+// 8位用PSADBW: 与0求绝对差之和, 即每8个字节之和, 直接得到64位通道, 每个向量只需一条指令.
+// 有符号8位先把符号位取反（异或0x80）, 即加上128变为无符号, 同样用PSADBW; 比PMADDUBSW（需要SSSE3, 之后还需PMADDWD）更少.
+// 16位用PMADDWD与全1相乘, 得到相邻两个元素之和（32位）. 每个通道每次最多增加65536, 故每段不超过16384个向量.
+template<typename T, int ISA> struct NarrowTraits;
+
+#ifdef INTRIN_SSE2
+// 8位_SSE2的公共部分.
+struct NarrowTraitsSse2Sad
+{
+	typedef __m128i vec_t;
+	static constexpr size_t lanes = 16;
+	static constexpr size_t flush = 0;
+	static vec_t zero() { return _mm_setzero_si128(); }	// [SSE2] PXOR.
+	static vec_t widen(vec_t a) { return a; }
+	static vec_t add64(vec_t a, vec_t b) { return _mm_add_epi64(a, b); }	// [SSE2] PADDQ.
+	static uint64_t reduce(vec_t a) { uint64_t q[2]; _mm_storeu_si128((__m128i*)q, a); return q[0] + q[1]; }
+};
+
+// 无符号8位_SSE2.
+template<> struct NarrowTraits<uint8_t, SIMDSUM_ISA_SSE2> : NarrowTraitsSse2Sad
+{
+	static constexpr int bias = 0;
+	static vec_t step(vec_t acc, const uint8_t* p) { return _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128((const __m128i*)p), _mm_setzero_si128())); }	// [SSE2] PSADBW.
+};
+
+// 有符号8位_SSE2.
+template<> struct NarrowTraits<int8_t, SIMDSUM_ISA_SSE2> : NarrowTraitsSse2Sad
+{
+	static constexpr int bias = 128;
+	static vec_t step(vec_t acc, const int8_t* p) { return _mm_add_epi64(acc, _mm_sad_epu8(_mm_xor_si128(_mm_loadu_si128((const __m128i*)p), _mm_set1_epi8((char)0x80)), _mm_setzero_si128())); }	// [SSE2] PXOR, PSADBW.
+};
+
+// 有符号16位_SSE2.
+template<> struct NarrowTraits<int16_t, SIMDSUM_ISA_SSE2>
+{
+	typedef __m128i vec_t;
+	static constexpr size_t lanes = 8;
+	static constexpr size_t flush = 16384;
+	static constexpr int bias = 0;
+	static vec_t zero() { return _mm_setzero_si128(); }	// [SSE2] PXOR.
+	static vec_t step(vec_t acc, const int16_t* p) { return _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)p), _mm_set1_epi16(1))); }	// [SSE2] PMADDWD.
+	static vec_t widen(vec_t a)	// SSE2没有PMOVSXDQ, 与符号位交错来符号扩展.
+	{
+		__m128i sign = _mm_srai_epi32(a, 31);	// [SSE2] PSRAD.
+		return _mm_add_epi64(_mm_unpacklo_epi32(a, sign), _mm_unpackhi_epi32(a, sign));	// [SSE2] PUNPCKLDQ/PUNPCKHDQ.
+	}
+	static vec_t add64(vec_t a, vec_t b) { return _mm_add_epi64(a, b); }	// [SSE2] PADDQ.
+	static uint64_t reduce(vec_t a) { uint64_t q[2]; _mm_storeu_si128((__m128i*)q, a); return q[0] + q[1]; }
+};
+#endif	// #ifdef INTRIN_SSE2
+
+#ifdef INTRIN_AVX2
+// 8位_AVX2的公共部分.
+struct NarrowTraitsAvx2Sad
+{
+	typedef __m256i vec_t;
+	static constexpr size_t lanes = 32;
+	static constexpr size_t flush = 0;
+	static vec_t zero() { return _mm256_setzero_si256(); }	// [AVX] VPXOR.
+	static vec_t widen(vec_t a) { return a; }
+	static vec_t add64(vec_t a, vec_t b) { return _mm256_add_epi64(a, b); }	// [AVX2] VPADDQ.
+	static uint64_t reduce(vec_t a) { uint64_t q[4]; _mm256_storeu_si256((__m256i*)q, a); return q[0] + q[1] + q[2] + q[3]; }
+};
+
+// 无符号8位_AVX2.
+template<> struct NarrowTraits<uint8_t, SIMDSUM_ISA_AVX2> : NarrowTraitsAvx2Sad
+{
+	static constexpr int bias = 0;
+	static vec_t step(vec_t acc, const uint8_t* p) { return _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i*)p), _mm256_setzero_si256())); }	// [AVX2] VPSADBW.
+};
+
+// 有符号8位_AVX2.
+template<> struct NarrowTraits<int8_t, SIMDSUM_ISA_AVX2> : NarrowTraitsAvx2Sad
+{
+	static constexpr int bias = 128;
+	static vec_t step(vec_t acc, const int8_t* p) { return _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_xor_si256(_mm256_loadu_si256((const __m256i*)p), _mm256_set1_epi8((char)0x80)), _mm256_setzero_si256())); }	// [AVX2] VPXOR, VPSADBW.
+};
+
+// 有符号16位_AVX2.
+template<> struct NarrowTraits<int16_t, SIMDSUM_ISA_AVX2>
+{
+	typedef __m256i vec_t;
+	static constexpr size_t lanes = 16;
+	static constexpr size_t flush = 16384;
+	static constexpr int bias = 0;
+	static vec_t zero() { return _mm256_setzero_si256(); }	// [AVX] VPXOR.
+	static vec_t step(vec_t acc, const int16_t* p) { return _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)p), _mm256_set1_epi16(1))); }	// [AVX2] VPMADDWD.
+	static vec_t widen(vec_t a) { return _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(a)), _mm256_cvtepi32_epi64(_mm256_extracti128_si256(a, 1))); }	// [AVX2] VPMOVSXDQ.
+	static vec_t add64(vec_t a, vec_t b) { return _mm256_add_epi64(a, b); }	// [AVX2] VPADDQ.
+	static uint64_t reduce(vec_t a) { uint64_t q[4]; _mm256_storeu_si256((__m256i*)q, a); return q[0] + q[1] + q[2] + q[3]; }
+};
+#endif	// #ifdef INTRIN_AVX2
+
+// 批量处理一块: 每路累加器各加一个向量.
+template<typename Tr, typename T, size_t... I>
+inline void narrow_step(typename Tr::vec_t* acc, const T* p, std::index_sequence<I...>)
+{
+	((acc[I] = Tr::step(acc[I], p + I*Tr::lanes)), ...);
+}
+
+// 窄整数数组求和. 结构与 sum_kernel 相同, 批量处理按Tr::flush分段, 每段结束时把各累加器转为64位, 故不会溢出.
+//
+// T: 元素类型. R: 结果类型（64位）. ISA: 指令集级别. UNROLL: 循环展开次数.
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址. 可以是任意地址.
+// cntbuf: 数组长度.
+template<typename T, typename R, int ISA, size_t UNROLL>
+R sum_narrow(const T* pbuf, size_t cntbuf)
+{
+	typedef NarrowTraits<T, ISA> Tr;
+	typedef typename Tr::vec_t V;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	R s = 0;	// 求和变量.
+	size_t i;
+	size_t cntHead = SIMDSUM_HEADCNT(pbuf, cntbuf, sizeof(V));	// 开头未对齐的数量.
+	size_t cntBlock = (cntbuf-cntHead) / nBlockWidth;	// 块数.
+	size_t cntRem = (cntbuf-cntHead) % nBlockWidth;	// 剩余数量.
+	size_t cntSeg;	// 本段的块数.
+	V acc[UNROLL];	// 求和变量. 段内的累加器.
+	V total = Tr::zero();	// 64位总和.
+	const T* p = pbuf+cntHead;	// 批量处理时所用的指针.
+
+	// 批量处理. 分段进行.
+	while(cntBlock>0)
+	{
+		cntSeg = (0==Tr::flush || cntBlock<Tr::flush) ? cntBlock : Tr::flush;
+		cntBlock -= cntSeg;
+		for(i=0; i<UNROLL; ++i)	acc[i] = Tr::zero();
+		for(i=0; i<cntSeg; ++i)
+		{
+			narrow_step<Tr>(acc, p, std::make_index_sequence<UNROLL>());
+			p += nBlockWidth;
+		}
+		for(i=0; i<UNROLL; ++i)	total = Tr::add64(total, Tr::widen(acc[i]));
+	}
+	// 处理剩下的完整向量. 不足一段.
+	acc[0] = Tr::zero();
+	for(i=0; i<cntRem/Tr::lanes; ++i)
+	{
+		acc[0] = Tr::step(acc[0], p);
+		p += Tr::lanes;
+	}
+	total = Tr::add64(total, Tr::widen(acc[0]));
+	cntRem %= Tr::lanes;
+
+	// 合并, 并去掉偏置.
+	s = (R)(Tr::reduce(total) - (uint64_t)Tr::bias * (uint64_t)(p - (pbuf+cntHead)));
+
+	// 处理开头未对齐的.
+	for(i=0; i<cntHead; ++i)
+	{
+		s += sum_get(pbuf+i);
+	}
+
+	// 处理剩下的.
+	for(i=0; i<cntRem; ++i)
+	{
+		s += sum_get(p+i);
+	}
+
+	return s;
+}
+
+////////////////////////////////////////
+// sum_carry: 无符号64位整数数组求和, 统计进位.
+////////////////////////////////////////
+
+// 带进位累加的向量操作. ISA为指令集级别. 特化需提供:
+//   vec_t: 向量类型. 每个通道为一个uint64_t.
+//   lanes: 每个向量的元素数.
+//   align: 批量处理时的对齐字节数.
+//   zero(): 全0向量. 进位计数的初值.
+//   sinit(): 和的初值. 可以是带偏置的表示.
+//   load(p): 加载lanes个元素. 不要求对齐.
+//   addc(s, c, x): s += x, 各通道产生进位时c加1.
+//   sfinal(s): 把和转回无偏置的表示.
+//   store(q, a): 存储lanes个元素.
+template<int ISA> struct CarryTraits;
+
+#ifdef INTRIN_SSE2
+// 带进位累加_SSE2. SSE2没有64位比较, 由和与两个加数的最高位推出进位: (s & x) | ((s | x) & ~t).
+template<> struct CarryTraits<SIMDSUM_ISA_SSE2>
+{
+	typedef __m128i vec_t;
+	static constexpr size_t lanes = 2;
+	static constexpr size_t align = 16;
+	static vec_t zero() { return _mm_setzero_si128(); }	// [SSE2] PXOR.
+	static vec_t sinit() { return _mm_setzero_si128(); }
+	static vec_t load(const uint64_t* p) { return _mm_loadu_si128((const __m128i*)p); }	// [SSE2] MOVDQU.
+	static void addc(vec_t& s, vec_t& c, vec_t x)
+	{
+		vec_t t = _mm_add_epi64(s, x);	// [SSE2] PADDQ.
+		vec_t cy = _mm_or_si128(_mm_and_si128(s, x), _mm_andnot_si128(t, _mm_or_si128(s, x)));	// [SSE2] PAND, POR, PANDN. 最高位为进位.
+		c = _mm_add_epi64(c, _mm_srli_epi64(cy, 63));	// [SSE2] PSRLQ.
+		s = t;
+	}
+	static vec_t sfinal(vec_t s) { return s; }
+	static void store(uint64_t* q, vec_t a) { _mm_storeu_si128((__m128i*)q, a); }	// [SSE2] MOVDQU.
+};
+#endif	// #ifdef INTRIN_SSE2
+
+#ifdef INTRIN_AVX2
+// 带进位累加_AVX2. VPCMPGTQ是有符号比较, 故和以“异或最高位”的偏置形式保存: (s^m)+x == (s+x)^m,
+// 于是只需对x异或一次, 有符号比较 (t^m) < (x^m) 即为无符号的 t < x, 也就是产生了进位. 比较结果为-1, 用减法计数.
+template<> struct CarryTraits<SIMDSUM_ISA_AVX2>
+{
+	typedef __m256i vec_t;
+	static constexpr size_t lanes = 4;
+	static constexpr size_t align = 32;
+	static vec_t zero() { return _mm256_setzero_si256(); }	// [AVX] VPXOR.
+	static vec_t sinit() { return _mm256_set1_epi64x(INT64_MIN); }
+	static vec_t load(const uint64_t* p) { return _mm256_loadu_si256((const __m256i*)p); }	// [AVX] VMOVDQU.
+	static void addc(vec_t& s, vec_t& c, vec_t x)
+	{
+		s = _mm256_add_epi64(s, x);	// [AVX2] VPADDQ.
+		c = _mm256_sub_epi64(c, _mm256_cmpgt_epi64(_mm256_xor_si256(x, sinit()), s));	// [AVX2] VPXOR, VPCMPGTQ, VPSUBQ.
+	}
+	static vec_t sfinal(vec_t s) { return _mm256_xor_si256(s, sinit()); }
+	static void store(uint64_t* q, vec_t a) { _mm256_storeu_si256((__m256i*)q, a); }	// [AVX] VMOVDQU.
+};
+#endif	// #ifdef INTRIN_AVX2
+
+#ifdef INTRIN_AVX512F
+// 带进位累加_AVX-512. 有无符号比较, 结果为掩码, 只给产生进位的通道加1.
+template<> struct CarryTraits<SIMDSUM_ISA_AVX512>
+{
+	typedef __m512i vec_t;
+	static constexpr size_t lanes = 8;
+	static constexpr size_t align = 64;
+	static vec_t zero() { return _mm512_setzero_si512(); }	// [AVX-512F] VPXORQ.
+	static vec_t sinit() { return _mm512_setzero_si512(); }
+	static vec_t load(const uint64_t* p) { return _mm512_loadu_si512(p); }	// [AVX-512F] VMOVDQU64.
+	static void addc(vec_t& s, vec_t& c, vec_t x)
+	{
+		s = _mm512_add_epi64(s, x);	// [AVX-512F] VPADDQ.
+		c = _mm512_mask_add_epi64(c, _mm512_cmplt_epu64_mask(s, x), c, _mm512_set1_epi64(1));	// [AVX-512F] VPCMPUQ, VPADDQ {k}.
+	}
+	static vec_t sfinal(vec_t s) { return s; }
+	static void store(uint64_t* q, vec_t a) { _mm512_storeu_si512(q, a); }	// [AVX-512F] VMOVDQU64.
+};
+#endif	// #ifdef INTRIN_AVX512F
+
+// 标量的带进位加法.
+inline void carry_add(uint64_t& s, uint64_t& c, uint64_t x)
+{
+	s += x;
+	c += (s < x);
+}
+
+// 批量处理一块: 每路累加器各加一个向量.
+template<typename Tr, size_t... I>
+inline void carry_step(typename Tr::vec_t* acc, typename Tr::vec_t* cy, const uint64_t* p, std::index_sequence<I...>)
+{
+	(Tr::addc(acc[I], cy[I], Tr::load(p + I*Tr::lanes)), ...);
+}
+
+// 无符号64位整数数组求和. 每个通道各有一个进位计数, 合并时按128位相加, 故结果是精确的: 总和 = 进位×2^64 + 返回值.
+//
+// ISA: 指令集级别. UNROLL: 循环展开次数.
+// result: 返回总和的低64位.
+// pbuf: 数组的首地址. 可以是任意地址.
+// cntbuf: 数组长度.
+// pcarry: 返回总和的高64位, 即进位次数. 非0表示64位结果已溢出. 可以为NULL.
+template<int ISA, size_t UNROLL>
+uint64_t sum_carry(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry)
+{
+	typedef CarryTraits<ISA> Tr;
+	typedef typename Tr::vec_t V;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	uint64_t s = 0;	// 求和变量.
+	uint64_t c = 0;	// 进位次数.
+	size_t i, k;
+	size_t cntHead = SIMDSUM_HEADCNT(pbuf, cntbuf, Tr::align);	// 开头未对齐的数量.
+	size_t cntBlock = (cntbuf-cntHead) / nBlockWidth;	// 块数.
+	size_t cntRem = (cntbuf-cntHead) % nBlockWidth;	// 剩余数量.
+	V acc[UNROLL];	// 和.
+	V cy[UNROLL];	// 进位计数.
+	uint64_t q[Tr::lanes];	// 合并时的各通道.
+	const uint64_t* p = pbuf+cntHead;	// 批量处理时所用的指针.
+
+	for(i=0; i<UNROLL; ++i)
+	{
+		acc[i] = Tr::sinit();
+		cy[i] = Tr::zero();
+	}
+
+	// 批量处理.
+	for(i=0; i<cntBlock; ++i)
+	{
+		carry_step<Tr>(acc, cy, p, std::make_index_sequence<UNROLL>());
+		p += nBlockWidth;
+	}
+	// 处理剩下的完整向量.
+	for(i=0; i<cntRem/Tr::lanes; ++i)
+	{
+		Tr::addc(acc[0], cy[0], Tr::load(p));
+		p += Tr::lanes;
+	}
+	cntRem %= Tr::lanes;
+
+	// 合并. 各通道的和逐个带进位相加.
+	for(i=0; i<UNROLL; ++i)
+	{
+		Tr::store(q, Tr::sfinal(acc[i]));
+		for(k=0; k<Tr::lanes; ++k)	carry_add(s, c, q[k]);
+		Tr::store(q, cy[i]);
+		for(k=0; k<Tr::lanes; ++k)	c += q[k];
+	}
+
+	// 处理开头未对齐的.
+	for(i=0; i<cntHead; ++i)
+	{
+		carry_add(s, c, pbuf[i]);
+	}
+
+	// 处理剩下的.
+	for(i=0; i<cntRem; ++i)
+	{
+		carry_add(s, c, p[i]);
+	}
+
+	if (NULL!=pcarry)	*pcarry = c;
+	return s;
+}
+
+
+////////////////////////////////////////
+// sum_where: 带条件的求和.
+////////////////////////////////////////
+
+// 条件求和的向量操作. 沿用 SumTraits 的加载、加法与水平求和, 另需提供:
+//   set1(x): 各通道均为x.
+//   select<FLAGS>(x, k, lo, hi): key（k）满足区间条件的通道保留x, 其余为0. FLAGS为SIMDSUM_WHERE_常数的组合.
+template<typename T, int ISA> struct WhereTraits;
+
+#ifdef INTRIN_SSE
+// 单精度浮点_SSE. 各种比较都有, 且对NaN均为假.
+template<> struct WhereTraits<float, SIMDSUM_ISA_SSE> : SumTraits<float, float, SIMDSUM_ISA_SSE>
+{
+	static vec_t set1(float x) { return _mm_set1_ps(x); }
+	template<int FLAGS> static vec_t select(vec_t x, vec_t k, vec_t lo, vec_t hi)
+	{
+		vec_t mlo = (FLAGS & SIMDSUM_WHERE_LO_OPEN) ? _mm_cmpgt_ps(k, lo) : _mm_cmpge_ps(k, lo);	// [SSE] CMPLTPS/CMPLEPS（交换操作数）.
+		vec_t mhi = (FLAGS & SIMDSUM_WHERE_HI_CLOSED) ? _mm_cmple_ps(k, hi) : _mm_cmplt_ps(k, hi);	// [SSE] CMPLEPS/CMPLTPS.
+		return _mm_and_ps(_mm_and_ps(mlo, mhi), x);	// [SSE] ANDPS.
+	}
+};
+#endif	// #ifdef INTRIN_SSE
+
+#ifdef INTRIN_SSE2
+// 32位整数_SSE2. 只有“大于”比较. 含等号的边界改为判断不满足的一侧（k<lo, k>hi）, 再用PANDN清除.
+template<> struct WhereTraits<int32_t, SIMDSUM_ISA_SSE2> : SumTraits<int32_t, int32_t, SIMDSUM_ISA_SSE2>
+{
+	static vec_t set1(int32_t x) { return _mm_set1_epi32(x); }
+	template<int FLAGS> static vec_t select(vec_t x, vec_t k, vec_t lo, vec_t hi)
+	{
+		constexpr bool loopen = 0!=(FLAGS & SIMDSUM_WHERE_LO_OPEN);
+		constexpr bool hiclosed = 0!=(FLAGS & SIMDSUM_WHERE_HI_CLOSED);
+		vec_t mlo = loopen ? _mm_cmpgt_epi32(k, lo) : _mm_cmpgt_epi32(lo, k);	// [SSE2] PCMPGTD. 开区间时为满足, 否则为不满足.
+		vec_t mhi = hiclosed ? _mm_cmpgt_epi32(k, hi) : _mm_cmpgt_epi32(hi, k);	// 闭区间时为不满足, 否则为满足.
+		if constexpr (loopen && !hiclosed)	return _mm_and_si128(_mm_and_si128(mlo, mhi), x);	// [SSE2] PAND.
+		else if constexpr (loopen)	return _mm_andnot_si128(mhi, _mm_and_si128(mlo, x));	// [SSE2] PANDN.
+		else if constexpr (!hiclosed)	return _mm_andnot_si128(mlo, _mm_and_si128(mhi, x));
+		else	return _mm_andnot_si128(_mm_or_si128(mlo, mhi), x);	// [SSE2] POR.
+	}
+};
+
+// 双精度浮点_SSE2.
+template<> struct WhereTraits<double, SIMDSUM_ISA_SSE2> : SumTraits<double, double, SIMDSUM_ISA_SSE2>
+{
+	template<int FLAGS> static vec_t select(vec_t x, vec_t k, vec_t lo, vec_t hi)
+	{
+		vec_t mlo = (FLAGS & SIMDSUM_WHERE_LO_OPEN) ? _mm_cmpgt_pd(k, lo) : _mm_cmpge_pd(k, lo);	// [SSE2] CMPLTPD/CMPLEPD（交换操作数）.
+		vec_t mhi = (FLAGS & SIMDSUM_WHERE_HI_CLOSED) ? _mm_cmple_pd(k, hi) : _mm_cmplt_pd(k, hi);	// [SSE2] CMPLEPD/CMPLTPD.
+		return _mm_and_pd(_mm_and_pd(mlo, mhi), x);	// [SSE2] ANDPD.
+	}
+};
+#endif	// #ifdef INTRIN_SSE2
+
+#ifdef INTRIN_AVX
+// 单精度浮点_AVX. 用有序、不报告异常的比较谓词（_OQ）.
+template<> struct WhereTraits<float, SIMDSUM_ISA_AVX> : SumTraits<float, float, SIMDSUM_ISA_AVX>
+{
+	static vec_t set1(float x) { return _mm256_set1_ps(x); }
+	template<int FLAGS> static vec_t select(vec_t x, vec_t k, vec_t lo, vec_t hi)
+	{
+		vec_t mlo = _mm256_cmp_ps(k, lo, (FLAGS & SIMDSUM_WHERE_LO_OPEN) ? _CMP_GT_OQ : _CMP_GE_OQ);	// [AVX] VCMPPS.
+		vec_t mhi = _mm256_cmp_ps(k, hi, (FLAGS & SIMDSUM_WHERE_HI_CLOSED) ? _CMP_LE_OQ : _CMP_LT_OQ);
+		return _mm256_and_ps(_mm256_and_ps(mlo, mhi), x);	// [AVX] VANDPS.
+	}
+};
+
+// 双精度浮点_AVX.
+template<> struct WhereTraits<double, SIMDSUM_ISA_AVX> : SumTraits<double, double, SIMDSUM_ISA_AVX>
+{
+	template<int FLAGS> static vec_t select(vec_t x, vec_t k, vec_t lo, vec_t hi)
+	{
+		vec_t mlo = _mm256_cmp_pd(k, lo, (FLAGS & SIMDSUM_WHERE_LO_OPEN) ? _CMP_GT_OQ : _CMP_GE_OQ);	// [AVX] VCMPPD.
+		vec_t mhi = _mm256_cmp_pd(k, hi, (FLAGS & SIMDSUM_WHERE_HI_CLOSED) ? _CMP_LE_OQ : _CMP_LT_OQ);
+		return _mm256_and_pd(_mm256_and_pd(mlo, mhi), x);	// [AVX] VANDPD.
+	}
+};
+#endif	// #ifdef INTRIN_AVX
+
+#ifdef INTRIN_AVX2
+// 32位整数_AVX2. 同SSE2版.
+template<> struct WhereTraits<int32_t, SIMDSUM_ISA_AVX2> : SumTraits<int32_t, int32_t, SIMDSUM_ISA_AVX2>
+{
+	static vec_t set1(int32_t x) { return _mm256_set1_epi32(x); }
+	template<int FLAGS> static vec_t select(vec_t x, vec_t k, vec_t lo, vec_t hi)
+	{
+		constexpr bool loopen = 0!=(FLAGS & SIMDSUM_WHERE_LO_OPEN);
+		constexpr bool hiclosed = 0!=(FLAGS & SIMDSUM_WHERE_HI_CLOSED);
+		vec_t mlo = loopen ? _mm256_cmpgt_epi32(k, lo) : _mm256_cmpgt_epi32(lo, k);	// [AVX2] VPCMPGTD.
+		vec_t mhi = hiclosed ? _mm256_cmpgt_epi32(k, hi) : _mm256_cmpgt_epi32(hi, k);
+		if constexpr (loopen && !hiclosed)	return _mm256_and_si256(_mm256_and_si256(mlo, mhi), x);	// [AVX2] VPAND.
+		else if constexpr (loopen)	return _mm256_andnot_si256(mhi, _mm256_and_si256(mlo, x));	// [AVX2] VPANDN.
+		else if constexpr (!hiclosed)	return _mm256_andnot_si256(mlo, _mm256_and_si256(mhi, x));
+		else	return _mm256_andnot_si256(_mm256_or_si256(mlo, mhi), x);	// [AVX2] VPOR.
+	}
+};
+#endif	// #ifdef INTRIN_AVX2
+
+// 标量的区间条件. 用于开头与剩余部分.
+template<int FLAGS, typename T>
+inline bool where_pass(T k, T lo, T hi)
+{
+	return ((FLAGS & SIMDSUM_WHERE_LO_OPEN) ? (k > lo) : (k >= lo)) && ((FLAGS & SIMDSUM_WHERE_HI_CLOSED) ? (k <= hi) : (k < hi));
+}
+
+// 加载一个向量, 并清除不满足条件的通道. 单列时key就是值本身, 只加载一次.
+template<typename Tr, int FLAGS, bool TWOCOL, typename T>
+inline typename Tr::vec_t where_load(const T* p, const T* q, typename Tr::vec_t lo, typename Tr::vec_t hi)
+{
+	typename Tr::vec_t x = Tr::load(p);
+	if constexpr (TWOCOL)	return Tr::template select<FLAGS>(x, Tr::load(q), lo, hi);
+	else	return Tr::template select<FLAGS>(x, x, lo, hi);
+}
+
+// 批量处理一块: 每路累加器各加一个向量.
+template<typename Tr, int FLAGS, bool TWOCOL, typename T, size_t... I>
+inline void where_step(typename Tr::vec_t* acc, const T* p, const T* q, typename Tr::vec_t lo, typename Tr::vec_t hi, std::index_sequence<I...>)
+{
+	((acc[I] = Tr::add(acc[I], where_load<Tr, FLAGS, TWOCOL>(p + I*Tr::lanes, q + I*Tr::lanes, lo, hi))), ...);
+}
+
+// 条件求和. 结构与 sum_kernel 相同, 每个向量先比较得到掩码, 与值按位与后再累加, 循环内没有分支.
+//
+// T: 元素类型. ISA: 指令集级别. FLAGS: SIMDSUM_WHERE_常数的组合. TWOCOL: 条件是否在另一列（pkey）上. UNROLL: 循环展开次数.
+// result: 返回满足条件的元素之和.
+// pval: 值数组.
+// pkey: 条件数组. TWOCOL为false时忽略.
+// cntbuf: 数组长度.
+// lo, hi: 区间的下界与上界.
+template<typename T, int ISA, int FLAGS, bool TWOCOL, size_t UNROLL>
+T sum_where_impl(const T* pval, const T* pkey, size_t cntbuf, T lo, T hi)
+{
+	typedef WhereTraits<T, ISA> Tr;
+	typedef typename Tr::vec_t V;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	T s = 0;	// 求和变量.
+	size_t i;
+	size_t cntHead = SIMDSUM_HEADCNT(pval, cntbuf, Tr::align);	// 开头未对齐的数量. 按值数组对齐.
+	size_t cntBlock = (cntbuf-cntHead) / nBlockWidth;	// 块数.
+	size_t cntRem = (cntbuf-cntHead) % nBlockWidth;	// 剩余数量.
+	V acc[UNROLL];	// 求和变量.
+	V vlo = Tr::set1(lo);	// 下界.
+	V vhi = Tr::set1(hi);	// 上界.
+	const T* p = pval+cntHead;	// 值的指针.
+	const T* q = (TWOCOL ? pkey : pval) + cntHead;	// 条件的指针.
+
+	for(i=0; i<UNROLL; ++i)	acc[i] = Tr::zero();
+
+	// 批量处理.
+	for(i=0; i<cntBlock; ++i)
+	{
+		where_step<Tr, FLAGS, TWOCOL>(acc, p, q, vlo, vhi, std::make_index_sequence<UNROLL>());
+		p += nBlockWidth;
+		q += nBlockWidth;
+	}
+	// 处理剩下的完整向量.
+	for(i=0; i<cntRem/Tr::lanes; ++i)
+	{
+		acc[0] = Tr::add(acc[0], where_load<Tr, FLAGS, TWOCOL>(p, q, vlo, vhi));
+		p += Tr::lanes;
+		q += Tr::lanes;
+	}
+	cntRem %= Tr::lanes;
+
+	// 合并.
+	s = Tr::reduce(sum_merge<Tr, UNROLL>(acc));
+
+	// 处理开头未对齐的.
+	for(i=0; i<cntHead; ++i)
+	{
+		if (where_pass<FLAGS>((TWOCOL ? pkey : pval)[i], lo, hi))	s += pval[i];
+	}
+
+	// 处理剩下的.
+	for(i=0; i<cntRem; ++i)
+	{
+		if (where_pass<FLAGS>(q[i], lo, hi))	s += p[i];
+	}
+
+	Tr::leave();
+	return s;
+}
+
+// 按边界类型选择实例.
+template<typename T, int ISA, bool TWOCOL, size_t UNROLL>
+T sum_where_flags(const T* pval, const T* pkey, size_t cntbuf, T lo, T hi, int flags)
+{
+	switch(flags & (SIMDSUM_WHERE_LO_OPEN|SIMDSUM_WHERE_HI_CLOSED))
+	{
+	case 0:
+		return sum_where_impl<T, ISA, 0, TWOCOL, UNROLL>(pval, pkey, cntbuf, lo, hi);
+	case SIMDSUM_WHERE_LO_OPEN:
+		return sum_where_impl<T, ISA, SIMDSUM_WHERE_LO_OPEN, TWOCOL, UNROLL>(pval, pkey, cntbuf, lo, hi);
+	case SIMDSUM_WHERE_HI_CLOSED:
+		return sum_where_impl<T, ISA, SIMDSUM_WHERE_HI_CLOSED, TWOCOL, UNROLL>(pval, pkey, cntbuf, lo, hi);
+	default:
+		return sum_where_impl<T, ISA, SIMDSUM_WHERE_LO_OPEN|SIMDSUM_WHERE_HI_CLOSED, TWOCOL, UNROLL>(pval, pkey, cntbuf, lo, hi);
+	}
+}
+
+// 条件求和. 参数同 simd_sum_where_i32. 边界类型与列数在运行时选择, 循环内都是常量.
+template<typename T, int ISA, size_t UNROLL>
+T sum_where(const T* pval, const T* pkey, size_t cntbuf, T lo, T hi, int flags)
+{
+	if (NULL==pkey || pkey==pval)	return sum_where_flags<T, ISA, false, UNROLL>(pval, pval, cntbuf, lo, hi, flags);
+	return sum_where_flags<T, ISA, true, UNROLL>(pval, pkey, cntbuf, lo, hi, flags);
+}
+
+
+////////////////////////////////////////
+// sum_nan: 跳过NaN的浮点数组求和.
+////////////////////////////////////////
+
+// 跳过NaN求和的向量操作. 沿用 SumTraits 的加载、加法与水平求和, 另需提供:
+//   valid(x): 非NaN的通道为全1, 其余为0. 即x与自身的有序比较.
+//   keep(m, x): 按掩码保留x, 其余为+0.
+//   cnt_t: 计数向量的类型.
+//   cnt_zero(): 计数清零.
+//   cnt_add(c, m): 掩码为全1的通道计数加1.
+//   cnt_sum(c): 计数的水平求和.
+//   cnt_flush: 每段最多累加的向量数（每路累加器）, 之后把计数转为标量, 以免计数溢出或失去精度. 为0表示无需分段.
+template<typename T, int ISA> struct NanTraits;
+
+#ifdef INTRIN_SSE2
+// 单精度浮点_SSE2. 掩码按整数看是-1, 用PSUBD计数, 每个通道最多计2^31-1.
+template<> struct NanTraits<float, SIMDSUM_ISA_SSE2> : SumTraits<float, float, SIMDSUM_ISA_SSE>
+{
+	typedef __m128i cnt_t;
+	static constexpr size_t cnt_flush = (size_t)1 << 30;
+	static vec_t valid(vec_t x) { return _mm_cmpord_ps(x, x); }	// [SSE] CMPORDPS.
+	static vec_t keep(vec_t m, vec_t x) { return _mm_and_ps(m, x); }	// [SSE] ANDPS.
+	static cnt_t cnt_zero() { return _mm_setzero_si128(); }	// [SSE2] PXOR.
+	static cnt_t cnt_add(cnt_t c, vec_t m) { return _mm_sub_epi32(c, _mm_castps_si128(m)); }	// [SSE2] PSUBD.
+	static size_t cnt_sum(cnt_t c) { uint32_t q[4]; _mm_storeu_si128((__m128i*)q, c); return (size_t)q[0] + q[1] + q[2] + q[3]; }
+};
+
+// 双精度浮点_SSE2. 用PSUBQ计数, 64位的计数不会溢出.
+template<> struct NanTraits<double, SIMDSUM_ISA_SSE2> : SumTraits<double, double, SIMDSUM_ISA_SSE2>
+{
+	typedef __m128i cnt_t;
+	static constexpr size_t cnt_flush = 0;
+	static vec_t valid(vec_t x) { return _mm_cmpord_pd(x, x); }	// [SSE2] CMPORDPD.
+	static vec_t keep(vec_t m, vec_t x) { return _mm_and_pd(m, x); }	// [SSE2] ANDPD.
+	static cnt_t cnt_zero() { return _mm_setzero_si128(); }	// [SSE2] PXOR.
+	static cnt_t cnt_add(cnt_t c, vec_t m) { return _mm_sub_epi64(c, _mm_castpd_si128(m)); }	// [SSE2] PSUBQ.
+	static size_t cnt_sum(cnt_t c) { uint64_t q[2]; _mm_storeu_si128((__m128i*)q, c); return (size_t)(q[0] + q[1]); }
+};
+#endif	// #ifdef INTRIN_SSE2
+
+#ifdef INTRIN_AVX
+// 单精度浮点_AVX. AVX没有256位整数运算, 计数用浮点: 掩码与1.0按位与后相加.
+// float能精确表示不超过2^24的整数, 故每段不超过2^24个向量.
+template<> struct NanTraits<float, SIMDSUM_ISA_AVX> : SumTraits<float, float, SIMDSUM_ISA_AVX>
+{
+	typedef __m256 cnt_t;
+	static constexpr size_t cnt_flush = (size_t)1 << 24;
+	static vec_t valid(vec_t x) { return _mm256_cmp_ps(x, x, _CMP_ORD_Q); }	// [AVX] VCMPPS.
+	static vec_t keep(vec_t m, vec_t x) { return _mm256_and_ps(m, x); }	// [AVX] VANDPS.
+	static cnt_t cnt_zero() { return _mm256_setzero_ps(); }	// [AVX] VXORPS.
+	static cnt_t cnt_add(cnt_t c, vec_t m) { return _mm256_add_ps(c, _mm256_and_ps(m, _mm256_set1_ps(1.0f))); }	// [AVX] VANDPS, VADDPS.
+	static size_t cnt_sum(cnt_t c) { float q[8]; size_t n = 0; _mm256_storeu_ps(q, c); for(size_t i=0; i<8; ++i) n += (size_t)q[i]; return n; }
+};
+
+// 双精度浮点_AVX. 计数同样用浮点, double能精确表示不超过2^53的整数, 无需分段.
+template<> struct NanTraits<double, SIMDSUM_ISA_AVX> : SumTraits<double, double, SIMDSUM_ISA_AVX>
+{
+	typedef __m256d cnt_t;
+	static constexpr size_t cnt_flush = 0;
+	static vec_t valid(vec_t x) { return _mm256_cmp_pd(x, x, _CMP_ORD_Q); }	// [AVX] VCMPPD.
+	static vec_t keep(vec_t m, vec_t x) { return _mm256_and_pd(m, x); }	// [AVX] VANDPD.
+	static cnt_t cnt_zero() { return _mm256_setzero_pd(); }	// [AVX] VXORPD.
+	static cnt_t cnt_add(cnt_t c, vec_t m) { return _mm256_add_pd(c, _mm256_and_pd(m, _mm256_set1_pd(1.0))); }	// [AVX] VANDPD, VADDPD.
+	static size_t cnt_sum(cnt_t c) { double q[4]; _mm256_storeu_pd(q, c); return (size_t)q[0] + (size_t)q[1] + (size_t)q[2] + (size_t)q[3]; }
+};
+#endif	// #ifdef INTRIN_AVX
+
+// 加一个向量: 清除NaN后累加, 并计数.
+template<typename Tr>
+inline void nan_one(typename Tr::vec_t& acc, typename Tr::cnt_t& cnt, typename Tr::vec_t x)
+{
+	typename Tr::vec_t m = Tr::valid(x);
+	acc = Tr::add(acc, Tr::keep(m, x));
+	cnt = Tr::cnt_add(cnt, m);
+}
+
+// 批量处理一块: 每路累加器各加一个向量.
+template<typename Tr, typename T, size_t... I>
+inline void nan_step(typename Tr::vec_t* acc, typename Tr::cnt_t* cnt, const T* p, std::index_sequence<I...>)
+{
+	(nan_one<Tr>(acc[I], cnt[I], Tr::load(p + I*Tr::lanes)), ...);
+}
+
+// 跳过NaN的数组求和. 结构与 sum_kernel 相同, 批量处理按Tr::cnt_flush分段, 每段结束时把计数转为标量.
+//
+// T: 元素类型. ISA: 指令集级别. UNROLL: 循环展开次数.
+// result: 返回非NaN元素之和.
+// pbuf: 数组的首地址. 可以是任意地址.
+// cntbuf: 数组长度.
+// pcnt: 返回非NaN元素的个数. 可以为NULL.
+template<typename T, int ISA, size_t UNROLL>
+T sum_nan(const T* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	typedef NanTraits<T, ISA> Tr;
+	typedef typename Tr::vec_t V;
+	typedef typename Tr::cnt_t C;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	T s = 0;	// 求和变量.
+	size_t n = 0;	// 非NaN元素的个数.
+	T x;	// 标量处理时的元素.
+	size_t i;
+	size_t cntHead = SIMDSUM_HEADCNT(pbuf, cntbuf, Tr::align);	// 开头未对齐的数量.
+	size_t cntBlock = (cntbuf-cntHead) / nBlockWidth;	// 块数.
+	size_t cntRem = (cntbuf-cntHead) % nBlockWidth;	// 剩余数量.
+	size_t cntSeg;	// 本段的块数.
+	V acc[UNROLL];	// 求和变量.
+	C cnt[UNROLL];	// 段内的计数.
+	const T* p = pbuf+cntHead;	// 批量处理时所用的指针.
+
+	for(i=0; i<UNROLL; ++i)	acc[i] = Tr::zero();
+
+	// 批量处理. 分段进行.
+	while(cntBlock>0)
+	{
+		cntSeg = (0==Tr::cnt_flush || cntBlock<Tr::cnt_flush) ? cntBlock : Tr::cnt_flush;
+		cntBlock -= cntSeg;
+		for(i=0; i<UNROLL; ++i)	cnt[i] = Tr::cnt_zero();
+		for(i=0; i<cntSeg; ++i)
+		{
+			nan_step<Tr>(acc, cnt, p, std::make_index_sequence<UNROLL>());
+			p += nBlockWidth;
+		}
+		for(i=0; i<UNROLL; ++i)	n += Tr::cnt_sum(cnt[i]);
+	}
+	// 处理剩下的完整向量.
+	cnt[0] = Tr::cnt_zero();
+	for(i=0; i<cntRem/Tr::lanes; ++i)
+	{
+		nan_one<Tr>(acc[0], cnt[0], Tr::load(p));
+		p += Tr::lanes;
+	}
+	n += Tr::cnt_sum(cnt[0]);
+	cntRem %= Tr::lanes;
+
+	// 合并.
+	s = Tr::reduce(sum_merge<Tr, UNROLL>(acc));
+
+	// 处理开头未对齐的. x!=x 当且仅当x为NaN.
+	for(i=0; i<cntHead; ++i)
+	{
+		x = sum_get(pbuf+i);
+		if (x == x)
+		{
+			s += x;
+			++n;
+		}
+	}
+
+	// 处理剩下的.
+	for(i=0; i<cntRem; ++i)
+	{
+		x = sum_get(p+i);
+		if (x == x)
+		{
+			s += x;
+			++n;
+		}
+	}
+
+	Tr::leave();
+	if (NULL!=pcnt)	*pcnt = n;
+	return s;
+}
+
+
+////////////////////////////////////////
+// sum_seg: 分段求和.
+////////////////////////////////////////
+
+// 分段求和. 第i段为 pbuf[poffs[i]] ~ pbuf[poffs[i+1]-1].
+// 每lanes段为一组. 组内各段用UNROLL个累加器批量处理, 段尾不足一个向量的部分用掩码加载;
+// 不支持掩码时加载以段尾结尾的向量, 再屏蔽其中属于前面的元素（它们仍在pbuf之内, 不会越界）. 各段的累加器合并为一个向量后,
+// 整组一起转置求和, 一次存储lanes个结果. 这样每段只有几次向量加法, 没有逐个处理的循环与单独的水平求和.
+//
+// T: 元素类型. A: 累加类型. ISA: 指令集级别.
+// UNROLL: 循环展开次数. 段通常较短, 块宽（lanes×UNROLL）宜取16~32个元素, 过大时多数段只能走单个向量的循环.
+// pbuf: 数值数组.
+// poffs: 偏移数组. 共cntseg+1项, 须单调不减.
+// cntseg: 段数.
+// psums: 返回各段之和.
+template<typename T, typename A, int ISA, size_t UNROLL>
+void sum_seg(const T* pbuf, const size_t* poffs, size_t cntseg, A* psums)
+{
+	typedef SumTraits<T, A, ISA> Tr;
+	typedef typename Tr::vec_t V;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	V grp[Tr::lanes];	// 一组各段的向量和.
+	V acc[UNROLL];	// 当前段的累加器.
+	A fix[Tr::lanes];	// 逐个处理的部分. 只有段尾位于数组开头的lanes个元素之内、无法向前加载时才用到.
+	A tmp[Tr::lanes];	// 最后一组不满时的结果.
+	size_t iseg, g, i, n;
+	size_t cntg;	// 本组的段数.
+	size_t nhead;	// 开头未对齐的元素数.
+	const T* p;
+
+	for(iseg=0; iseg<cntseg; iseg+=Tr::lanes)
+	{
+		cntg = (cntseg-iseg < Tr::lanes) ? cntseg-iseg : Tr::lanes;
+		for(g=0; g<Tr::lanes; ++g)
+		{
+			for(i=0; i<UNROLL; ++i)	acc[i] = Tr::zero();
+			fix[g] = 0;
+			if (g < cntg)
+			{
+				p = pbuf + poffs[iseg+g];
+				n = poffs[iseg+g+1] - poffs[iseg+g];
+				if constexpr (Tr::masked)
+				{
+					// 长段先用一次掩码加载处理未对齐的开头, 以免之后每次加载都跨缓存行.
+					if (n >= nBlockWidth)
+					{
+						nhead = SIMDSUM_HEADCNT(p, n, Tr::align);
+						if (0!=nhead)
+						{
+							acc[UNROLL-1] = Tr::loadmask(p, nhead);
+							p += nhead;
+							n -= nhead;
+						}
+					}
+				}
+				for(; n>=nBlockWidth; n-=nBlockWidth)
+				{
+					sum_step<Tr>(acc, p, std::make_index_sequence<UNROLL>());
+					p += nBlockWidth;
+				}
+				for(; n>=Tr::lanes; n-=Tr::lanes)
+				{
+					acc[0] = Tr::add(acc[0], Tr::load(p));
+					p += Tr::lanes;
+				}
+				if (0!=n)
+				{
+					if constexpr (Tr::masked)
+					{
+						acc[UNROLL-1] = Tr::add(acc[UNROLL-1], Tr::loadmask(p, n));
+					}
+					else
+					{
+						if ((size_t)(p+n - pbuf) >= Tr::lanes)	acc[UNROLL-1] = Tr::add(acc[UNROLL-1], Tr::loadlast(p+n, n));
+						else	for(i=0; i<n; ++i)	fix[g] += p[i];
+					}
+				}
+			}
+			grp[g] = sum_merge<Tr, UNROLL>(acc);
+		}
+		if (cntg==Tr::lanes)
+		{
+			Tr::reduce_group(grp, psums+iseg);
+		}
+		else
+		{
+			Tr::reduce_group(grp, tmp);
+			for(g=0; g<cntg; ++g)	psums[iseg+g] = tmp[g];
+		}
+		if constexpr (!Tr::masked)
+		{
+			for(g=0; g<cntg; ++g)	psums[iseg+g] += fix[g];
+		}
+	}
+	Tr::leave();
+}
+
+
+////////////////////////////////////////
+// sum_kernel_kahan: 浮点数组补偿求和.
+////////////////////////////////////////
+
+// TwoSum: 求 s+x 并把舍入误差累加到 c. 原理见 simdsum_base.c 的 sumfloat_kahan_base.
+template<typename Tr>
+inline typename Tr::vec_t sum_twosum(typename Tr::vec_t s, typename Tr::vec_t x, typename Tr::vec_t& c)
+{
+	typename Tr::vec_t t = Tr::add(s, x);	// 和.
+	typename Tr::vec_t bp = Tr::sub(t, s);	// x中实际被加上的部分.
+	c = Tr::add(c, Tr::add(Tr::sub(s, Tr::sub(t, bp)), Tr::sub(x, bp)));	// 累加舍入误差.
+	return t;
+}
+
+// TwoSum的标量版.
+template<typename T>
+inline T sum_twosum_scalar(T s, T x, T& c)
+{
+	T t = s + x;
+	T bp = t - s;
+	c += (s - (t - bp)) + (x - bp);
+	return t;
+}
+
+// 批量处理一块: 每路累加器各用TwoSum加一个向量.
+template<typename Tr, typename T, size_t... I>
+inline void sum_step_kahan(typename Tr::vec_t* acc, typename Tr::vec_t* cmp, const T* p, std::index_sequence<I...>)
+{
+	((acc[I] = sum_twosum<Tr>(acc[I], Tr::load(p + I*Tr::lanes), cmp[I])), ...);
+}
+
+// 浮点数组补偿求和. 每个通道各有补偿变量, 用UNROLL个累加器循环展开以掩盖加法延迟.
+//
+// T: 元素类型. ISA: 指令集级别. UNROLL: 循环展开次数.
+// result: 返回数组求和结果.
+// pbuf: 数组的首地址. 可以是任意地址.
+// cntbuf: 数组长度.
+template<typename T, int ISA, size_t UNROLL>
+T sum_kernel_kahan(const T* pbuf, size_t cntbuf)
+{
+	typedef SumTraits<T, T, ISA> Tr;
+	typedef typename Tr::vec_t V;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	T s = 0;	// 求和变量.
+	T c = 0;	// 补偿变量.
+	size_t i;
+	size_t cntHead = SIMDSUM_HEADCNT(pbuf, cntbuf, Tr::align);	// 开头未对齐的数量.
+	size_t cntBlock = (cntbuf-cntHead) / nBlockWidth;	// 块数.
+	size_t cntRem = (cntbuf-cntHead) % nBlockWidth;	// 剩余数量.
+	V acc[UNROLL];	// 求和变量.
+	V cmp[UNROLL];	// 补偿变量. 累积各通道的舍入误差.
+	const T* p = pbuf+cntHead;	// 批量处理时所用的指针.
+	const T* q;	// 将向量上的多个数值合并时所用指针.
+
+	for(i=0; i<UNROLL; ++i)
+	{
+		acc[i] = Tr::zero();
+		cmp[i] = Tr::zero();
+	}
+
+	// 批量处理.
+	for(i=0; i<cntBlock; ++i)
+	{
+		sum_step_kahan<Tr>(acc, cmp, p, std::make_index_sequence<UNROLL>());
+		p += nBlockWidth;
+	}
+	// 合并. 累加器之间的加法也用TwoSum, 其误差并入补偿变量.
+	for(i=1; i<UNROLL; ++i)
+	{
+		cmp[0] = Tr::add(cmp[0], cmp[i]);
+		acc[0] = sum_twosum<Tr>(acc[0], acc[i], cmp[0]);
+	}
+	q = (const T*)&cmp[0];
+	for(i=0; i<Tr::lanes; ++i)
+	{
+		c += q[i];
+	}
+	q = (const T*)&acc[0];
+	for(i=0; i<Tr::lanes; ++i)	// 各通道之和用标量TwoSum合并.
+	{
+		s = sum_twosum_scalar(s, q[i], c);
+	}
+
+	// 处理开头未对齐的.
+	for(i=0; i<cntHead; ++i)
+	{
+		s = sum_twosum_scalar(s, sum_get(pbuf+i), c);
+	}
+
+	// 处理剩下的.
+	for(i=0; i<cntRem; ++i)
+	{
+		s = sum_twosum_scalar(s, sum_get(p+i), c);
+	}
+
+	Tr::leave();
+	return s + c;
+}
+
+////////////////////////////////////////
+// dot_kernel: 点积.
+////////////////////////////////////////
+
+// 批量处理一块: 每路累加器各乘加一对向量.
+template<typename Tr, typename T, size_t... I>
+inline void dot_step(typename Tr::vec_t* acc, const T* pa, const T* pb, std::index_sequence<I...>)
+{
+	((acc[I] = Tr::madd(Tr::load(pa + I*Tr::lanes), Tr::load(pb + I*Tr::lanes), acc[I])), ...);
+}
+
+// 点积, 即 Σpa[i]*pb[i]. 结构与 sum_kernel 相同. 两个数组的地址未必同余, 故只按pa对齐, pb用非对齐加载.
+// 有FMA时乘加的延迟更长（通常为4周期）且每周期可发射2条, 需要8个累加器才能跑满.
+//
+// T: 元素类型. ISA: 指令集级别. UNROLL: 循环展开次数.
+// result: 返回点积.
+// pa, pb: 两个数组的首地址. 可以是任意地址.
+// cntbuf: 数组长度.
+template<typename T, int ISA, size_t UNROLL>
+T dot_kernel(const T* pa, const T* pb, size_t cntbuf)
+{
+	typedef SumTraits<T, T, ISA> Tr;
+	typedef typename Tr::vec_t V;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	T s = 0;	// 求和变量.
+	size_t i;
+	size_t cntHead = SIMDSUM_HEADCNT(pa, cntbuf, Tr::align);	// 开头未对齐的数量.
+	size_t cntBlock = (cntbuf-cntHead) / nBlockWidth;	// 块数.
+	size_t cntRem = (cntbuf-cntHead) % nBlockWidth;	// 剩余数量.
+	V acc[UNROLL];	// 求和变量.
+	const T* p = pa+cntHead;	// 批量处理时所用的指针.
+	const T* q = pb+cntHead;
+	static_assert(!Tr::masked, "dot_kernel does not use masked loads.");
+
+	for(i=0; i<UNROLL; ++i)	acc[i] = Tr::zero();
+
+	// 批量处理.
+	for(i=0; i<cntBlock; ++i)
+	{
+		dot_step<Tr>(acc, p, q, std::make_index_sequence<UNROLL>());
+		p += nBlockWidth;
+		q += nBlockWidth;
+	}
+	// 处理剩下的完整向量.
+	for(i=0; i<cntRem/Tr::lanes; ++i)
+	{
+		acc[0] = Tr::madd(Tr::load(p), Tr::load(q), acc[0]);
+		p += Tr::lanes;
+		q += Tr::lanes;
+	}
+	cntRem %= Tr::lanes;
+
+	// 合并.
+	s = Tr::reduce(sum_merge<Tr, UNROLL>(acc));
+
+	// 处理开头未对齐的.
+	for(i=0; i<cntHead; ++i)
+	{
+		s += pa[i] * pb[i];
+	}
+
+	// 处理剩下的.
+	for(i=0; i<cntRem; ++i)
+	{
+		s += p[i] * q[i];
+	}
+
+	Tr::leave();
+	return s;
+}
+
+////////////////////////////////////////
+// scan_kernel: 前缀和.
+////////////////////////////////////////
+
+// 前缀和的向量操作. T为元素类型, ISA为指令集级别. 特化需提供:
+//   vec_t: 向量类型.
+//   lanes: 每个向量的元素数.
+//   load(p), store(p, a): 加载/存储lanes个元素. 不要求对齐.
+//   set1(x): 各通道均为x.
+//   add(a, b): 紧缩加法.
+//   scan(a): 向量内的前缀和（含自身）. 移位再相加, lanes为2^k时需k次.
+//   shift1(a): 各通道移到下一通道, 通道0补0. 用于把含自身的前缀和变为不含自身的.
+//   last(a): 各通道均为最后一个通道的值. 即本向量的总和, 作为下一个向量的进位.
+template<typename T, int ISA> struct ScanTraits;
+
+#ifdef INTRIN_SSE2
+// 32位整数_SSE2.
+template<> struct ScanTraits<int32_t, SIMDSUM_ISA_SSE2>
+{
+	typedef __m128i vec_t;
+	static constexpr size_t lanes = 4;
+	static vec_t load(const int32_t* p) { return _mm_loadu_si128((const __m128i*)p); }	// [SSE2] MOVDQU.
+	static void store(int32_t* p, vec_t a) { _mm_storeu_si128((__m128i*)p, a); }	// [SSE2] MOVDQU.
+	static vec_t set1(int32_t x) { return _mm_set1_epi32(x); }
+	static vec_t add(vec_t a, vec_t b) { return _mm_add_epi32(a, b); }	// [SSE2] PADDD.
+	static vec_t scan(vec_t a)
+	{
+		a = _mm_add_epi32(a, _mm_slli_si128(a, 4));	// [SSE2] PSLLDQ. 128位整体左移（移向高地址）.
+		return _mm_add_epi32(a, _mm_slli_si128(a, 8));
+	}
+	static vec_t shift1(vec_t a) { return _mm_slli_si128(a, 4); }
+	static vec_t last(vec_t a) { return _mm_shuffle_epi32(a, 0xFF); }	// [SSE2] PSHUFD.
+};
+
+// 64位整数_SSE2.
+template<> struct ScanTraits<int64_t, SIMDSUM_ISA_SSE2>
+{
+	typedef __m128i vec_t;
+	static constexpr size_t lanes = 2;
+	static vec_t load(const int64_t* p) { return _mm_loadu_si128((const __m128i*)p); }	// [SSE2] MOVDQU.
+	static void store(int64_t* p, vec_t a) { _mm_storeu_si128((__m128i*)p, a); }	// [SSE2] MOVDQU.
+	static vec_t set1(int64_t x) { return _mm_set1_epi64x(x); }
+	static vec_t add(vec_t a, vec_t b) { return _mm_add_epi64(a, b); }	// [SSE2] PADDQ.
+	static vec_t scan(vec_t a) { return _mm_add_epi64(a, _mm_slli_si128(a, 8)); }	// [SSE2] PSLLDQ.
+	static vec_t shift1(vec_t a) { return _mm_slli_si128(a, 8); }
+	static vec_t last(vec_t a) { return _mm_shuffle_epi32(a, 0xEE); }	// [SSE2] PSHUFD.
+};
+
+// 单精度浮点_SSE2. 移位借用整数指令.
+template<> struct ScanTraits<float, SIMDSUM_ISA_SSE2>
+{
+	typedef __m128 vec_t;
+	static constexpr size_t lanes = 4;
+	static vec_t load(const float* p) { return _mm_loadu_ps(p); }	// [SSE] MOVUPS.
+	static void store(float* p, vec_t a) { _mm_storeu_ps(p, a); }	// [SSE] MOVUPS.
+	static vec_t set1(float x) { return _mm_set1_ps(x); }
+	static vec_t add(vec_t a, vec_t b) { return _mm_add_ps(a, b); }	// [SSE] ADDPS.
+	template<int N> static vec_t sll(vec_t a) { return _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(a), N)); }	// [SSE2] PSLLDQ.
+	static vec_t scan(vec_t a)
+	{
+		a = _mm_add_ps(a, sll<4>(a));
+		return _mm_add_ps(a, sll<8>(a));
+	}
+	static vec_t shift1(vec_t a) { return sll<4>(a); }
+	static vec_t last(vec_t a) { return _mm_shuffle_ps(a, a, 0xFF); }	// [SSE] SHUFPS.
+};
+
+// 双精度浮点_SSE2.
+template<> struct ScanTraits<double, SIMDSUM_ISA_SSE2>
+{
+	typedef __m128d vec_t;
+	static constexpr size_t lanes = 2;
+	static vec_t load(const double* p) { return _mm_loadu_pd(p); }	// [SSE2] MOVUPD.
+	static void store(double* p, vec_t a) { _mm_storeu_pd(p, a); }	// [SSE2] MOVUPD.
+	static vec_t set1(double x) { return _mm_set1_pd(x); }
+	static vec_t add(vec_t a, vec_t b) { return _mm_add_pd(a, b); }	// [SSE2] ADDPD.
+	static vec_t shift1(vec_t a) { return _mm_castsi128_pd(_mm_slli_si128(_mm_castpd_si128(a), 8)); }	// [SSE2] PSLLDQ.
+	static vec_t scan(vec_t a) { return _mm_add_pd(a, shift1(a)); }
+	static vec_t last(vec_t a) { return _mm_unpackhi_pd(a, a); }	// [SSE2] UNPCKHPD.
+};
+#endif	// #ifdef INTRIN_SSE2
+
+#ifdef INTRIN_AVX2
+// AVX2的256位移位只在各128位半部内进行. 半部内扫描之后, 再把低半部的总和加到高半部上.
+// 整数与浮点都用整数指令移位, 故各类型共用以下函数. B为每个元素的字节数.
+
+// 低半部移到高半部, 低半部补0. 即 [0, a.lo].
+inline __m256i scan_lo2hi(__m256i a) { return _mm256_permute2x128_si256(a, a, 0x08); }	// [AVX2] VPERM2I128.
+
+// 向量内的前缀和. 用ADD把两部分相加.
+template<size_t B, typename ADD>
+inline __m256i scan_avx2(__m256i a, ADD add)
+{
+	a = add(a, _mm256_slli_si256(a, B));	// [AVX2] VPSLLDQ. 各半部内左移.
+	if constexpr (B < 8)	a = add(a, _mm256_slli_si256(a, 2*B));
+	if constexpr (4==B)	return add(a, _mm256_shuffle_epi32(scan_lo2hi(a), 0xFF));	// [AVX2] VPSHUFD. 低半部的最后一个元素.
+	else	return add(a, _mm256_shuffle_epi32(scan_lo2hi(a), 0xEE));
+}
+
+// 各元素移到下一个位置, 跨越半部. VPALIGNR在各半部内把 a 与 [0, a.lo] 拼接后右移.
+template<size_t B>
+inline __m256i shift1_avx2(__m256i a) { return _mm256_alignr_epi8(a, scan_lo2hi(a), 16-B); }	// [AVX2] VPALIGNR.
+
+// 32位整数_AVX2.
+template<> struct ScanTraits<int32_t, SIMDSUM_ISA_AVX2>
+{
+	typedef __m256i vec_t;
+	static constexpr size_t lanes = 8;
+	static vec_t load(const int32_t* p) { return _mm256_loadu_si256((const __m256i*)p); }	// [AVX] VMOVDQU.
+	static void store(int32_t* p, vec_t a) { _mm256_storeu_si256((__m256i*)p, a); }	// [AVX] VMOVDQU.
+	static vec_t set1(int32_t x) { return _mm256_set1_epi32(x); }
+	static vec_t add(vec_t a, vec_t b) { return _mm256_add_epi32(a, b); }	// [AVX2] VPADDD.
+	static vec_t scan(vec_t a) { return scan_avx2<4>(a, add); }
+	static vec_t shift1(vec_t a) { return shift1_avx2<4>(a); }
+	static vec_t last(vec_t a) { return _mm256_permutevar8x32_epi32(a, _mm256_set1_epi32(7)); }	// [AVX2] VPERMD.
+};
+
+// 64位整数_AVX2.
+template<> struct ScanTraits<int64_t, SIMDSUM_ISA_AVX2>
+{
+	typedef __m256i vec_t;
+	static constexpr size_t lanes = 4;
+	static vec_t load(const int64_t* p) { return _mm256_loadu_si256((const __m256i*)p); }	// [AVX] VMOVDQU.
+	static void store(int64_t* p, vec_t a) { _mm256_storeu_si256((__m256i*)p, a); }	// [AVX] VMOVDQU.
+	static vec_t set1(int64_t x) { return _mm256_set1_epi64x(x); }
+	static vec_t add(vec_t a, vec_t b) { return _mm256_add_epi64(a, b); }	// [AVX2] VPADDQ.
+	static vec_t scan(vec_t a) { return scan_avx2<8>(a, add); }
+	static vec_t shift1(vec_t a) { return shift1_avx2<8>(a); }
+	static vec_t last(vec_t a) { return _mm256_permute4x64_epi64(a, 0xFF); }	// [AVX2] VPERMQ.
+};
+
+// 单精度浮点_AVX2.
+template<> struct ScanTraits<float, SIMDSUM_ISA_AVX2>
+{
+	typedef __m256 vec_t;
+	static constexpr size_t lanes = 8;
+	static vec_t load(const float* p) { return _mm256_loadu_ps(p); }	// [AVX] VMOVUPS.
+	static void store(float* p, vec_t a) { _mm256_storeu_ps(p, a); }	// [AVX] VMOVUPS.
+	static vec_t set1(float x) { return _mm256_set1_ps(x); }
+	static vec_t add(vec_t a, vec_t b) { return _mm256_add_ps(a, b); }	// [AVX] VADDPS.
+	static __m256i addi(__m256i a, __m256i b) { return _mm256_castps_si256(_mm256_add_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b))); }
+	static vec_t scan(vec_t a) { return _mm256_castsi256_ps(scan_avx2<4>(_mm256_castps_si256(a), addi)); }
+	static vec_t shift1(vec_t a) { return _mm256_castsi256_ps(shift1_avx2<4>(_mm256_castps_si256(a))); }
+	static vec_t last(vec_t a) { return _mm256_permutevar8x32_ps(a, _mm256_set1_epi32(7)); }	// [AVX2] VPERMPS.
+};
+
+// 双精度浮点_AVX2.
+template<> struct ScanTraits<double, SIMDSUM_ISA_AVX2>
+{
+	typedef __m256d vec_t;
+	static constexpr size_t lanes = 4;
+	static vec_t load(const double* p) { return _mm256_loadu_pd(p); }	// [AVX] VMOVUPD.
+	static void store(double* p, vec_t a) { _mm256_storeu_pd(p, a); }	// [AVX] VMOVUPD.
+	static vec_t set1(double x) { return _mm256_set1_pd(x); }
+	static vec_t add(vec_t a, vec_t b) { return _mm256_add_pd(a, b); }	// [AVX] VADDPD.
+	static __m256i addi(__m256i a, __m256i b) { return _mm256_castpd_si256(_mm256_add_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b))); }
+	static vec_t scan(vec_t a) { return _mm256_castsi256_pd(scan_avx2<8>(_mm256_castpd_si256(a), addi)); }
+	static vec_t shift1(vec_t a) { return _mm256_castsi256_pd(shift1_avx2<8>(_mm256_castpd_si256(a))); }
+	static vec_t last(vec_t a) { return _mm256_permute4x64_pd(a, 0xFF); }	// [AVX2] VPERMPD.
+};
+#endif	// #ifdef INTRIN_AVX2
+
+// 前缀和. 逐个向量先在寄存器内扫描, 再加上进位（之前各元素之和, 各通道相同）. 进位的依赖链每个向量只有一次加法.
+//
+// T: 元素类型. ISA: 指令集级别. EXCL: 是否不含自身.
+// result: 返回 init 加上全部元素之和.
+// pdst: 返回前缀和. 可以等于psrc: 每个向量都是先读后写.
+// psrc: 源数组.
+// cntbuf: 数组长度.
+// init: 初值.
+template<typename T, int ISA, bool EXCL>
+T scan_kernel(T* pdst, const T* psrc, size_t cntbuf, T init)
+{
+	typedef ScanTraits<T, ISA> Tr;
+	typedef typename Tr::vec_t V;
+	size_t i;
+	size_t cntBlock = cntbuf / Tr::lanes;	// 向量数.
+	size_t cntRem = cntbuf % Tr::lanes;	// 剩余数量.
+	T s;	// 累计和.
+	T x;
+	V carry = Tr::set1(init);	// 进位.
+	V p;	// 向量内的前缀和.
+	alignas(64) T tmp[Tr::lanes];
+
+	// 批量处理.
+	for(i=0; i<cntBlock; ++i)
+	{
+		p = Tr::scan(Tr::load(psrc));
+		if constexpr (EXCL)	Tr::store(pdst, Tr::add(carry, Tr::shift1(p)));
+		else	Tr::store(pdst, Tr::add(carry, p));
+		carry = Tr::add(carry, Tr::last(p));
+		psrc += Tr::lanes;
+		pdst += Tr::lanes;
+	}
+	Tr::store(tmp, carry);
+	s = tmp[0];
+
+	// 处理剩下的.
+	for(i=0; i<cntRem; ++i)
+	{
+		x = psrc[i];
+		if constexpr (EXCL)	pdst[i] = s;
+		s += x;
+		if constexpr (!EXCL)	pdst[i] = s;
+	}
+	return s;
+}
+
+////////////////////////////////////////
+// stats_kernel: 单遍统计.
+////////////////////////////////////////
+
+// 加载lanes个元素并转为双精度向量. lanes与 SumTraits<double, double, ISA> 相同. 双精度浮点直接加载.
+template<typename T, int ISA> struct StatsLoad
+{
+	static typename SumTraits<double, double, ISA>::vec_t load(const T* p) { return SumTraits<double, double, ISA>::load(p); }
+};
+
+#ifdef INTRIN_SSE2
+template<> struct StatsLoad<float, SIMDSUM_ISA_SSE2>
+{
+	static __m128d load(const float* p) { return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)p))); }	// [SSE2] MOVQ + CVTPS2PD.
+};
+template<> struct StatsLoad<int32_t, SIMDSUM_ISA_SSE2>
+{
+	static __m128d load(const int32_t* p) { return _mm_cvtepi32_pd(_mm_loadl_epi64((const __m128i*)p)); }	// [SSE2] MOVQ + CVTDQ2PD.
+};
+#endif	// #ifdef INTRIN_SSE2
+
+#ifdef INTRIN_AVX
+template<> struct StatsLoad<float, SIMDSUM_ISA_AVX>
+{
+	static __m256d load(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }	// [AVX] VCVTPS2PD.
+};
+template<> struct StatsLoad<int32_t, SIMDSUM_ISA_AVX>
+{
+	static __m256d load(const int32_t* p) { return _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)p)); }	// [AVX] VCVTDQ2PD.
+};
+#endif	// #ifdef INTRIN_AVX
+
+#if defined(INTRIN_AVX) && defined(INTRIN_FMA)
+template<> struct StatsLoad<float, SIMDSUM_ISA_FMA> : StatsLoad<float, SIMDSUM_ISA_AVX> {};
+template<> struct StatsLoad<int32_t, SIMDSUM_ISA_FMA> : StatsLoad<int32_t, SIMDSUM_ISA_AVX> {};
+#endif	// #if defined(INTRIN_AVX) && defined(INTRIN_FMA)
+
+#ifdef INTRIN_AVX512F
+template<> struct StatsLoad<float, SIMDSUM_ISA_AVX512>
+{
+	static __m512d load(const float* p) { return _mm512_cvtps_pd(_mm256_loadu_ps(p)); }	// [AVX-512F] VCVTPS2PD.
+};
+template<> struct StatsLoad<int32_t, SIMDSUM_ISA_AVX512>
+{
+	static __m512d load(const int32_t* p) { return _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i*)p)); }	// [AVX-512F] VCVTDQ2PD.
+};
+#endif	// #ifdef INTRIN_AVX512F
+
+// 批量处理一块: 每路各处理一个向量. d=x-K, s+=d, q+=d*d, 并更新最小值与最大值.
+template<typename Tr, typename Ld, typename T, size_t... I>
+inline void stats_step(typename Tr::vec_t* s, typename Tr::vec_t* q, typename Tr::vec_t* mn, typename Tr::vec_t* mx, typename Tr::vec_t vk, const T* p, std::index_sequence<I...>)
+{
+	typename Tr::vec_t x[sizeof...(I)];
+	typename Tr::vec_t d[sizeof...(I)];
+	((x[I] = Ld::load(p + I*Tr::lanes)), ...);
+	((d[I] = Tr::sub(x[I], vk)), ...);
+	((s[I] = Tr::add(s[I], d[I])), ...);
+	((q[I] = Tr::madd(d[I], d[I], q[I])), ...);
+	((mn[I] = Tr::min(mn[I], x[I])), ...);
+	((mx[I] = Tr::max(mx[I], x[I])), ...);
+}
+
+// 单遍统计. 结构与 sum_kernel 相同, 但每路有4个累加器: Σd、Σd²、最小值、最大值.
+// 各元素转为双精度后以第一个元素K为原点平移（d=x-K）, 数据的均值远离0时方差也不会因相消而失去精度.
+//
+// T: 元素类型. ISA: 指令集级别. UNROLL: 循环展开次数.
+// pbuf: 数组的首地址. 可以是任意地址.
+// cntbuf: 数组长度.
+// pst: 返回统计量.
+template<typename T, int ISA, size_t UNROLL>
+void stats_kernel(const T* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	typedef SumTraits<double, double, ISA> Tr;
+	typedef StatsLoad<T, ISA> Ld;
+	typedef typename Tr::vec_t V;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	size_t i;
+	size_t cntHead;	// 开头未对齐的数量. 按源数据的向量宽度对齐.
+	size_t cntBlock;	// 块数.
+	size_t cntRem;	// 剩余数量.
+	double k;	// 原点.
+	double s = 0;	// Σd.
+	double q = 0;	// Σd².
+	double xmin, xmax;	// 最小值与最大值.
+	double d;
+	V vk;
+	V acc_s[UNROLL], acc_q[UNROLL], acc_mn[UNROLL], acc_mx[UNROLL];
+	const T* p;	// 批量处理时所用的指针.
+	alignas(64) double tmp[4][Tr::lanes];	// 各通道的值.
+
+	if (0==cntbuf)
+	{
+		simdsum_stats_init(pst);
+		return;
+	}
+	k = (double)pbuf[0];
+	xmin = xmax = k;
+	cntHead = SIMDSUM_HEADCNT(pbuf, cntbuf, Tr::lanes*sizeof(T));
+	cntBlock = (cntbuf-cntHead) / nBlockWidth;
+	cntRem = (cntbuf-cntHead) % nBlockWidth;
+	p = pbuf + cntHead;
+
+	if (cntBlock > 0)
+	{
+		vk = Tr::set1(k);
+		for(i=0; i<UNROLL; ++i)
+		{
+			acc_s[i] = Tr::zero();
+			acc_q[i] = Tr::zero();
+			acc_mn[i] = vk;
+			acc_mx[i] = vk;
+		}
+
+		// 批量处理.
+		for(i=0; i<cntBlock; ++i)
+		{
+			stats_step<Tr, Ld>(acc_s, acc_q, acc_mn, acc_mx, vk, p, std::make_index_sequence<UNROLL>());
+			p += nBlockWidth;
+		}
+		// 合并.
+		for(i=1; i<UNROLL; ++i)
+		{
+			acc_mn[0] = Tr::min(acc_mn[0], acc_mn[i]);
+			acc_mx[0] = Tr::max(acc_mx[0], acc_mx[i]);
+		}
+		Tr::store(tmp[0], sum_merge<Tr, UNROLL>(acc_s));
+		Tr::store(tmp[1], sum_merge<Tr, UNROLL>(acc_q));
+		Tr::store(tmp[2], acc_mn[0]);
+		Tr::store(tmp[3], acc_mx[0]);
+		for(i=0; i<Tr::lanes; ++i)
+		{
+			s += tmp[0][i];
+			q += tmp[1][i];
+			if (tmp[2][i] < xmin)	xmin = tmp[2][i];
+			if (tmp[3][i] > xmax)	xmax = tmp[3][i];
+		}
+	}
+
+	// 处理开头未对齐的.
+	for(i=0; i<cntHead; ++i)
+	{
+		d = (double)pbuf[i] - k;
+		s += d;
+		q += d*d;
+		if ((double)pbuf[i] < xmin)	xmin = (double)pbuf[i];
+		if ((double)pbuf[i] > xmax)	xmax = (double)pbuf[i];
+	}
+
+	// 处理剩下的.
+	for(i=0; i<cntRem; ++i)
+	{
+		d = (double)p[i] - k;
+		s += d;
+		q += d*d;
+		if ((double)p[i] < xmin)	xmin = (double)p[i];
+		if ((double)p[i] > xmax)	xmax = (double)p[i];
+	}
+
+	Tr::leave();
+	simdsum_stats_set(pst, cntbuf, k, s, q, xmin, xmax);
+}
+
+////////////////////////////////////////
+// sum_stride: 结构体数组中某个字段的求和.
+////////////////////////////////////////
+
+// 读取p处的一个元素. 字段未必按元素大小对齐（例如紧凑的结构体）, 故用memcpy, 编译后仍是一条加载指令.
+template<typename T>
+inline T stride_get(const char* p)
+{
+	T x;
+	memcpy(&x, p, sizeof(T));
+	return x;
+}
+
+// 步长整除向量宽度时: 从第一个字段开始, 把整个区域当作连续数组加载, 各记录的字段总落在通道 0, k, 2k, ...（k为步长所含的元素数）.
+// 于是只需普通的紧缩加法, 无需重排; 最后只合并这些通道. 其余通道累加的是其他字段, 通道之间互不影响, 结果直接丢弃
+// （但其中若有非规格化数, 浮点加法可能变慢）. 每个向量在下一个字段之前结束, 最后一个记录留给标量处理, 就不会读过数组末尾.
+//
+// T: 元素类型. ISA: 指令集级别. UNROLL: 循环展开次数.
+// result: 返回字段之和.
+// p: 第一个记录的字段地址.
+// cntrec: 记录数.
+// cbstride: 步长（字节）. 须为sizeof(T)的倍数, 且整除向量宽度.
+template<typename T, int ISA, size_t UNROLL>
+T stride_lane(const char* p, size_t cntrec, size_t cbstride)
+{
+	typedef SumTraits<T, T, ISA> Tr;
+	typedef typename Tr::vec_t V;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	const size_t k = cbstride / sizeof(T);	// 步长所含的元素数.
+	const size_t cntPer = Tr::lanes / k;	// 每个向量所含的记录数.
+	size_t cntVec = (cntrec>0) ? (cntrec-1) / cntPer : 0;	// 向量数. 至少留下一个记录.
+	T s = 0;	// 求和变量.
+	size_t i;
+	V acc[UNROLL];	// 求和变量.
+	T tmp[Tr::lanes];	// 合并后的各通道.
+	const T* q = (const T*)p;	// 批量处理时所用的指针.
+	static_assert(!Tr::masked, "stride_lane does not use masked loads.");
+
+	for(i=0; i<UNROLL; ++i)	acc[i] = Tr::zero();
+
+	// 批量处理.
+	for(i=0; i<cntVec/UNROLL; ++i)
+	{
+		sum_step<Tr>(acc, q, std::make_index_sequence<UNROLL>());
+		q += nBlockWidth;
+	}
+	// 处理剩下的完整向量.
+	for(i=0; i<cntVec%UNROLL; ++i)
+	{
+		acc[0] = Tr::add(acc[0], Tr::load(q));
+		q += Tr::lanes;
+	}
+
+	// 合并. 只取字段所在的通道.
+	V v = sum_merge<Tr, UNROLL>(acc);
+	memcpy(tmp, &v, sizeof(tmp));
+	for(i=0; i<cntPer; ++i)
+	{
+		s += tmp[i*k];
+	}
+
+	// 处理剩下的记录.
+	p += cntVec * cntPer * cbstride;
+	for(i=cntVec*cntPer; i<cntrec; ++i)
+	{
+		s += stride_get<T>(p);
+		p += cbstride;
+	}
+
+	Tr::leave();
+	return s;
+}
+
+// 聚集加载的向量操作. T为元素类型. 特化需提供:
+//   Tr: 累加所用的 SumTraits.
+//   idx_t: 偏移向量的类型.
+//   index(cb): 各通道的字节偏移 0, cb, 2cb, ....
+//   gather(p, vidx): 加载 p+vidx[j] 处的lanes个元素.
+template<typename T> struct StrideGather;
+
+#ifdef INTRIN_AVX2
+// 32位整数_AVX2.
+template<> struct StrideGather<int32_t>
+{
+	typedef SumTraits<int32_t, int32_t, SIMDSUM_ISA_AVX2> Tr;
+	typedef __m256i idx_t;
+	static idx_t index(int cb) { return _mm256_setr_epi32(0, cb, 2*cb, 3*cb, 4*cb, 5*cb, 6*cb, 7*cb); }
+	static Tr::vec_t gather(const char* p, idx_t vidx) { return _mm256_i32gather_epi32((const int*)p, vidx, 1); }	// [AVX2] VPGATHERDD.
+};
+
+// 单精度浮点_AVX2.
+template<> struct StrideGather<float>
+{
+	typedef SumTraits<float, float, SIMDSUM_ISA_AVX> Tr;
+	typedef __m256i idx_t;
+	static idx_t index(int cb) { return _mm256_setr_epi32(0, cb, 2*cb, 3*cb, 4*cb, 5*cb, 6*cb, 7*cb); }
+	static Tr::vec_t gather(const char* p, idx_t vidx) { return _mm256_i32gather_ps((const float*)p, vidx, 1); }	// [AVX2] VGATHERDPS.
+};
+
+// 双精度浮点_AVX2. 4个通道只需128位的偏移.
+template<> struct StrideGather<double>
+{
+	typedef SumTraits<double, double, SIMDSUM_ISA_AVX> Tr;
+	typedef __m128i idx_t;
+	static idx_t index(int cb) { return _mm_setr_epi32(0, cb, 2*cb, 3*cb); }
+	static Tr::vec_t gather(const char* p, idx_t vidx) { return _mm256_i32gather_pd((const double*)p, vidx, 1); }	// [AVX2] VGATHERDPD.
+};
+#endif	// #ifdef INTRIN_AVX2
+
+// 聚集加载_批量处理一块: 每路累加器各加一个向量, 相邻两路相隔lanes个记录.
+template<typename G, size_t... I>
+inline void stride_gather_step(typename G::Tr::vec_t* acc, const char* p, size_t cbvec, typename G::idx_t vidx, std::index_sequence<I...>)
+{
+	((acc[I] = G::Tr::add(acc[I], G::gather(p + I*cbvec, vidx))), ...);
+}
+
+// 其他小步长: 用聚集加载一次取lanes个记录的字段. 相邻记录的字段多在同一缓存行, 聚集加载比逐个加载的指令少.
+// 偏移为32位, 故步长须小于 2^31/lanes.
+//
+// T: 元素类型. UNROLL: 循环展开次数.
+// result: 返回字段之和.
+// p: 第一个记录的字段地址.
+// cntrec: 记录数.
+// cbstride: 步长（字节）.
+template<typename T, size_t UNROLL>
+T stride_gather(const char* p, size_t cntrec, size_t cbstride)
+{
+	typedef StrideGather<T> G;
+	typedef typename G::Tr Tr;
+	typedef typename Tr::vec_t V;
+	const size_t cbvec = Tr::lanes * cbstride;	// 每个向量跨越的字节数.
+	const typename G::idx_t vidx = G::index((int)cbstride);
+	size_t cntVec = cntrec / Tr::lanes;	// 向量数.
+	T s = 0;	// 求和变量.
+	size_t i;
+	V acc[UNROLL];	// 求和变量.
+
+	for(i=0; i<UNROLL; ++i)	acc[i] = Tr::zero();
+
+	// 批量处理.
+	for(i=0; i<cntVec/UNROLL; ++i)
+	{
+		stride_gather_step<G>(acc, p, cbvec, vidx, std::make_index_sequence<UNROLL>());
+		p += UNROLL * cbvec;
+	}
+	// 处理剩下的完整向量.
+	for(i=0; i<cntVec%UNROLL; ++i)
+	{
+		acc[0] = Tr::add(acc[0], G::gather(p, vidx));
+		p += cbvec;
+	}
+
+	// 合并.
+	s = Tr::reduce(sum_merge<Tr, UNROLL>(acc));
+
+	// 处理剩下的记录.
+	for(i=cntVec*Tr::lanes; i<cntrec; ++i)
+	{
+		s += stride_get<T>(p);
+		p += cbstride;
+	}
+
+	Tr::leave();
+	return s;
+}
+
+// 标量_批量处理一块: 每路累加器各加一个记录的字段.
+template<typename T, auto PF, size_t... I>
+inline void stride_scalar_step(T* acc, const char* p, size_t cbstride, size_t cbdist, std::index_sequence<I...>)
+{
+	if constexpr (PF != SUM_PF_NONE)
+	{
+		((_mm_prefetch(p + I*cbstride + cbdist, PF)), ...);	// [SSE] PREFETCHh.
+	}
+	((acc[I] += stride_get<T>(p + I*cbstride)), ...);
+}
+
+// 逐个读取, 用UNROLL个标量累加器掩盖加法延迟. 步长不小于缓存行时每个记录各占一个缓存行, 向量化没有收益, 瓶颈在访存;
+// 硬件预取器一般不跨越4KB页跟踪固定步长, 故提前cntpf个记录软件预取.
+//
+// T: 元素类型. UNROLL: 循环展开次数. PF: 软件预取的提示, 同 sum_kernel.
+// result: 返回字段之和.
+// p: 第一个记录的字段地址.
+// cntrec: 记录数.
+// cbstride: 步长（字节）.
+// cntpf: 预取距离（记录数）.
+template<typename T, size_t UNROLL, auto PF = SUM_PF_NONE>
+T stride_scalar(const char* p, size_t cntrec, size_t cbstride, size_t cntpf = 0)
+{
+	T acc[UNROLL];	// 求和变量.
+	size_t i;
+
+	for(i=0; i<UNROLL; ++i)	acc[i] = 0;
+
+	// 批量处理.
+	for(i=0; i<cntrec/UNROLL; ++i)
+	{
+		stride_scalar_step<T, PF>(acc, p, cbstride, cntpf*cbstride, std::make_index_sequence<UNROLL>());
+		p += UNROLL * cbstride;
+	}
+	// 处理剩下的记录.
+	for(i=0; i<cntrec%UNROLL; ++i)
+	{
+		acc[0] += stride_get<T>(p);
+		p += cbstride;
+	}
+
+	// 合并.
+	for(i=1; i<UNROLL; ++i)	acc[0] += acc[i];
+	return acc[0];
+}
+
+// 结构体数组中某个字段的求和. 按步长选择方法:
+//   步长是元素大小的倍数且整除向量宽度: stride_lane.
+//   步长小于缓存行, 且GATHER为true: stride_gather.
+//   步长不小于缓存行: stride_scalar, 并按预取距离软件预取.
+//   其他: stride_scalar.
+//
+// T: 元素类型. ISA: stride_lane 所用的指令集级别. GATHER: 是否使用聚集加载（需要AVX2）.
+// result: 返回字段之和.
+// pbase: 第一个记录的地址.
+// cntrec: 记录数.
+// cbstride: 步长（字节）.
+// cboffset: 字段在记录内的字节偏移.
+template<typename T, int ISA, bool GATHER>
+T sum_stride(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	constexpr size_t cbvec = SumTraits<T, T, ISA>::lanes * sizeof(T);	// 向量宽度.
+	const size_t cbline = simdsum_cacheline();
+	const char* p = (const char*)pbase + cboffset;
+	if (0!=cbstride && 0==cbstride%sizeof(T) && 0==cbvec%cbstride)	return stride_lane<T, ISA, 4>(p, cntrec, cbstride);
+	if (cbstride >= cbline)	return stride_scalar<T, 4, _MM_HINT_T0>(p, cntrec, cbstride, simdsum_prefetch_dist() / cbline);
+	if constexpr (GATHER)	return stride_gather<T, 4>(p, cntrec, cbstride);
+	else	return stride_scalar<T, 4>(p, cntrec, cbstride);
+}
+
+////////////////////////////////////////
+// stream: STREAM式带宽基准.
+////////////////////////////////////////
+
+// 取得双精度浮点数的位模式.
+inline uint64_t stream_bits(double x)
+{
+	uint64_t u;
+	memcpy(&u, &x, sizeof(u));
+	return u;
+}
+
+// 只读_批量处理一块: 每路累加器各按位或一个向量.
+template<typename Tr, size_t... I>
+inline void stream_step_read(typename Tr::vec_t* acc, const double* p, std::index_sequence<I...>)
+{
+	((acc[I] = Tr::or_bits(acc[I], Tr::load(p + I*Tr::lanes))), ...);
+}
+
+// 复制_批量处理一块.
+template<typename Tr, size_t... I>
+inline void stream_step_copy(double* q, const double* p, std::index_sequence<I...>)
+{
+	(Tr::store(q + I*Tr::lanes, Tr::load(p + I*Tr::lanes)), ...);
+}
+
+// 三元组_批量处理一块.
+template<typename Tr, size_t... I>
+inline void stream_step_triad(double* pa, const double* pb, const double* pc, typename Tr::vec_t vs, std::index_sequence<I...>)
+{
+	(Tr::store(pa + I*Tr::lanes, Tr::add(Tr::load(pb + I*Tr::lanes), Tr::mul(vs, Tr::load(pc + I*Tr::lanes)))), ...);
+}
+
+// 只读: 读取整个数组. 按位或只需1个周期, 不受加法延迟限制, 故能达到加载带宽的上限.
+//
+// ISA: 指令集级别. UNROLL: 循环展开次数.
+// result: 返回各元素按位或的结果. 只用于防止调用被优化掉.
+// pbuf: 数组的首地址. 可以是任意地址.
+// cntbuf: 数组长度.
+template<int ISA, size_t UNROLL>
+uint64_t stream_read(const double* pbuf, size_t cntbuf)
+{
+	typedef SumTraits<double, double, ISA> Tr;
+	typedef typename Tr::vec_t V;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	uint64_t r = 0;	// 按位或的结果.
+	size_t i;
+	size_t cntHead = SIMDSUM_HEADCNT(pbuf, cntbuf, Tr::align);	// 开头未对齐的数量.
+	size_t cntBlock = (cntbuf-cntHead) / nBlockWidth;	// 块数.
+	size_t cntRem = (cntbuf-cntHead) % nBlockWidth;	// 剩余数量.
+	V acc[UNROLL];
+	const double* p = pbuf+cntHead;	// 批量处理时所用的指针.
+	const double* q;	// 将向量上的多个数值合并时所用指针.
+
+	for(i=0; i<UNROLL; ++i)	acc[i] = Tr::zero();
+	for(i=0; i<cntBlock; ++i)
+	{
+		stream_step_read<Tr>(acc, p, std::make_index_sequence<UNROLL>());
+		p += nBlockWidth;
+	}
+	for(i=1; i<UNROLL; ++i)	acc[0] = Tr::or_bits(acc[0], acc[i]);
+	q = (const double*)&acc[0];
+	for(i=0; i<Tr::lanes; ++i)	r |= stream_bits(q[i]);
+	for(i=0; i<cntHead; ++i)	r |= stream_bits(pbuf[i]);
+	for(i=0; i<cntRem; ++i)	r |= stream_bits(p[i]);
+	Tr::leave();
+	return r;
+}
+
+// 复制: pdst[i] = psrc[i]. 按目标地址对齐.
+//
+// ISA: 指令集级别. UNROLL: 循环展开次数.
+// pdst: 目标数组. 不能与psrc重叠.
+// psrc: 源数组.
+// cntbuf: 数组长度.
+template<int ISA, size_t UNROLL>
+void stream_copy(double* pdst, const double* psrc, size_t cntbuf)
+{
+	typedef SumTraits<double, double, ISA> Tr;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	size_t i;
+	size_t cntHead = SIMDSUM_HEADCNT(pdst, cntbuf, Tr::align);	// 开头未对齐的数量.
+	size_t cntBlock = (cntbuf-cntHead) / nBlockWidth;	// 块数.
+	size_t cntRem = (cntbuf-cntHead) % nBlockWidth;	// 剩余数量.
+	const double* p = psrc+cntHead;
+	double* q = pdst+cntHead;
+
+	for(i=0; i<cntHead; ++i)	pdst[i] = psrc[i];
+	for(i=0; i<cntBlock; ++i)
+	{
+		stream_step_copy<Tr>(q, p, std::make_index_sequence<UNROLL>());
+		p += nBlockWidth;
+		q += nBlockWidth;
+	}
+	for(i=0; i<cntRem; ++i)	q[i] = p[i];
+	Tr::leave();
+}
+
+// 三元组: pa[i] = pb[i] + s*pc[i]. 按目标地址对齐.
+//
+// ISA: 指令集级别. UNROLL: 循环展开次数.
+// pa: 目标数组. 不能与pb、pc重叠.
+// pb, pc: 源数组.
+// s: 系数.
+// cntbuf: 数组长度.
+template<int ISA, size_t UNROLL>
+void stream_triad(double* pa, const double* pb, const double* pc, double s, size_t cntbuf)
+{
+	typedef SumTraits<double, double, ISA> Tr;
+	constexpr size_t nBlockWidth = Tr::lanes * UNROLL;	// 块宽.
+	size_t i;
+	size_t cntHead = SIMDSUM_HEADCNT(pa, cntbuf, Tr::align);	// 开头未对齐的数量.
+	size_t cntBlock = (cntbuf-cntHead) / nBlockWidth;	// 块数.
+	typename Tr::vec_t vs = Tr::set1(s);
+
+	for(i=0; i<cntHead; ++i)	pa[i] = pb[i] + s*pc[i];
+	for(i=cntHead; i<cntHead+cntBlock*nBlockWidth; i+=nBlockWidth)
+	{
+		stream_step_triad<Tr>(pa+i, pb+i, pc+i, vs, std::make_index_sequence<UNROLL>());
+	}
+	for(; i<cntbuf; ++i)	pa[i] = pb[i] + s*pc[i];
+	Tr::leave();
+}
+
+}	// namespace
+
+#endif	// #ifndef __SIMDSUM_KERNEL_HPP_INCLUDED
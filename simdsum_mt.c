@@ -0,0 +1,414 @@
+﻿#include <stddef.h>
+
+#include "simdsum.h"
+#include "simdsum_thread.h"
+
+
+// 变量对齐.
+#ifndef ATTR_ALIGN
+#  if defined(__GNUC__)	// GCC
+#    define ATTR_ALIGN(n)	__attribute__((aligned(n)))
+#  else	// 否则使用VC格式.
+#    define ATTR_ALIGN(n)	__declspec(align(n))
+#  endif
+#endif	// #ifndef ATTR_ALIGN
+
+
+//////////////////////////////////////////////////
+// 线程池
+//////////////////////////////////////////////////
+
+#define SIMDSUM_MT_TYPE_I32	0	// 任务类型: int32_t.
+#define SIMDSUM_MT_TYPE_F32	1	// 任务类型: float.
+#define SIMDSUM_MT_TYPE_F64	2	// 任务类型: double.
+#define SIMDSUM_MT_TYPE_I64	3	// 任务类型: int64_t. 仅用于前缀和的第一遍.
+#define SIMDSUM_MT_TYPE_SCAN	0x10	// 标志: 前缀和的第二遍. 与上面的元素类型组合.
+
+// 每个线程的部分和. 按缓存行填充, 避免伪共享. 前缀和的第二遍中为各块的初值.
+typedef struct tagSIMDSUM_MTSLOT{
+	union{
+		int32_t	i32;
+		int64_t	i64;
+		float	f32;
+		double	f64;
+	}r;
+	char	pad[SIMDSUM_CACHELINE - sizeof(double)];
+}SIMDSUM_MTSLOT;
+
+ATTR_ALIGN(64) static SIMDSUM_MTSLOT simdsum_mt_slots[SIMDSUM_MT_MAXTHREADS];	// 部分和.
+static MTTHREAD simdsum_mt_threads[SIMDSUM_MT_MAXTHREADS];	// 工作线程. 第0项对应调用线程, 不使用.
+
+static MTMUTEX simdsum_mt_call = MTMUTEX_INIT;	// 串行化调用者, 同时保护线程池的创建与释放.
+static MTMUTEX simdsum_mt_mutex = MTMUTEX_INIT;	// 保护下面的任务状态.
+static MTCOND simdsum_mt_cvjob = MTCOND_INIT;	// 有新任务或需要退出.
+static MTCOND simdsum_mt_cvdone = MTCOND_INIT;	// 任务完成.
+static int simdsum_mt_count = 0;	// 线程池的线程数（含调用线程）. 0表示尚未初始化.
+static int simdsum_mt_quit = 0;	// 是否退出.
+static unsigned simdsum_mt_gen = 0;	// 任务序号. 每发布一次任务加1.
+static unsigned simdsum_mt_genbase = 0;	// 创建线程池时的任务序号. 线程启动较晚时也不会漏掉其后发布的任务.
+static int simdsum_mt_pending = 0;	// 尚未完成的工作线程数.
+static size_t simdsum_mt_cbthreshold = SIMDSUM_MT_THRESHOLD;	// 阈值（字节）.
+
+// 当前任务. 在发布时写入, 工作线程在互斥量保护下读到序号变化后才访问.
+static int simdsum_mt_type;	// 任务类型. 详见SIMDSUM_MT_TYPE_常数.
+static const void* simdsum_mt_pbuf;	// 数组的首地址.
+static size_t simdsum_mt_cntbuf;	// 数组长度.
+static int simdsum_mt_njob;	// 本次参与的线程数.
+static void* simdsum_mt_pdst;	// 前缀和的目标数组. 在发布第二遍之前写入.
+static int simdsum_mt_excl;	// 前缀和是否不含自身.
+
+// 取得逻辑处理器数.
+static int simdsum_mt_cpucount(void)
+{
+#if defined(_WIN32)
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return (int)si.dwNumberOfProcessors;
+#else
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return (n>0) ? (int)n : 1;
+#endif	// #if defined(_WIN32)
+}
+
+// 取得第idx块的起始下标. 除首尾外, 块边界都对齐到缓存行, 使相邻线程不会读写同一缓存行.
+static size_t simdsum_mt_bound(int idx)
+{
+	int elemtype = simdsum_mt_type & ~SIMDSUM_MT_TYPE_SCAN;
+	size_t cbElem = (SIMDSUM_MT_TYPE_F64==elemtype || SIMDSUM_MT_TYPE_I64==elemtype) ? 8 : 4;
+	size_t n = simdsum_mt_cntbuf;
+	size_t k;
+	size_t addr;
+	if (idx<=0)	return 0;
+	if (idx>=simdsum_mt_njob)	return n;
+	k = (size_t)((double)n * idx / simdsum_mt_njob);
+	addr = (size_t)simdsum_mt_pbuf + k*cbElem;
+	k += ((SIMDSUM_CACHELINE - (addr & (SIMDSUM_CACHELINE-1))) & (SIMDSUM_CACHELINE-1)) / cbElem;
+	return (k<n) ? k : n;
+}
+
+// 64位整数数组求和. 前缀和第一遍用. 没有对应的SIMD内核, 交给编译器自动向量化.
+static int64_t simdsum_mt_sum_i64(const int64_t* pbuf, size_t cntbuf)
+{
+	int64_t s = 0;
+	size_t i;
+	for(i=0; i<cntbuf; ++i)	s += pbuf[i];
+	return s;
+}
+
+// 计算第idx块的部分和, 或第idx块的前缀和.
+static void simdsum_mt_chunk(int idx)
+{
+	size_t i0 = simdsum_mt_bound(idx);
+	size_t i1 = simdsum_mt_bound(idx+1);
+	switch(simdsum_mt_type)
+	{
+	case SIMDSUM_MT_TYPE_I64:
+		simdsum_mt_slots[idx].r.i64 = simdsum_mt_sum_i64((const int64_t*)simdsum_mt_pbuf + i0, i1-i0);
+		break;
+	case SIMDSUM_MT_TYPE_SCAN|SIMDSUM_MT_TYPE_I32:
+		simd_scan_i32((int32_t*)simdsum_mt_pdst + i0, (const int32_t*)simdsum_mt_pbuf + i0, i1-i0, simdsum_mt_slots[idx].r.i32, simdsum_mt_excl);
+		break;
+	case SIMDSUM_MT_TYPE_SCAN|SIMDSUM_MT_TYPE_I64:
+		simd_scan_i64((int64_t*)simdsum_mt_pdst + i0, (const int64_t*)simdsum_mt_pbuf + i0, i1-i0, simdsum_mt_slots[idx].r.i64, simdsum_mt_excl);
+		break;
+	case SIMDSUM_MT_TYPE_SCAN|SIMDSUM_MT_TYPE_F32:
+		simd_scan_f32((float*)simdsum_mt_pdst + i0, (const float*)simdsum_mt_pbuf + i0, i1-i0, simdsum_mt_slots[idx].r.f32, simdsum_mt_excl);
+		break;
+	case SIMDSUM_MT_TYPE_SCAN|SIMDSUM_MT_TYPE_F64:
+		simd_scan_f64((double*)simdsum_mt_pdst + i0, (const double*)simdsum_mt_pbuf + i0, i1-i0, simdsum_mt_slots[idx].r.f64, simdsum_mt_excl);
+		break;
+	case SIMDSUM_MT_TYPE_I32:
+		simdsum_mt_slots[idx].r.i32 = simd_sum_i32((const int32_t*)simdsum_mt_pbuf + i0, i1-i0);
+		break;
+	case SIMDSUM_MT_TYPE_F32:
+		simdsum_mt_slots[idx].r.f32 = simd_sum_f32((const float*)simdsum_mt_pbuf + i0, i1-i0);
+		break;
+	default:
+		simdsum_mt_slots[idx].r.f64 = simd_sum_f64((const double*)simdsum_mt_pbuf + i0, i1-i0);
+		break;
+	}
+}
+
+// 工作线程.
+#if defined(_WIN32)
+static DWORD WINAPI simdsum_mt_worker(LPVOID param)
+#else
+static void* simdsum_mt_worker(void* param)
+#endif	// #if defined(_WIN32)
+{
+	int idx = (int)(size_t)param;
+	unsigned seen = simdsum_mt_genbase;	// 已处理的任务序号.
+	mt_lock(&simdsum_mt_mutex);
+	for(;;)
+	{
+		while(seen==simdsum_mt_gen && !simdsum_mt_quit)	mt_wait(&simdsum_mt_cvjob, &simdsum_mt_mutex);
+		if (simdsum_mt_quit)	break;
+		seen = simdsum_mt_gen;
+		if (idx >= simdsum_mt_njob)	continue;	// 本次任务不需要该线程.
+		mt_unlock(&simdsum_mt_mutex);
+		simdsum_mt_chunk(idx);
+		mt_lock(&simdsum_mt_mutex);
+		if (0==--simdsum_mt_pending)	mt_signal(&simdsum_mt_cvdone);
+	}
+	mt_unlock(&simdsum_mt_mutex);
+	return 0;
+}
+
+// 创建线程池. 需在 simdsum_mt_call 的保护下调用.
+static int simdsum_mt_create(int nthreads)
+{
+	int i;
+	if (simdsum_mt_count>0)	return simdsum_mt_count;
+	if (nthreads<=0)	nthreads = simdsum_mt_cpucount();
+	if (nthreads>SIMDSUM_MT_MAXTHREADS)	nthreads = SIMDSUM_MT_MAXTHREADS;
+	simdsum_mt_quit = 0;
+	simdsum_mt_genbase = simdsum_mt_gen;
+	for(i=1; i<nthreads; ++i)
+	{
+#if defined(_WIN32)
+		simdsum_mt_threads[i] = CreateThread(NULL, 0, simdsum_mt_worker, (LPVOID)(size_t)i, 0, NULL);
+		if (NULL==simdsum_mt_threads[i])	break;
+#else
+		if (0!=pthread_create(&simdsum_mt_threads[i], NULL, simdsum_mt_worker, (void*)(size_t)i))	break;
+#endif	// #if defined(_WIN32)
+	}
+	simdsum_mt_count = i;	// 创建失败时, 只使用已经创建的线程.
+	return simdsum_mt_count;
+}
+
+// 发布任务并等待完成. 需在 simdsum_mt_call 的保护下调用.
+static void simdsum_mt_run(int type, const void* pbuf, size_t cntbuf, int nthreads)
+{
+	mt_lock(&simdsum_mt_mutex);
+	simdsum_mt_type = type;
+	simdsum_mt_pbuf = pbuf;
+	simdsum_mt_cntbuf = cntbuf;
+	simdsum_mt_njob = nthreads;
+	simdsum_mt_pending = nthreads - 1;
+	++simdsum_mt_gen;
+	mt_broadcast(&simdsum_mt_cvjob);
+	mt_unlock(&simdsum_mt_mutex);
+
+	simdsum_mt_chunk(0);	// 调用线程处理第0块.
+
+	mt_lock(&simdsum_mt_mutex);
+	while(simdsum_mt_pending>0)	mt_wait(&simdsum_mt_cvdone, &simdsum_mt_mutex);
+	mt_unlock(&simdsum_mt_mutex);
+}
+
+// 确定本次使用的线程数. 需在 simdsum_mt_call 的保护下调用.
+static int simdsum_mt_prepare(int nthreads)
+{
+	if (simdsum_mt_count<=0)	simdsum_mt_create(0);
+	if (nthreads<=0 || nthreads>simdsum_mt_count)	nthreads = simdsum_mt_count;
+	return nthreads;
+}
+
+int simdsum_mt_init(int nthreads)
+{
+	int rt;
+	mt_lock(&simdsum_mt_call);
+	rt = simdsum_mt_create(nthreads);
+	mt_unlock(&simdsum_mt_call);
+	return rt;
+}
+
+void simdsum_mt_exit(void)
+{
+	int i;
+	mt_lock(&simdsum_mt_call);
+	if (simdsum_mt_count>0)
+	{
+		mt_lock(&simdsum_mt_mutex);
+		simdsum_mt_quit = 1;
+		mt_broadcast(&simdsum_mt_cvjob);
+		mt_unlock(&simdsum_mt_mutex);
+		for(i=1; i<simdsum_mt_count; ++i)
+		{
+#if defined(_WIN32)
+			WaitForSingleObject(simdsum_mt_threads[i], INFINITE);
+			CloseHandle(simdsum_mt_threads[i]);
+#else
+			pthread_join(simdsum_mt_threads[i], NULL);
+#endif	// #if defined(_WIN32)
+		}
+		simdsum_mt_count = 0;
+	}
+	mt_unlock(&simdsum_mt_call);
+}
+
+void simdsum_mt_setthreshold(size_t cbthreshold)
+{
+	simdsum_mt_cbthreshold = cbthreshold;
+}
+
+
+//////////////////////////////////////////////////
+// simd_sum_mt: 多线程并行求和
+//////////////////////////////////////////////////
+
+int32_t simd_sum_i32_mt(const int32_t* pbuf, size_t cntbuf, int nthreads)
+{
+	int32_t s = 0;	// 求和变量.
+	int i;
+	if (cntbuf*sizeof(int32_t) < simdsum_mt_cbthreshold || 1==nthreads)	return simd_sum_i32(pbuf, cntbuf);	// 小数组直接求和, 不做任何同步.
+	mt_lock(&simdsum_mt_call);
+	nthreads = simdsum_mt_prepare(nthreads);
+	if (nthreads<=1)
+	{
+		mt_unlock(&simdsum_mt_call);
+		return simd_sum_i32(pbuf, cntbuf);
+	}
+	simdsum_mt_run(SIMDSUM_MT_TYPE_I32, pbuf, cntbuf, nthreads);
+	for(i=0; i<nthreads; ++i)	s += simdsum_mt_slots[i].r.i32;	// 合并.
+	mt_unlock(&simdsum_mt_call);
+	return s;
+}
+
+float simd_sum_f32_mt(const float* pbuf, size_t cntbuf, int nthreads)
+{
+	float s = 0;	// 求和变量.
+	int i;
+	if (cntbuf*sizeof(float) < simdsum_mt_cbthreshold || 1==nthreads)	return simd_sum_f32(pbuf, cntbuf);	// 小数组直接求和, 不做任何同步.
+	mt_lock(&simdsum_mt_call);
+	nthreads = simdsum_mt_prepare(nthreads);
+	if (nthreads<=1)
+	{
+		mt_unlock(&simdsum_mt_call);
+		return simd_sum_f32(pbuf, cntbuf);
+	}
+	simdsum_mt_run(SIMDSUM_MT_TYPE_F32, pbuf, cntbuf, nthreads);
+	for(i=0; i<nthreads; ++i)	s += simdsum_mt_slots[i].r.f32;	// 合并.
+	mt_unlock(&simdsum_mt_call);
+	return s;
+}
+
+double simd_sum_f64_mt(const double* pbuf, size_t cntbuf, int nthreads)
+{
+	double s = 0;	// 求和变量.
+	int i;
+	if (cntbuf*sizeof(double) < simdsum_mt_cbthreshold || 1==nthreads)	return simd_sum_f64(pbuf, cntbuf);	// 小数组直接求和, 不做任何同步.
+	mt_lock(&simdsum_mt_call);
+	nthreads = simdsum_mt_prepare(nthreads);
+	if (nthreads<=1)
+	{
+		mt_unlock(&simdsum_mt_call);
+		return simd_sum_f64(pbuf, cntbuf);
+	}
+	simdsum_mt_run(SIMDSUM_MT_TYPE_F64, pbuf, cntbuf, nthreads);
+	for(i=0; i<nthreads; ++i)	s += simdsum_mt_slots[i].r.f64;	// 合并.
+	mt_unlock(&simdsum_mt_call);
+	return s;
+}
+
+//////////////////////////////////////////////////
+// simd_scan_mt: 多线程并行前缀和
+//////////////////////////////////////////////////
+
+int32_t simd_scan_i32_mt(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl, int nthreads)
+{
+	int32_t s = init;	// 累计和.
+	int32_t t;
+	int i;
+	if (cntbuf*sizeof(int32_t) < simdsum_mt_cbthreshold || 1==nthreads)	return simd_scan_i32(pdst, psrc, cntbuf, init, excl);
+	mt_lock(&simdsum_mt_call);
+	nthreads = simdsum_mt_prepare(nthreads);
+	if (nthreads<=1)
+	{
+		mt_unlock(&simdsum_mt_call);
+		return simd_scan_i32(pdst, psrc, cntbuf, init, excl);
+	}
+	simdsum_mt_run(SIMDSUM_MT_TYPE_I32, psrc, cntbuf, nthreads);	// 第一遍: 各块之和.
+	for(i=0; i<nthreads; ++i)	// 各块之和变为各块的初值.
+	{
+		t = simdsum_mt_slots[i].r.i32;
+		simdsum_mt_slots[i].r.i32 = s;
+		s += t;
+	}
+	simdsum_mt_pdst = pdst;
+	simdsum_mt_excl = excl;
+	simdsum_mt_run(SIMDSUM_MT_TYPE_SCAN|SIMDSUM_MT_TYPE_I32, psrc, cntbuf, nthreads);	// 第二遍: 各块的前缀和.
+	mt_unlock(&simdsum_mt_call);
+	return s;
+}
+
+int64_t simd_scan_i64_mt(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl, int nthreads)
+{
+	int64_t s = init;	// 累计和.
+	int64_t t;
+	int i;
+	if (cntbuf*sizeof(int64_t) < simdsum_mt_cbthreshold || 1==nthreads)	return simd_scan_i64(pdst, psrc, cntbuf, init, excl);
+	mt_lock(&simdsum_mt_call);
+	nthreads = simdsum_mt_prepare(nthreads);
+	if (nthreads<=1)
+	{
+		mt_unlock(&simdsum_mt_call);
+		return simd_scan_i64(pdst, psrc, cntbuf, init, excl);
+	}
+	simdsum_mt_run(SIMDSUM_MT_TYPE_I64, psrc, cntbuf, nthreads);	// 第一遍: 各块之和.
+	for(i=0; i<nthreads; ++i)	// 各块之和变为各块的初值.
+	{
+		t = simdsum_mt_slots[i].r.i64;
+		simdsum_mt_slots[i].r.i64 = s;
+		s += t;
+	}
+	simdsum_mt_pdst = pdst;
+	simdsum_mt_excl = excl;
+	simdsum_mt_run(SIMDSUM_MT_TYPE_SCAN|SIMDSUM_MT_TYPE_I64, psrc, cntbuf, nthreads);	// 第二遍: 各块的前缀和.
+	mt_unlock(&simdsum_mt_call);
+	return s;
+}
+
+float simd_scan_f32_mt(float* pdst, const float* psrc, size_t cntbuf, float init, int excl, int nthreads)
+{
+	float s = init;	// 累计和.
+	float t;
+	int i;
+	if (cntbuf*sizeof(float) < simdsum_mt_cbthreshold || 1==nthreads)	return simd_scan_f32(pdst, psrc, cntbuf, init, excl);
+	mt_lock(&simdsum_mt_call);
+	nthreads = simdsum_mt_prepare(nthreads);
+	if (nthreads<=1)
+	{
+		mt_unlock(&simdsum_mt_call);
+		return simd_scan_f32(pdst, psrc, cntbuf, init, excl);
+	}
+	simdsum_mt_run(SIMDSUM_MT_TYPE_F32, psrc, cntbuf, nthreads);	// 第一遍: 各块之和.
+	for(i=0; i<nthreads; ++i)	// 各块之和变为各块的初值.
+	{
+		t = simdsum_mt_slots[i].r.f32;
+		simdsum_mt_slots[i].r.f32 = s;
+		s += t;
+	}
+	simdsum_mt_pdst = pdst;
+	simdsum_mt_excl = excl;
+	simdsum_mt_run(SIMDSUM_MT_TYPE_SCAN|SIMDSUM_MT_TYPE_F32, psrc, cntbuf, nthreads);	// 第二遍: 各块的前缀和.
+	mt_unlock(&simdsum_mt_call);
+	return s;
+}
+
+double simd_scan_f64_mt(double* pdst, const double* psrc, size_t cntbuf, double init, int excl, int nthreads)
+{
+	double s = init;	// 累计和.
+	double t;
+	int i;
+	if (cntbuf*sizeof(double) < simdsum_mt_cbthreshold || 1==nthreads)	return simd_scan_f64(pdst, psrc, cntbuf, init, excl);
+	mt_lock(&simdsum_mt_call);
+	nthreads = simdsum_mt_prepare(nthreads);
+	if (nthreads<=1)
+	{
+		mt_unlock(&simdsum_mt_call);
+		return simd_scan_f64(pdst, psrc, cntbuf, init, excl);
+	}
+	simdsum_mt_run(SIMDSUM_MT_TYPE_F64, psrc, cntbuf, nthreads);	// 第一遍: 各块之和.
+	for(i=0; i<nthreads; ++i)	// 各块之和变为各块的初值.
+	{
+		t = simdsum_mt_slots[i].r.f64;
+		simdsum_mt_slots[i].r.f64 = s;
+		s += t;
+	}
+	simdsum_mt_pdst = pdst;
+	simdsum_mt_excl = excl;
+	simdsum_mt_run(SIMDSUM_MT_TYPE_SCAN|SIMDSUM_MT_TYPE_F64, psrc, cntbuf, nthreads);	// 第二遍: 各块的前缀和.
+	mt_unlock(&simdsum_mt_call);
+	return s;
+}
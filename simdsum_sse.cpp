@@ -0,0 +1,396 @@
+﻿#include "simdsum_kernel.hpp"
+
+
+//////////////////////////////////////////////////
+// sumint: 32位整数数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_MMX
+// 32位整数数组求和_MMX版.
+int32_t sumint_mmx(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int32_t, SIMDSUM_ISA_MMX, 1>(pbuf, cntbuf);
+}
+
+// 32位整数数组求和_MMX四路循环展开版.
+int32_t sumint_mmx_4loop(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int32_t, SIMDSUM_ISA_MMX, 4>(pbuf, cntbuf);
+}
+#endif	// #ifdef INTRIN_MMX
+
+#ifdef INTRIN_SSE2
+// 32位整数数组求和_SSE版.
+int32_t sumint_sse(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int32_t, SIMDSUM_ISA_SSE2, 1>(pbuf, cntbuf);
+}
+
+// 32位整数数组求和_SSE四路循环展开版.
+int32_t sumint_sse_4loop(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int32_t, SIMDSUM_ISA_SSE2, 4>(pbuf, cntbuf);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+//////////////////////////////////////////////////
+// sumfloat: 单精度浮点数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE
+// 单精度浮点数组求和_SSE版.
+float sumfloat_sse(const float* pbuf, size_t cntbuf)
+{
+	return sum_kernel<float, float, SIMDSUM_ISA_SSE, 1>(pbuf, cntbuf);
+}
+
+// 单精度浮点数组求和_SSE四路循环展开版.
+float sumfloat_sse_4loop(const float* pbuf, size_t cntbuf)
+{
+	return sum_kernel<float, float, SIMDSUM_ISA_SSE, 4>(pbuf, cntbuf);
+}
+
+// 单精度浮点数组求和_SSE补偿求和版. 每个通道各有补偿变量, 四路循环展开以掩盖加法延迟.
+float sumfloat_kahan_sse(const float* pbuf, size_t cntbuf)
+{
+	return sum_kernel_kahan<float, SIMDSUM_ISA_SSE, 4>(pbuf, cntbuf);
+}
+#endif	// #ifdef INTRIN_SSE
+
+//////////////////////////////////////////////////
+// sumdouble: 双精度浮点数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE2
+// 双精度浮点数组求和_SSE版.
+double sumdouble_sse(const double* pbuf, size_t cntbuf)
+{
+	return sum_kernel<double, double, SIMDSUM_ISA_SSE2, 1>(pbuf, cntbuf);
+}
+
+// 双精度浮点数组求和_SSE四路循环展开版.
+double sumdouble_sse_4loop(const double* pbuf, size_t cntbuf)
+{
+	return sum_kernel<double, double, SIMDSUM_ISA_SSE2, 4>(pbuf, cntbuf);
+}
+
+// 双精度浮点数组求和_SSE补偿求和版. 每个通道各有补偿变量, 四路循环展开以掩盖加法延迟.
+double sumdouble_kahan_sse(const double* pbuf, size_t cntbuf)
+{
+	return sum_kernel_kahan<double, SIMDSUM_ISA_SSE2, 4>(pbuf, cntbuf);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+//////////////////////////////////////////////////
+// sum_seg: 分段求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE2
+// 32位整数数组分段求和_SSE版.
+void sumint_seg_sse(const int32_t* pbuf, const size_t* poffs, size_t cntseg, int32_t* psums)
+{
+	sum_seg<int32_t, int32_t, SIMDSUM_ISA_SSE2, 4>(pbuf, poffs, cntseg, psums);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+#ifdef INTRIN_SSE
+// 单精度浮点数组分段求和_SSE版.
+void sumfloat_seg_sse(const float* pbuf, const size_t* poffs, size_t cntseg, float* psums)
+{
+	sum_seg<float, float, SIMDSUM_ISA_SSE, 4>(pbuf, poffs, cntseg, psums);
+}
+#endif	// #ifdef INTRIN_SSE
+
+#ifdef INTRIN_SSE2
+// 双精度浮点数组分段求和_SSE版.
+void sumdouble_seg_sse(const double* pbuf, const size_t* poffs, size_t cntseg, double* psums)
+{
+	sum_seg<double, double, SIMDSUM_ISA_SSE2, 4>(pbuf, poffs, cntseg, psums);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+//////////////////////////////////////////////////
+// sum_stats: 单遍统计的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE2
+// 32位整数数组统计_SSE版.
+void sumint_stats_sse(const int32_t* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	stats_kernel<int32_t, SIMDSUM_ISA_SSE2, 2>(pbuf, cntbuf, pst);
+}
+
+// 单精度浮点数组统计_SSE版.
+void sumfloat_stats_sse(const float* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	stats_kernel<float, SIMDSUM_ISA_SSE2, 2>(pbuf, cntbuf, pst);
+}
+
+// 双精度浮点数组统计_SSE版.
+void sumdouble_stats_sse(const double* pbuf, size_t cntbuf, SIMDSUM_STATS* pst)
+{
+	stats_kernel<double, SIMDSUM_ISA_SSE2, 2>(pbuf, cntbuf, pst);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+//////////////////////////////////////////////////
+// dot: 点积的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE
+// 单精度浮点点积_SSE四路循环展开版.
+float dotfloat_sse_4loop(const float* pa, const float* pb, size_t cntbuf)
+{
+	return dot_kernel<float, SIMDSUM_ISA_SSE, 4>(pa, pb, cntbuf);
+}
+
+// 单精度浮点点积_SSE八路循环展开版.
+float dotfloat_sse_8loop(const float* pa, const float* pb, size_t cntbuf)
+{
+	return dot_kernel<float, SIMDSUM_ISA_SSE, 8>(pa, pb, cntbuf);
+}
+#endif	// #ifdef INTRIN_SSE
+
+#ifdef INTRIN_SSE2
+// 双精度浮点点积_SSE四路循环展开版.
+double dotdouble_sse_4loop(const double* pa, const double* pb, size_t cntbuf)
+{
+	return dot_kernel<double, SIMDSUM_ISA_SSE2, 4>(pa, pb, cntbuf);
+}
+
+// 双精度浮点点积_SSE八路循环展开版.
+double dotdouble_sse_8loop(const double* pa, const double* pb, size_t cntbuf)
+{
+	return dot_kernel<double, SIMDSUM_ISA_SSE2, 8>(pa, pb, cntbuf);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+//////////////////////////////////////////////////
+// scan: 前缀和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE2
+// 32位整数前缀和_SSE版.
+int32_t scanint_sse(int32_t* pdst, const int32_t* psrc, size_t cntbuf, int32_t init, int excl)
+{
+	if (excl)	return scan_kernel<int32_t, SIMDSUM_ISA_SSE2, true>(pdst, psrc, cntbuf, init);
+	return scan_kernel<int32_t, SIMDSUM_ISA_SSE2, false>(pdst, psrc, cntbuf, init);
+}
+
+// 64位整数前缀和_SSE版.
+int64_t scanint64_sse(int64_t* pdst, const int64_t* psrc, size_t cntbuf, int64_t init, int excl)
+{
+	if (excl)	return scan_kernel<int64_t, SIMDSUM_ISA_SSE2, true>(pdst, psrc, cntbuf, init);
+	return scan_kernel<int64_t, SIMDSUM_ISA_SSE2, false>(pdst, psrc, cntbuf, init);
+}
+
+// 单精度浮点前缀和_SSE版.
+float scanfloat_sse(float* pdst, const float* psrc, size_t cntbuf, float init, int excl)
+{
+	if (excl)	return scan_kernel<float, SIMDSUM_ISA_SSE2, true>(pdst, psrc, cntbuf, init);
+	return scan_kernel<float, SIMDSUM_ISA_SSE2, false>(pdst, psrc, cntbuf, init);
+}
+
+// 双精度浮点前缀和_SSE版.
+double scandouble_sse(double* pdst, const double* psrc, size_t cntbuf, double init, int excl)
+{
+	if (excl)	return scan_kernel<double, SIMDSUM_ISA_SSE2, true>(pdst, psrc, cntbuf, init);
+	return scan_kernel<double, SIMDSUM_ISA_SSE2, false>(pdst, psrc, cntbuf, init);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+//////////////////////////////////////////////////
+// sum_stride: 结构体数组中某个字段求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE
+// 单精度浮点字段求和_SSE版. 步长为4、8、16字节时按向量处理.
+float sumfloat_stride_sse(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	return sum_stride<float, SIMDSUM_ISA_SSE, false>(pbase, cntrec, cbstride, cboffset);
+}
+#endif	// #ifdef INTRIN_SSE
+
+#ifdef INTRIN_SSE2
+// 32位整数字段求和_SSE版. 步长为4、8、16字节时按向量处理.
+int32_t sumint_stride_sse(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	return sum_stride<int32_t, SIMDSUM_ISA_SSE2, false>(pbase, cntrec, cbstride, cboffset);
+}
+
+// 双精度浮点字段求和_SSE版. 步长为8、16字节时按向量处理.
+double sumdouble_stride_sse(const void* pbase, size_t cntrec, size_t cbstride, size_t cboffset)
+{
+	return sum_stride<double, SIMDSUM_ISA_SSE2, false>(pbase, cntrec, cbstride, cboffset);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+//////////////////////////////////////////////////
+// sumbf16: bfloat16数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE2
+// bfloat16数组求和_SSE版.
+float sumbf16_sse(const uint16_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<bf16_t, float, SIMDSUM_ISA_SSE2, 1>((const bf16_t*)pbuf, cntbuf);
+}
+
+// bfloat16数组求和_SSE四路循环展开版.
+float sumbf16_sse_4loop(const uint16_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<bf16_t, float, SIMDSUM_ISA_SSE2, 4>((const bf16_t*)pbuf, cntbuf);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+//////////////////////////////////////////////////
+// sumuint8, sumint8, sumint16: 窄整数数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE2
+// 无符号8位整数数组求和_SSE版. PSADBW直接得到64位的部分和.
+uint64_t sumuint8_sse(const uint8_t* pbuf, size_t cntbuf)
+{
+	return sum_narrow<uint8_t, uint64_t, SIMDSUM_ISA_SSE2, 1>(pbuf, cntbuf);
+}
+
+// 无符号8位整数数组求和_SSE四路循环展开版.
+uint64_t sumuint8_sse_4loop(const uint8_t* pbuf, size_t cntbuf)
+{
+	return sum_narrow<uint8_t, uint64_t, SIMDSUM_ISA_SSE2, 4>(pbuf, cntbuf);
+}
+
+// 有符号8位整数数组求和_SSE版. 异或0x80后用PSADBW.
+int64_t sumint8_sse(const int8_t* pbuf, size_t cntbuf)
+{
+	return sum_narrow<int8_t, int64_t, SIMDSUM_ISA_SSE2, 1>(pbuf, cntbuf);
+}
+
+// 有符号8位整数数组求和_SSE四路循环展开版.
+int64_t sumint8_sse_4loop(const int8_t* pbuf, size_t cntbuf)
+{
+	return sum_narrow<int8_t, int64_t, SIMDSUM_ISA_SSE2, 4>(pbuf, cntbuf);
+}
+
+// 有符号16位整数数组求和_SSE版. PMADDWD加宽为32位, 分段扩展为64位.
+int64_t sumint16_sse(const int16_t* pbuf, size_t cntbuf)
+{
+	return sum_narrow<int16_t, int64_t, SIMDSUM_ISA_SSE2, 1>(pbuf, cntbuf);
+}
+
+// 有符号16位整数数组求和_SSE四路循环展开版.
+int64_t sumint16_sse_4loop(const int16_t* pbuf, size_t cntbuf)
+{
+	return sum_narrow<int16_t, int64_t, SIMDSUM_ISA_SSE2, 4>(pbuf, cntbuf);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+//////////////////////////////////////////////////
+// sumint64, sumuint64: 64位整数数组求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE2
+// 64位整数数组求和_SSE版.
+int64_t sumint64_sse(const int64_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int64_t, int64_t, SIMDSUM_ISA_SSE2, 1>(pbuf, cntbuf);
+}
+
+// 64位整数数组求和_SSE四路循环展开版.
+int64_t sumint64_sse_4loop(const int64_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int64_t, int64_t, SIMDSUM_ISA_SSE2, 4>(pbuf, cntbuf);
+}
+
+// 无符号64位整数数组求和_SSE版. 进位由最高位的逻辑运算得出.
+uint64_t sumuint64_sse(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry)
+{
+	return sum_carry<SIMDSUM_ISA_SSE2, 1>(pbuf, cntbuf, pcarry);
+}
+
+// 无符号64位整数数组求和_SSE四路循环展开版.
+uint64_t sumuint64_sse_4loop(const uint64_t* pbuf, size_t cntbuf, uint64_t* pcarry)
+{
+	return sum_carry<SIMDSUM_ISA_SSE2, 4>(pbuf, cntbuf, pcarry);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+//////////////////////////////////////////////////
+// sum_where: 条件求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE
+// 单精度浮点数组条件求和_SSE版. 四路循环展开.
+float sumfloat_where_sse(const float* pval, const float* pkey, size_t cntbuf, float lo, float hi, int flags)
+{
+	return sum_where<float, SIMDSUM_ISA_SSE, 4>(pval, pkey, cntbuf, lo, hi, flags);
+}
+#endif	// #ifdef INTRIN_SSE
+
+#ifdef INTRIN_SSE2
+// 32位整数数组条件求和_SSE版. 四路循环展开.
+int32_t sumint_where_sse(const int32_t* pval, const int32_t* pkey, size_t cntbuf, int32_t lo, int32_t hi, int flags)
+{
+	return sum_where<int32_t, SIMDSUM_ISA_SSE2, 4>(pval, pkey, cntbuf, lo, hi, flags);
+}
+
+// 双精度浮点数组条件求和_SSE版. 四路循环展开.
+double sumdouble_where_sse(const double* pval, const double* pkey, size_t cntbuf, double lo, double hi, int flags)
+{
+	return sum_where<double, SIMDSUM_ISA_SSE2, 4>(pval, pkey, cntbuf, lo, hi, flags);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+//////////////////////////////////////////////////
+// sum_nan: 跳过NaN求和的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE2
+// 单精度浮点数组跳过NaN求和_SSE版. 用CMPORDPS清除NaN, 计数用到PSUBD, 故需SSE2.
+float sumfloat_nan_sse(const float* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	return sum_nan<float, SIMDSUM_ISA_SSE2, 1>(pbuf, cntbuf, pcnt);
+}
+
+// 单精度浮点数组跳过NaN求和_SSE四路循环展开版.
+float sumfloat_nan_sse_4loop(const float* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	return sum_nan<float, SIMDSUM_ISA_SSE2, 4>(pbuf, cntbuf, pcnt);
+}
+
+// 双精度浮点数组跳过NaN求和_SSE版.
+double sumdouble_nan_sse(const double* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	return sum_nan<double, SIMDSUM_ISA_SSE2, 1>(pbuf, cntbuf, pcnt);
+}
+
+// 双精度浮点数组跳过NaN求和_SSE四路循环展开版.
+double sumdouble_nan_sse_4loop(const double* pbuf, size_t cntbuf, size_t* pcnt)
+{
+	return sum_nan<double, SIMDSUM_ISA_SSE2, 4>(pbuf, cntbuf, pcnt);
+}
+#endif	// #ifdef INTRIN_SSE2
+
+//////////////////////////////////////////////////
+// stream: STREAM式带宽基准的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE2
+// 只读_SSE版.
+uint64_t stream_read_sse(const double* pbuf, size_t cntbuf)
+{
+	return stream_read<SIMDSUM_ISA_SSE2, 4>(pbuf, cntbuf);
+}
+
+// 复制_SSE版.
+void stream_copy_sse(double* pdst, const double* psrc, size_t cntbuf)
+{
+	stream_copy<SIMDSUM_ISA_SSE2, 4>(pdst, psrc, cntbuf);
+}
+
+// 三元组_SSE版.
+void stream_triad_sse(double* pa, const double* pb, const double* pc, double s, size_t cntbuf)
+{
+	stream_triad<SIMDSUM_ISA_SSE2, 4>(pa, pb, pc, s, cntbuf);
+}
+#endif	// #ifdef INTRIN_SSE2
@@ -0,0 +1,14 @@
+﻿#include "simdsum_kernel.hpp"
+
+
+//////////////////////////////////////////////////
+// sumint_wide: 32位整数数组求和_64位结果的函数
+//////////////////////////////////////////////////
+
+#ifdef INTRIN_SSE4_1
+// 32位整数数组求和_64位结果_SSE4.1版. 用PMOVSXDQ将每个int32_t符号扩展为int64_t后再累加, 不会溢出.
+int64_t sumint_wide_sse41(const int32_t* pbuf, size_t cntbuf)
+{
+	return sum_kernel<int32_t, int64_t, SIMDSUM_ISA_SSE41, 4>(pbuf, cntbuf);
+}
+#endif	// #ifdef INTRIN_SSE4_1
@@ -0,0 +1,64 @@
+﻿#include <math.h>
+
+#include "simdsum.h"
+
+
+//////////////////////////////////////////////////
+// simdsum_stats: 统计量
+//////////////////////////////////////////////////
+
+void simdsum_stats_init(SIMDSUM_STATS* pst)
+{
+	pst->cnt = 0;
+	pst->sum = 0;
+	pst->min = HUGE_VAL;
+	pst->max = -HUGE_VAL;
+	pst->sumsq = 0;
+	pst->m2 = 0;
+}
+
+void simdsum_stats_set(SIMDSUM_STATS* pst, uint64_t cnt, double k, double s, double q, double xmin, double xmax)
+{
+	double n = (double)cnt;
+	double m2 = q - s*(s/n);	// Σ(x-均值)² = Σd² - (Σd)²/n. 以K为原点时Σd很小, 几乎不会相消.
+	pst->cnt = cnt;
+	pst->sum = n*k + s;
+	pst->min = xmin;
+	pst->max = xmax;
+	pst->sumsq = q + k*(2*s + n*k);	// Σx² = Σ(d+K)² = Σd² + 2KΣd + nK².
+	pst->m2 = (m2 > 0) ? m2 : 0;	// 舍入可能得到很小的负数.
+}
+
+void simdsum_stats_merge(SIMDSUM_STATS* pdst, const SIMDSUM_STATS* psrc)
+{
+	double na, nb, n;	// 两部分及合并后的元素数.
+	double delta;	// 两部分均值之差.
+	if (0==psrc->cnt)	return;
+	if (0==pdst->cnt)
+	{
+		*pdst = *psrc;
+		return;
+	}
+	na = (double)pdst->cnt;
+	nb = (double)psrc->cnt;
+	n = na + nb;
+	delta = psrc->sum/nb - pdst->sum/na;
+	pdst->m2 += psrc->m2 + delta*delta*(na*nb/n);	// Chan等人的公式.
+	pdst->cnt += psrc->cnt;
+	pdst->sum += psrc->sum;
+	pdst->sumsq += psrc->sumsq;
+	if (psrc->min < pdst->min)	pdst->min = psrc->min;
+	if (psrc->max > pdst->max)	pdst->max = psrc->max;
+}
+
+double simdsum_stats_mean(const SIMDSUM_STATS* pst)
+{
+	if (0==pst->cnt)	return 0;
+	return pst->sum / (double)pst->cnt;
+}
+
+double simdsum_stats_var(const SIMDSUM_STATS* pst, int ddof)
+{
+	if (ddof < 0 || pst->cnt <= (uint64_t)ddof)	return 0;
+	return pst->m2 / (double)(pst->cnt - (uint64_t)ddof);
+}
@@ -0,0 +1,42 @@
+﻿#ifndef __SIMDSUM_THREAD_H_INCLUDED
+#define __SIMDSUM_THREAD_H_INCLUDED
+
+// 线程原语. 仅供库内部（simdsum_mt.c, simdsum_ingest.c）使用.
+
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <unistd.h>
+#endif	// #if defined(_WIN32)
+
+
+//////////////////////////////////////////////////
+// 线程原语: 对 Win32 与 pthread 的简单封装
+//////////////////////////////////////////////////
+
+#if defined(_WIN32)
+typedef SRWLOCK	MTMUTEX;
+typedef CONDITION_VARIABLE	MTCOND;
+#define MTMUTEX_INIT	SRWLOCK_INIT
+#define MTCOND_INIT	CONDITION_VARIABLE_INIT
+#define mt_lock(pm)	AcquireSRWLockExclusive(pm)
+#define mt_unlock(pm)	ReleaseSRWLockExclusive(pm)
+#define mt_wait(pc, pm)	SleepConditionVariableSRW((pc), (pm), INFINITE, 0)
+#define mt_signal(pc)	WakeConditionVariable(pc)
+#define mt_broadcast(pc)	WakeAllConditionVariable(pc)
+typedef HANDLE	MTTHREAD;
+#else
+typedef pthread_mutex_t	MTMUTEX;
+typedef pthread_cond_t	MTCOND;
+#define MTMUTEX_INIT	PTHREAD_MUTEX_INITIALIZER
+#define MTCOND_INIT	PTHREAD_COND_INITIALIZER
+#define mt_lock(pm)	pthread_mutex_lock(pm)
+#define mt_unlock(pm)	pthread_mutex_unlock(pm)
+#define mt_wait(pc, pm)	pthread_cond_wait((pc), (pm))
+#define mt_signal(pc)	pthread_cond_signal(pc)
+#define mt_broadcast(pc)	pthread_cond_broadcast(pc)
+typedef pthread_t	MTTHREAD;
+#endif	// #if defined(_WIN32)
+
+#endif	// #ifndef __SIMDSUM_THREAD_H_INCLUDED
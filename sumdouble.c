@@ -1,9 +1,13 @@
 ﻿#include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
+#include <math.h>
 
 #include "zintrin.h"
 #include "ccpuid.h"
+#include "simdsum.h"
+#include "simdbench.h"
 
 
 // Compiler name
@@ -39,270 +43,953 @@
 
 
 //////////////////////////////////////////////////
-// sumdouble: 双精度浮点数组求和的函数
+// main
 //////////////////////////////////////////////////
 
-// 双精度浮点数组求和_基本版.
-//
-// result: 返回数组求和结果.
-// pbuf: 数组的首地址.
-// cntbuf: 数组长度.
-double sumdouble_base(const double* pbuf, size_t cntbuf)
+// 变量对齐.
+#ifndef ATTR_ALIGN
+#  if defined(__GNUC__)	// GCC
+#    define ATTR_ALIGN(n)	__attribute__((aligned(n)))
+#  else	// 否则使用VC格式.
+#    define ATTR_ALIGN(n)	__declspec(align(n))
+#  endif
+#endif	// #ifndef ATTR_ALIGN
+
+
+#define BUFSIZE	204800
+ATTR_ALIGN(32) double buf[BUFSIZE];
+ATTR_ALIGN(64) char bufofs[sizeof(buf) + 64];	// 偏移测试用. 数据复制到各字节偏移处.
+ATTR_ALIGN(32) double wbuf[BUFSIZE];	// 点积测试用的权重.
+
+double refsum = 0;	// 高精度参考值.
+
+// 求高精度参考值. 用long double做Neumaier补偿求和.
+double sum_ref(const double* pbuf, size_t cntbuf)
 {
-	double s = 0;	// 求和变量.
+	long double s = 0;	// 求和变量.
+	long double c = 0;	// 补偿变量.
+	long double t;
+	long double x;
 	size_t i;
 	for(i=0; i<cntbuf; ++i)
 	{
-		s += pbuf[i];
+		x = pbuf[i];
+		t = s + x;
+		if (fabsl(s) >= fabsl(x))	c += (s - t) + x;
+		else	c += (x - t) + s;
+		s = t;
+	}
+	return (double)(s + c);
+}
+
+// 测试时的函数类型
+typedef double (*TESTPROC)(const double* pbuf, size_t cntbuf);
+
+// 测试时的调用参数.
+typedef struct tagTESTCTX{
+	TESTPROC	proc;	// 被测函数.
+	const double*	pbuf;	// 数组的首地址.
+	size_t	cntbuf;	// 数组长度.
+	volatile double	n;	// 结果. 避免调用被优化.
+}TESTCTX;
+
+// 测试配置.
+static SIMDBENCH_CFG benchcfg;
+
+// 并行求和测试时的线程数.
+static int nthreads_mt = 1;
+
+// 并行求和_测试用包装.
+static double sum_mt(const double* pbuf, size_t cntbuf)
+{
+	return simd_sum_f64_mt(pbuf, cntbuf, nthreads_mt);
+}
+
+// 单遍统计_测试用包装. 返回和, 用于工作集扫描中与求和对比.
+static double sum_stats(const double* pbuf, size_t cntbuf)
+{
+	SIMDSUM_STATS st;
+	simd_sum_stats_f64(pbuf, cntbuf, &st);
+	return (double)st.sum;
+}
+
+// 前缀和测试的被测函数. scanCall 以 runTest 的函数类型调用它.
+static SCANF64PROC scanproc = NULL;
+
+// 前缀和测试是否不含自身.
+static int scanexcl = 0;
+
+// 前缀和的结果.
+ATTR_ALIGN(32) static double scanbuf[BUFSIZE];
+
+// 前缀和_测试用包装. 返回总和, 故可与求和的结果对照.
+static double scanCall(const double* pbuf, size_t cntbuf)
+{
+	return scanproc(scanbuf, pbuf, cntbuf, 0, scanexcl);
+}
+
+// 并行前缀和_测试用包装.
+static double scanCallMt(const double* pbuf, size_t cntbuf)
+{
+	return simd_scan_f64_mt(scanbuf, pbuf, cntbuf, 0, scanexcl, nthreads_mt);
+}
+
+// 调用一次被测函数.
+static void testCall(void* param)
+{
+	TESTCTX* pctx = (TESTCTX*)param;
+	pctx->n = pctx->proc(pctx->pbuf, pctx->cntbuf);
+}
+
+// 进行测试
+void runTest(const char* szname, TESTPROC proc)
+{
+	TESTCTX ctx = {proc, buf, BUFSIZE, 0};
+	SIMDBENCH_RESULT res;
+	simdbench_run(&benchcfg, &res, szname, testCall, &ctx, BUFSIZE, sizeof(buf[0]));
+	sprintf(res.szNote, "sum:%f err:%.3g", (double)ctx.n, fabs(ctx.n - refsum)/fabs(refsum));
+	simdbench_print(&benchcfg, &res);
+}
+
+// 测试各字节偏移(0~63)下的吞吐量. 将buf复制到bufofs+偏移处再求和, 数据与runTest相同. 计时轮数为其他测试的1/5.
+void runOffsetTest(const char* szname, TESTPROC proc)
+{
+	int off;
+	char szName[64];
+	TESTCTX ctx = {proc, NULL, BUFSIZE, 0};
+	SIMDBENCH_CFG cfg = benchcfg;
+	SIMDBENCH_RESULT res;
+
+	cfg.trials = (benchcfg.trials+4) / 5;
+	for(off=0; off<64; ++off)
+	{
+		ctx.pbuf = (const double*)(bufofs + off);
+		memcpy(bufofs + off, buf, sizeof(buf));
+		sprintf(szName, "%s+%d", szname, off);
+		simdbench_run(&cfg, &res, szName, testCall, &ctx, BUFSIZE, sizeof(buf[0]));
+		sprintf(res.szNote, "sum:%f err:%.3g", (double)ctx.n, fabs(ctx.n - refsum)/fabs(refsum));
+		simdbench_print(&benchcfg, &res);
 	}
-	return s;
 }
 
-#ifdef INTRIN_SSE2
-// 双精度浮点数组求和_SSE版.
-double sumdouble_sse(const double* pbuf, size_t cntbuf)
+// 分段求和用的偏移数组.
+static size_t segoffs[BUFSIZE+1];
+
+// 分段求和的结果. segref为逐段调用 simd_sum_f64 的结果, 用于核对.
+static double segsums[BUFSIZE];
+static double segref[BUFSIZE];
+
+// 分段求和时的调用参数.
+typedef struct tagSEGCTX{
+	SUMF64SEGPROC	proc;	// 被测函数. NULL表示逐段调用 simd_sum_f64.
+	size_t	cntseg;	// 段数.
+}SEGCTX;
+
+// 分段求和_调用一次.
+static void segCall(void* param)
 {
-	double s = 0;	// 求和变量.
+	SEGCTX* pctx = (SEGCTX*)param;
 	size_t i;
-	size_t nBlockWidth = 2;	// 块宽. SSE寄存器能一次处理2个double.
-	size_t cntBlock = cntbuf / nBlockWidth;	// 块数.
-	size_t cntRem = cntbuf % nBlockWidth;	// 剩余数量.
-	__m128d xfdSum = _mm_setzero_pd();	// 求和变量。[SSE2] XORPD. 赋初值0.
-	__m128d xfdLoad;	// 加载.
-	const double* p = pbuf;	// SSE批量处理时所用的指针.
-	const double* q;	// 将SSE变量上的多个数值合并时所用指针.
+	if (NULL!=pctx->proc)
+	{
+		pctx->proc(buf, segoffs, pctx->cntseg, segsums);
+		return;
+	}
+	for(i=0; i<pctx->cntseg; ++i)
+	{
+		segsums[i] = simd_sum_f64(buf + segoffs[i], segoffs[i+1] - segoffs[i]);
+	}
+}
 
-	// SSE批量处理.
-	for(i=0; i<cntBlock; ++i)
+// 分段求和_测试一个函数. 逐段调用的一行附上段数与平均段长, 其余各行附上与它的核对结果.
+static void runSegOne(SEGCTX* pctx, const char* szname, SUMF64SEGPROC proc)
+{
+	size_t i;
+	double e;
+	double emax = 0;	// 最大相对误差. 分母加1, 以免和接近0时放大.
+	SIMDBENCH_RESULT res;
+	pctx->proc = proc;
+	simdbench_run(&benchcfg, &res, szname, segCall, pctx, segoffs[pctx->cntseg], sizeof(buf[0]));
+	if (NULL==proc)
+	{
+		memcpy(segref, segsums, pctx->cntseg * sizeof(segsums[0]));
+		sprintf(res.szNote, "segs:%u avg:%.1f", (unsigned)pctx->cntseg, (double)segoffs[pctx->cntseg] / pctx->cntseg);
+	}
+	else
 	{
-		xfdLoad = _mm_load_pd(p);	// [SSE2] MOVAPD. 加载.
-		xfdSum = _mm_add_pd(xfdSum, xfdLoad);	// [SSE2] ADDPD. 双精浮点紧缩加法.
-		p += nBlockWidth;
+		for(i=0; i<pctx->cntseg; ++i)
+		{
+			e = fabs((double)segsums[i] - (double)segref[i]) / (fabs((double)segref[i]) + 1);
+			if (e > emax)	emax = e;
+		}
+		sprintf(res.szNote, "maxerr:%.3g", emax);
 	}
-	// 合并.
-	q = (const double*)&xfdSum;
-	s = q[0] + q[1];
+	simdbench_print(&benchcfg, &res);
+}
 
-	// 处理剩下的.
-	for(i=0; i<cntRem; ++i)
+// 分段求和: 在各种段长分布下, 对比逐段调用 simd_sum_f64 与各分段求和内核. 数值数组为buf, 各段依次排列.
+void runSegTest(int isa)
+{
+	int dist;
+	const char* szdist;	// 分布的名称.
+	char szName[64];
+	const SUMF64SEGKERNEL* pk;
+	SEGCTX ctx = {NULL, 0};
+	for(dist=0; dist<SIMDBENCH_SEG_COUNT; ++dist)
 	{
-		s += p[i];
+		szdist = simdbench_seg_name(dist);
+		ctx.cntseg = simdbench_segoffs(segoffs, BUFSIZE, dist);
+		sprintf(szName, "simd_sum_f64(loop,%s)", szdist);
+		runSegOne(&ctx, szName, NULL);
+		for(pk=simdsum_kernels_f64_seg(); NULL!=pk->szName; ++pk)
+		{
+			if (isa < pk->isa)	continue;
+			sprintf(szName, "%s(%s)", pk->szName, szdist);
+			runSegOne(&ctx, szName, pk->proc);
+		}
+		sprintf(szName, "simd_sum_seg_f64(%s)", szdist);
+		runSegOne(&ctx, szName, simd_sum_seg_f64);
 	}
+}
+
+// 单遍统计时的调用参数.
+typedef struct tagSTATSCTX{
+	SUMF64STATSPROC	proc;	// 被测函数.
+	SIMDSUM_STATS	st;	// 结果.
+}STATSCTX;
 
-	return s;
+// 单遍统计_调用一次.
+static void statsCall(void* param)
+{
+	STATSCTX* pctx = (STATSCTX*)param;
+	pctx->proc(buf, BUFSIZE, &pctx->st);
 }
 
-// 双精度浮点数组求和_SSE四路循环展开版.
-double sumdouble_sse_4loop(const double* pbuf, size_t cntbuf)
+// 单遍统计_测试一个函数. err为和相对参考值的误差. merge为把buf分4块分别统计再合并后, 离差平方和与整体统计的相对差.
+static void runStatsOne(STATSCTX* pctx, const char* szname, SUMF64STATSPROC proc)
 {
-	double s = 0;	// 返回值.
-	size_t i;
-	size_t nBlockWidth = 2*4;	// 块宽. SSE寄存器能一次处理2个double，然后循环展开4次.
-	size_t cntBlock = cntbuf / nBlockWidth;	// 块数.
-	size_t cntRem = cntbuf % nBlockWidth;	// 剩余数量.
-	__m128d xfdSum = _mm_setzero_pd();	// 求和变量。[SSE2] XORPD. 赋初值0.
-	__m128d xfdSum1 = _mm_setzero_pd();
-	__m128d xfdSum2 = _mm_setzero_pd();
-	__m128d xfdSum3 = _mm_setzero_pd();
-	__m128d xfdLoad;	// 加载.
-	__m128d xfdLoad1;
-	__m128d xfdLoad2;
-	__m128d xfdLoad3;
-	const double* p = pbuf;	// SSE批量处理时所用的指针.
-	const double* q;	// 将SSE变量上的多个数值合并时所用指针.
-
-	// SSE批量处理.
-	for(i=0; i<cntBlock; ++i)
-	{
-		xfdLoad = _mm_load_pd(p);	// [SSE2] MOVAPD. 加载.
-		xfdLoad1 = _mm_load_pd(p+2);
-		xfdLoad2 = _mm_load_pd(p+4);
-		xfdLoad3 = _mm_load_pd(p+6);
-		xfdSum = _mm_add_pd(xfdSum, xfdLoad);	// [SSE2] ADDPD. 双精浮点紧缩加法.
-		xfdSum1 = _mm_add_pd(xfdSum1, xfdLoad1);
-		xfdSum2 = _mm_add_pd(xfdSum2, xfdLoad2);
-		xfdSum3 = _mm_add_pd(xfdSum3, xfdLoad3);
-		p += nBlockWidth;
-	}
-	// 合并.
-	xfdSum = _mm_add_pd(xfdSum, xfdSum1);	// 两两合并(0~1).
-	xfdSum2 = _mm_add_pd(xfdSum2, xfdSum3);	// 两两合并(2~3).
-	xfdSum = _mm_add_pd(xfdSum, xfdSum2);	// 两两合并(0~3).
-	q = (const double*)&xfdSum;
-	s = q[0] + q[1];
-
-	// 处理剩下的.
-	for(i=0; i<cntRem; ++i)
-	{
-		s += p[i];
-	}
-
-	return s;
-}
-#endif	// #ifdef INTRIN_SSE2
-
-
-#ifdef INTRIN_AVX
-// 双精度浮点数组求和_AVX版.
-double sumdouble_avx(const double* pbuf, size_t cntbuf)
-{
-	double s = 0;	// 求和变量.
 	size_t i;
-	size_t nBlockWidth = 4;	// 块宽. AVX寄存器能一次处理4个double.
-	size_t cntBlock = cntbuf / nBlockWidth;	// 块数.
-	size_t cntRem = cntbuf % nBlockWidth;	// 剩余数量.
-	__m256d yfdSum = _mm256_setzero_pd();	// 求和变量。[AVX] VXORPD. 赋初值0.
-	__m256d yfdLoad;	// 加载.
-	const double* p = pbuf;	// AVX批量处理时所用的指针.
-	const double* q;	// 将AVX变量上的多个数值合并时所用指针.
+	double e;
+	SIMDSUM_STATS part;
+	SIMDSUM_STATS merged;
+	SIMDBENCH_RESULT res;
+	pctx->proc = proc;
+	simdbench_run(&benchcfg, &res, szname, statsCall, pctx, BUFSIZE, sizeof(buf[0]));
+	simdsum_stats_init(&merged);
+	for(i=0; i<4; ++i)
+	{
+		proc(buf + BUFSIZE*i/4, BUFSIZE*(i+1)/4 - BUFSIZE*i/4, &part);
+		simdsum_stats_merge(&merged, &part);
+	}
+	e = fabs(merged.m2 - pctx->st.m2) / pctx->st.m2;
+	sprintf(res.szNote, "err:%.3g sd:%.6g min:%g max:%g merge:%.3g", fabs(pctx->st.sum - refsum)/fabs(refsum), sqrt(simdsum_stats_var(&pctx->st, 0)), pctx->st.min, pctx->st.max, e);
+	simdbench_print(&benchcfg, &res);
+}
 
-	// AVX批量处理.
-	for(i=0; i<cntBlock; ++i)
+// 单遍统计: 一次读取求出和、最小值、最大值与平方和. %read可与求和各行对比.
+void runStatsTest(int isa)
+{
+	const SUMF64STATSKERNEL* pk;
+	STATSCTX ctx;
+	ctx.proc = NULL;
+	for(pk=simdsum_kernels_f64_stats(); NULL!=pk->szName; ++pk)
 	{
-		yfdLoad = _mm256_load_pd(p);	// [AVX] VMOVAPD. 加载.
-		yfdSum = _mm256_add_pd(yfdSum, yfdLoad);	// [AVX] VADDPD. 双精浮点紧缩加法.
-		p += nBlockWidth;
+		if (isa >= pk->isa)	runStatsOne(&ctx, pk->szName, pk->proc);
 	}
-	// 合并.
-	q = (const double*)&yfdSum;
-	s = q[0] + q[1] + q[2] + q[3];
+	runStatsOne(&ctx, "simd_sum_stats_f64", simd_sum_stats_f64);	// 运行时分派版.
+}
 
-	// 处理剩下的.
-	for(i=0; i<cntRem; ++i)
+// 点积时的调用参数.
+typedef struct tagDOTCTX{
+	DOTF64PROC	proc;	// 被测函数.
+	volatile double	n;	// 结果. 避免调用被优化.
+}DOTCTX;
+
+// 点积_调用一次. 即以wbuf为权重对buf加权求和.
+static void dotCall(void* param)
+{
+	DOTCTX* pctx = (DOTCTX*)param;
+	pctx->n = pctx->proc(buf, wbuf, BUFSIZE);
+}
+
+// 点积: 各点积内核与基本版（标量循环）对比. 每个元素读取buf与wbuf各一次, 故带宽按两个数组计算.
+void runDotTest(int isa)
+{
+	size_t i;
+	long double s = 0;
+	double refdot;	// 参考值. 用long double累加.
+	const DOTF64KERNEL* pk;
+	DOTCTX ctx = {NULL, 0};
+	SIMDBENCH_RESULT res;
+	for(i=0; i<BUFSIZE; ++i)
+	{
+		wbuf[i] = (double)rand() / RAND_MAX;
+		s += (long double)buf[i] * wbuf[i];
+	}
+	refdot = (double)s;
+	for(pk=simdsum_kernels_f64_dot(); NULL!=pk->szName; ++pk)
 	{
-		s += p[i];
+		if (isa < pk->isa)	continue;
+		ctx.proc = pk->proc;
+		simdbench_run(&benchcfg, &res, pk->szName, dotCall, &ctx, BUFSIZE, 2*sizeof(buf[0]));
+		sprintf(res.szNote, "dot:%f err:%.3g", (double)ctx.n, fabs(ctx.n - refdot)/fabs(refdot));
+		simdbench_print(&benchcfg, &res);
 	}
+	ctx.proc = simd_dot_f64;
+	simdbench_run(&benchcfg, &res, "simd_dot_f64", dotCall, &ctx, BUFSIZE, 2*sizeof(buf[0]));	// 运行时分派版.
+	sprintf(res.szNote, "dot:%f err:%.3g", (double)ctx.n, fabs(ctx.n - refdot)/fabs(refdot));
+	simdbench_print(&benchcfg, &res);
+}
 
-	return s;
+// 原地前缀和_准备: 把buf复制到scanbuf.
+static void scanPrep(void* param)
+{
+	(void)param;
+	memcpy(scanbuf, buf, sizeof(buf));
 }
 
-// 双精度浮点数组求和_AVX四路循环展开版.
-double sumdouble_avx_4loop(const double* pbuf, size_t cntbuf)
+// 原地前缀和_调用一次.
+static void scanInplaceCall(void* param)
 {
-	double s = 0;	// 求和变量.
+	TESTCTX* pctx = (TESTCTX*)param;
+	pctx->n = scanproc(scanbuf, scanbuf, BUFSIZE, 0, scanexcl);
+}
+
+// 前缀和: 含自身（incl）与不含自身（excl）两种, 各内核与基本版（标量循环）对比. 之后是原地计算与多线程两遍版.
+// 带宽只按读取源数组计算, 未计入写入.
+void runScanTest(int isa)
+{
+	int cntthreads;
+	char szName[64];
+	const SCANF64KERNEL* pk;
+	TESTCTX ctx = {NULL, buf, BUFSIZE, 0};
+	SIMDBENCH_RESULT res;
+	for(scanexcl=0; scanexcl<2; ++scanexcl)
+	{
+		for(pk=simdsum_kernels_f64_scan(); NULL!=pk->szName; ++pk)
+		{
+			if (isa < pk->isa)	continue;
+			scanproc = pk->proc;
+			sprintf(szName, "%s(%s)", pk->szName, scanexcl ? "excl" : "incl");
+			runTest(szName, scanCall);
+		}
+		scanproc = simd_scan_f64;
+		sprintf(szName, "simd_scan_f64(%s)", scanexcl ? "excl" : "incl");
+		runTest(szName, scanCall);	// 运行时分派版.
+	}
+
+	// 原地: 每轮先把buf复制到scanbuf（不计时）, 故没有预热.
+	scanexcl = 0;
+	scanproc = simd_scan_f64;
+	simdbench_run_prep(&benchcfg, &res, "simd_scan_f64(inplace)", scanInplaceCall, scanPrep, &ctx, BUFSIZE, sizeof(buf[0]));
+	sprintf(res.szNote, "sum:%f err:%.3g", (double)ctx.n, fabs(ctx.n - refsum)/fabs(refsum));
+	simdbench_print(&benchcfg, &res);
+
+	// 多线程两遍版: 1~N线程.
+	cntthreads = simdsum_mt_init(0);
+	for(nthreads_mt=1; nthreads_mt<=cntthreads; ++nthreads_mt)
+	{
+		sprintf(szName, "simd_scan_f64_mt(%d)", nthreads_mt);
+		runTest(szName, scanCallMt);
+	}
+	simdsum_mt_exit();
+}
+
+// 字段求和用的结构体数组. 共STRIDE_CNT个记录, 按最大步长分配. 字段位于各记录的STRIDE_OFS字节处, 值为buf的前STRIDE_CNT个元素.
+#define STRIDE_CNT	65536
+#define STRIDE_OFS	8
+#define STRIDE_MAXCB	128	// 最大步长.
+static char* stridebuf = NULL;
+
+// 先转为SoA时的目标数组.
+ATTR_ALIGN(32) static double soabuf[STRIDE_CNT];
+
+// 字段求和时的调用参数.
+typedef struct tagSTRIDECTX{
+	SUMF64STRIDEPROC	proc;	// 被测函数. NULL表示先把字段复制到soabuf, 再用 simd_sum_f64 求和.
+	size_t	cbstride;	// 步长（字节）.
+	volatile double	n;	// 结果. 避免调用被优化.
+}STRIDECTX;
+
+// 字段求和_调用一次.
+static void strideCall(void* param)
+{
+	STRIDECTX* pctx = (STRIDECTX*)param;
 	size_t i;
-	size_t nBlockWidth = 4*4;	// 块宽. AVX寄存器能一次处理8个double，然后循环展开4次.
-	size_t cntBlock = cntbuf / nBlockWidth;	// 块数.
-	size_t cntRem = cntbuf % nBlockWidth;	// 剩余数量.
-	__m256d yfdSum = _mm256_setzero_pd();	// 求和变量。[AVX] VXORPD. 赋初值0.
-	__m256d yfdSum1 = _mm256_setzero_pd();
-	__m256d yfdSum2 = _mm256_setzero_pd();
-	__m256d yfdSum3 = _mm256_setzero_pd();
-	__m256d yfdLoad;	// 加载.
-	__m256d yfdLoad1;
-	__m256d yfdLoad2;
-	__m256d yfdLoad3;
-	const double* p = pbuf;	// AVX批量处理时所用的指针.
-	const double* q;	// 将AVX变量上的多个数值合并时所用指针.
+	if (NULL!=pctx->proc)
+	{
+		pctx->n = pctx->proc(stridebuf, STRIDE_CNT, pctx->cbstride, STRIDE_OFS);
+		return;
+	}
+	for(i=0; i<STRIDE_CNT; ++i)
+	{
+		memcpy(&soabuf[i], stridebuf + i*pctx->cbstride + STRIDE_OFS, sizeof(soabuf[0]));
+	}
+	pctx->n = simd_sum_f64(soabuf, STRIDE_CNT);
+}
 
-	// AVX批量处理.
-	for(i=0; i<cntBlock; ++i)
+// 字段求和_测试一个函数.
+static void runStrideOne(STRIDECTX* pctx, const char* szname, SUMF64STRIDEPROC proc, double ref)
+{
+	SIMDBENCH_RESULT res;
+	pctx->proc = proc;
+	simdbench_run(&benchcfg, &res, szname, strideCall, pctx, STRIDE_CNT, sizeof(soabuf[0]));
+	sprintf(res.szNote, "sum:%f err:%.3g", (double)pctx->n, fabs(pctx->n - ref)/fabs(ref));
+	simdbench_print(&benchcfg, &res);
+}
+
+// 字段求和: 在各种步长下, 对比各字段求和内核与先转为SoA（逐个复制字段, 再用 simd_sum_f64 求和）. 元素数与带宽都只按字段计算.
+// 步长16、32整除向量宽度, 直接加载; 24、40、48在有AVX2时用聚集加载; 64、128每个记录各占一个缓存行, 逐个读取并预取.
+void runStrideTest(int isa)
+{
+	static const size_t strides[] = {16, 24, 32, 40, 48, 64, 128};
+	size_t i, k;
+	char szName[64];
+	double ref = sum_ref(buf, STRIDE_CNT);	// 参考值.
+	const SUMF64STRIDEKERNEL* pk;
+	STRIDECTX ctx = {NULL, 0, 0};
+	stridebuf = (char*)simdbench_alloc(STRIDE_CNT * STRIDE_MAXCB);
+	if (NULL==stridebuf)
+	{
+		fprintf(stderr, "stride: out of memory.\n");
+		return;
+	}
+	for(k=0; k<sizeof(strides)/sizeof(strides[0]); ++k)
 	{
-		yfdLoad = _mm256_load_pd(p);	// [AVX] VMOVAPD. 加载.
-		yfdLoad1 = _mm256_load_pd(p+4);
-		yfdLoad2 = _mm256_load_pd(p+8);
-		yfdLoad3 = _mm256_load_pd(p+12);
-		yfdSum = _mm256_add_pd(yfdSum, yfdLoad);	// [AVX] VADDPD. 双精浮点紧缩加法.
-		yfdSum1 = _mm256_add_pd(yfdSum1, yfdLoad1);
-		yfdSum2 = _mm256_add_pd(yfdSum2, yfdLoad2);
-		yfdSum3 = _mm256_add_pd(yfdSum3, yfdLoad3);
-		p += nBlockWidth;
+		// 其他字段也用buf的数据, 再写入被求和的字段.
+		ctx.cbstride = strides[k];
+		for(i=0; i<STRIDE_CNT*ctx.cbstride/sizeof(double); ++i)	((double*)stridebuf)[i] = buf[i % BUFSIZE];
+		for(i=0; i<STRIDE_CNT; ++i)	memcpy(stridebuf + i*ctx.cbstride + STRIDE_OFS, &buf[i], sizeof(buf[0]));
+		for(pk=simdsum_kernels_f64_stride(); NULL!=pk->szName; ++pk)
+		{
+			if (isa < pk->isa)	continue;
+			sprintf(szName, "%s(%u)", pk->szName, (unsigned)ctx.cbstride);
+			runStrideOne(&ctx, szName, pk->proc, ref);
+		}
+		sprintf(szName, "simd_sum_stride_f64(%u)", (unsigned)ctx.cbstride);
+		runStrideOne(&ctx, szName, simd_sum_stride_f64, ref);	// 运行时分派版.
+		sprintf(szName, "soa+simd_sum_f64(%u)", (unsigned)ctx.cbstride);
+		runStrideOne(&ctx, szName, NULL, ref);
 	}
-	// 合并.
-	yfdSum = _mm256_add_pd(yfdSum, yfdSum1);	// 两两合并(0~1).
-	yfdSum2 = _mm256_add_pd(yfdSum2, yfdSum3);	// 两两合并(2~3).
-	yfdSum = _mm256_add_pd(yfdSum, yfdSum2);	// 两两合并(0~3).
-	q = (const double*)&yfdSum;
-	s = q[0] + q[1] + q[2] + q[3];
+	simdbench_free(stridebuf);
+	stridebuf = NULL;
+}
+
+// 条件求和用的条件列. 值为[0, 10000)内的随机整数.
+ATTR_ALIGN(32) static double wherekey[BUFSIZE];
+
+// 先过滤时的目标数组.
+ATTR_ALIGN(32) static double wherebuf[BUFSIZE];
 
-	// 处理剩下的.
-	for(i=0; i<cntRem; ++i)
+// 条件求和时的调用参数. 条件都是 lo <= key < hi.
+typedef struct tagWHERECTX{
+	SUMF64WHEREPROC	proc;	// 被测函数. NULL表示先用标量循环把满足条件的值复制到wherebuf, 再用 simd_sum_f64 求和.
+	const double*	pkey;	// 条件数组. NULL表示条件在值本身上.
+	double	lo;	// 下界.
+	double	hi;	// 上界.
+	volatile double	n;	// 结果. 避免调用被优化.
+}WHERECTX;
+
+// 条件求和_标量过滤. 返回满足条件的元素数.
+static size_t whereFilter(const WHERECTX* pctx)
+{
+	const double* pkey = (NULL!=pctx->pkey) ? pctx->pkey : buf;
+	size_t i;
+	size_t cnt = 0;
+	for(i=0; i<BUFSIZE; ++i)
 	{
-		s += p[i];
+		if (pkey[i] >= pctx->lo && pkey[i] < pctx->hi)	wherebuf[cnt++] = buf[i];
 	}
+	return cnt;
+}
 
-	return s;
+// 条件求和_调用一次.
+static void whereCall(void* param)
+{
+	WHERECTX* pctx = (WHERECTX*)param;
+	if (NULL!=pctx->proc)	pctx->n = pctx->proc(buf, pctx->pkey, BUFSIZE, pctx->lo, pctx->hi, 0);
+	else	pctx->n = simd_sum_f64(wherebuf, whereFilter(pctx));
 }
 
-#endif	// #ifdef INTRIN_AVX
+// 条件求和_测试一个函数. 带宽按读取的列数计算.
+static void runWhereOne(WHERECTX* pctx, const char* szname, SUMF64WHEREPROC proc, double ref)
+{
+	SIMDBENCH_RESULT res;
+	pctx->proc = proc;
+	simdbench_run(&benchcfg, &res, szname, whereCall, pctx, BUFSIZE, (NULL!=pctx->pkey ? 2 : 1) * sizeof(buf[0]));
+	sprintf(res.szNote, "sum:%f err:%.3g", (double)pctx->n, (0!=ref) ? fabs(pctx->n - ref)/fabs(ref) : fabs((double)pctx->n));
+	simdbench_print(&benchcfg, &res);
+}
 
+// 条件求和: 在0%~100%的选择率下, 对比各条件求和内核与先用标量循环过滤、再用 simd_sum_f64 求和.
+// 单列的条件为 0 <= x < t（buf的值在[0, 32768)内）; 两列的条件为 lo <= key < hi, 区间以5000为中心. 参考值为过滤后的高精度和.
+void runWhereTest(int isa)
+{
+	static const int sels[] = {0, 1, 10, 25, 50, 75, 90, 99, 100};	// 选择率（%）.
+	size_t i, k;
+	int two;	// 是否为两列.
+	char szName[64];
+	double ref;	// 参考值.
+	const SUMF64WHEREKERNEL* pk;
+	WHERECTX ctx = {NULL, NULL, 0, 0, 0};
+	for(i=0; i<BUFSIZE; ++i)	wherekey[i] = (double)(rand() % 10000);
+	for(two=0; two<2; ++two)
+	{
+		ctx.pkey = two ? wherekey : NULL;
+		for(k=0; k<sizeof(sels)/sizeof(sels[0]); ++k)
+		{
+			if (two)
+			{
+				ctx.lo = (double)(5000 - 50*sels[k]);
+				ctx.hi = (double)(5000 + 50*sels[k]);
+			}
+			else
+			{
+				ctx.lo = 0;
+				ctx.hi = (double)(32768.0 * sels[k] / 100);
+			}
+			ref = sum_ref(wherebuf, whereFilter(&ctx));
+			for(pk=simdsum_kernels_f64_where(); NULL!=pk->szName; ++pk)
+			{
+				if (isa < pk->isa)	continue;
+				sprintf(szName, "%s(%s%d%%)", pk->szName, two ? "key," : "", sels[k]);
+				runWhereOne(&ctx, szName, pk->proc, ref);
+			}
+			sprintf(szName, "simd_sum_where_f64(%s%d%%)", two ? "key," : "", sels[k]);
+			runWhereOne(&ctx, szName, simd_sum_where_f64, ref);	// 运行时分派版.
+			sprintf(szName, "filter+simd_sum_f64(%s%d%%)", two ? "key," : "", sels[k]);
+			runWhereOne(&ctx, szName, NULL, ref);
+		}
+	}
+}
 
+// 跳过NaN求和用的数组. 由buf复制而来, 约1%的元素改为NaN.
+ATTR_ALIGN(32) static double nanbuf[BUFSIZE];
 
-//////////////////////////////////////////////////
-// main
-//////////////////////////////////////////////////
+// 跳过NaN求和的参考数组. nanbuf中的非NaN元素依次排列.
+static double nanref[BUFSIZE];
 
-// 变量对齐.
-#ifndef ATTR_ALIGN
-#  if defined(__GNUC__)	// GCC
-#    define ATTR_ALIGN(n)	__attribute__((aligned(n)))
-#  else	// 否则使用VC格式.
-#    define ATTR_ALIGN(n)	__declspec(align(n))
-#  endif
-#endif	// #ifndef ATTR_ALIGN
+// 跳过NaN求和时的调用参数.
+typedef struct tagNANCTX{
+	SUMF64NANPROC	proc;	// 被测函数.
+	size_t	cnt;	// 非NaN元素的个数.
+	volatile double	n;	// 结果. 避免调用被优化.
+}NANCTX;
 
+// 跳过NaN求和_调用一次.
+static void nanCall(void* param)
+{
+	NANCTX* pctx = (NANCTX*)param;
+	pctx->n = pctx->proc(nanbuf, BUFSIZE, &pctx->cnt);
+}
 
-#define BUFSIZE	204800
-ATTR_ALIGN(32) double buf[BUFSIZE];
+// 跳过NaN求和_测试一个函数. 个数与参考值不一致时标记ERR.
+static void runNanOne(const char* szname, SUMF64NANPROC proc, double ref, size_t cntref)
+{
+	NANCTX ctx = {proc, 0, 0};
+	SIMDBENCH_RESULT res;
+	simdbench_run(&benchcfg, &res, szname, nanCall, &ctx, BUFSIZE, sizeof(nanbuf[0]));
+	sprintf(res.szNote, "sum:%f err:%.3g cnt:%u %s", (double)ctx.n, fabs(ctx.n - ref)/fabs(ref), (unsigned)ctx.cnt, (ctx.cnt==cntref && ctx.n==ctx.n) ? "ok" : "ERR");
+	simdbench_print(&benchcfg, &res);
+}
 
-// 测试时的函数类型
-typedef double (*TESTPROC)(const double* pbuf, size_t cntbuf);
+// 跳过NaN求和: 约1%的元素为NaN, 对比各内核与对无NaN数组的普通求和, 看掩码与计数的开销. 参考值为非NaN元素的高精度和.
+void runNanTest(int isa)
+{
+	size_t i;
+	size_t cnt = 0;	// 非NaN元素的个数.
+	double ref;
+	const SUMF64NANKERNEL* pk;
+	for(i=0; i<BUFSIZE; ++i)
+	{
+		nanbuf[i] = (0==rand()%100) ? (double)NAN : buf[i];
+		if (nanbuf[i] == nanbuf[i])	nanref[cnt++] = nanbuf[i];
+	}
+	ref = sum_ref(nanref, cnt);
+	runTest("simd_sum_f64", simd_sum_f64);	// 对照: 无NaN的普通求和.
+	for(pk=simdsum_kernels_f64_nan(); NULL!=pk->szName; ++pk)
+	{
+		if (isa >= pk->isa)	runNanOne(pk->szName, pk->proc, ref, cnt);
+	}
+	runNanOne("simd_sum_f64_nan", simd_sum_f64_nan, ref, cnt);	// 运行时分派版.
+}
 
-// 进行测试
-void runTest(const char* szname, TESTPROC proc)
+// 工作集扫描_测试一个函数.
+static void runSweepOne(const SIMDBENCH_CFG* pcfg, TESTCTX* pctx, const char* szname, TESTPROC proc, size_t cb)
+{
+	SIMDBENCH_RESULT res;
+	pctx->proc = proc;
+	simdbench_run(pcfg, &res, szname, testCall, pctx, pctx->cntbuf, sizeof(pctx->pbuf[0]));
+	simdbench_sweep_note(res.szNote, cb);
+	simdbench_print(&benchcfg, &res);
+}
+
+// 工作集扫描: 数组从4KB增大到benchcfg.cbsweep, 测试各内核在各级缓存与内存中的吞吐量. 数据为buf的重复.
+void runSweep(int isa)
+{
+	size_t cntmax = benchcfg.cbsweep / sizeof(double);
+	size_t cb;
+	size_t cbprev = 0;
+	size_t i;
+	const SUMF64KERNEL* pk;
+	double* pbuf;
+	SIMDSUM_ARENA arena;
+	TESTCTX ctx = {NULL, NULL, 0, 0};
+	SIMDBENCH_CFG cfg;	// 当前大小所用的配置.
+	char szNote[32];	// 当前大小的附加说明.
+	FILE* fpinfo = simdbench_info(&benchcfg);
+
+	if (0!=simdsum_arena_init(&arena, cntmax * sizeof(double), benchcfg.page))
+	{
+		fprintf(stderr, "sweep: out of memory (%llu bytes).\n", (unsigned long long)(cntmax * sizeof(double)));
+		return;
+	}
+	pbuf = (double*)simdsum_arena_alloc(&arena, cntmax * sizeof(double));
+	fprintf(fpinfo, "pages:\t%s\n", simdsum_page_name(arena.page));
+	for(i=0; i<cntmax; ++i)	pbuf[i] = buf[i % BUFSIZE];
+	ctx.pbuf = pbuf;
+	for(cb=SIMDBENCH_SWEEP_MIN; cb<=cntmax*sizeof(double); cb=simdbench_sweep_next(cb))
+	{
+		simdbench_sweep_mark(fpinfo, cbprev, cb);
+		simdbench_sweep_cfg(&benchcfg, &cfg, cb);
+		simdbench_sweep_note(szNote, cb);
+		simdbench_stream(&benchcfg, &cfg, cb, szNote);
+		ctx.cntbuf = cb / sizeof(double);
+		for(pk=simdsum_kernels_f64(); NULL!=pk->szName; ++pk)
+		{
+			if (isa >= pk->isa)	runSweepOne(&cfg, &ctx, pk->szName, pk->proc, cb);
+		}
+		runSweepOne(&cfg, &ctx, "simd_sum_f64", simd_sum_f64, cb);
+		runSweepOne(&cfg, &ctx, "simd_sum_f64_nta", simd_sum_f64_nta, cb);
+		runSweepOne(&cfg, &ctx, "simd_sum_stats_f64", sum_stats, cb);
+		cbprev = cb;
+	}
+	simdsum_arena_free(&arena);
+}
+
+// 页面对比用的数组. [0]为普通页, [1]为大页.
+static double* pagebuf[2];
+
+// 页面对比用的数组的页面类型名称.
+static const char* pagename[2];
+
+// 页面对比_测试一个函数. 依次在普通页与大页的数组上测试, 大页一行的说明为相对普通页的加速比.
+static void runPageOne(const SIMDBENCH_CFG* pcfg, TESTCTX* pctx, const char* szname, TESTPROC proc)
+{
+	char szName[64];
+	double tmed = 0;	// 普通页的中位数.
+	SIMDBENCH_RESULT res;
+	int i;
+	pctx->proc = proc;
+	for(i=0; i<2; ++i)
+	{
+		pctx->pbuf = pagebuf[i];
+		sprintf(szName, "%s(%s)", szname, pagename[i]);
+		simdbench_run(pcfg, &res, szName, testCall, pctx, pctx->cntbuf, sizeof(pctx->pbuf[0]));
+		if (0==i)	tmed = res.tmed;
+		else	sprintf(res.szNote, "x%.3f vs %s", tmed / res.tmed, pagename[0]);
+		simdbench_print(&benchcfg, &res);
+	}
+}
+
+// 页面对比: 在远大于末级缓存的数组（benchcfg.cbpagecmp字节）上, 对比各内核用普通页与大页时的吞吐量, 即TLB缺失的影响. 数据为buf的重复.
+void runPageTest(int isa)
 {
-	const int testloop = 4000;	// 重复运算几次延长时间，避免计时精度问题.
-	const clock_t TIMEOUT = CLOCKS_PER_SEC/2;	// 最短测试时间.
+	static const int s_page[2] = {SIMDSUM_PAGE_4K, SIMDSUM_PAGE_HUGETLB};
+	size_t cnt = benchcfg.cbpagecmp / sizeof(double);
+	size_t i;
 	int j;
-	clock_t	tm0, dt;	// 存储时间.
-	double mps;	// M/s
-	volatile double n=0;	// 避免内循环被优化.
+	const SUMF64KERNEL* pk;
+	SIMDSUM_ARENA arena[2];
+	TESTCTX ctx = {NULL, NULL, 0, 0};
+	SIMDBENCH_CFG cfg;	// 按数组大小减少计时轮数.
+	FILE* fpinfo = simdbench_info(&benchcfg);
+
+	for(j=0; j<2; ++j)
+	{
+		if (0!=simdsum_arena_init(&arena[j], cnt * sizeof(double), s_page[j]))
+		{
+			fprintf(stderr, "pages: out of memory (%llu bytes).\n", (unsigned long long)(cnt * sizeof(double)));
+			if (0!=j)	simdsum_arena_free(&arena[0]);
+			return;
+		}
+		pagebuf[j] = (double*)simdsum_arena_alloc(&arena[j], cnt * sizeof(double));
+		pagename[j] = simdsum_page_name(arena[j].page);
+		for(i=0; i<cnt; ++i)	pagebuf[j][i] = buf[i % BUFSIZE];
+	}
+	fprintf(fpinfo, "pages:\t%s vs %s, %llu bytes\n", pagename[0], pagename[1], (unsigned long long)(cnt * sizeof(double)));
+	simdbench_sweep_cfg(&benchcfg, &cfg, cnt * sizeof(double));
+	ctx.cntbuf = cnt;
+
+	for(pk=simdsum_kernels_f64(); NULL!=pk->szName; ++pk)
+	{
+		if (isa >= pk->isa)	runPageOne(&cfg, &ctx, pk->szName, pk->proc);
+	}
+	runPageOne(&cfg, &ctx, "simd_sum_f64", simd_sum_f64);
+	runPageOne(&cfg, &ctx, "simd_sum_f64_nta", simd_sum_f64_nta);
 
-	tm0 = clock();
+	simdsum_arena_free(&arena[1]);
+	simdsum_arena_free(&arena[0]);
+}
 
-	for(j=1; j<=testloop; ++j)	// 重复运算几次延长时间，避免计时开销带来的影响.
+// 文件求和_调用一次. 结果保存到n, 元素数保存到cntbuf.
+static void fileCall(void* param)
+{
+	TESTCTX* pctx = (TESTCTX*)param;
+	double s = 0;
+	simd_sum_file_f64(benchcfg.szfile, &s, &pctx->cntbuf);
+	pctx->n = s;
+}
+
+// 文件求和_清空页缓存.
+static void fileDrop(void* param)
+{
+	(void)param;
+	simdbench_dropcache(benchcfg.szfile);
+}
+
+// 流水线参数. 由 runIngestTest 设置.
+static SIMDSUM_INGEST ingestcfg;
+
+// 只读取_调用一次. 测量I/O带宽.
+static void readCall(void* param)
+{
+	int fd = simdbench_open(benchcfg.szfile);
+	(void)param;
+	if (fd < 0)	return;
+	simdbench_readfd(fd, SIMDSUM_INGEST_CHUNK, ingestcfg.cblimit);
+	simdbench_close(fd);
+}
+
+// 流水线读取求和_调用一次. 结果保存到n.
+static void ingestCall(void* param)
+{
+	TESTCTX* pctx = (TESTCTX*)param;
+	double s = 0;
+	int fd = simdbench_open(benchcfg.szfile);
+	if (fd < 0)	return;
+	simd_sum_fd_f64(fd, &ingestcfg, &s, NULL);
+	simdbench_close(fd);
+	pctx->n = s;
+}
+
+// 流水线读取求和: 依次测试只读取、串行（读一块求一块）、流水线.
+// 流水线一行的说明附上两个估计值: 完全重叠时为 min(I/O, 求和), 完全串行时为调和组合 1/(1/I/O + 1/求和).
+//
+// pcfg: 测试配置.
+// szmode: 名称中的模式, 为"warm", "cold"或"dev".
+// cold: 是否在每轮之前清空页缓存.
+// cb: 读取的字节数.
+// gbpssum: 对缓存中的一块求和的带宽.
+static void runIngestTest(const SIMDBENCH_CFG* pcfg, const char* szmode, int cold, uint64_t cb, double gbpssum)
+{
+	static const char* const s_szName[3] = {"read(", "simd_sum_fd_f64(serial,", "simd_sum_fd_f64(pipe,"};
+	char szName[64];
+	double gbpsio;
+	TESTCTX ctx = {NULL, NULL, 0, 0};
+	SIMDBENCH_RESULT res;
+	size_t cnt = (size_t)(cb / sizeof(double));
+	int i;
+
+	for(i=0; i<3; ++i)
 	{
-		n = proc(buf, BUFSIZE);	// 避免内循环被编译优化消掉.
+		ingestcfg.depth = (0==i) ? 0 : (1==i) ? 1 : SIMDSUM_INGEST_DEPTH;
+		sprintf(szName, "%s%s)", s_szName[i], szmode);
+		if (cold)	simdbench_run_prep(pcfg, &res, szName, (0==i) ? readCall : ingestCall, fileDrop, &ctx, cnt, sizeof(double));
+		else	simdbench_run(pcfg, &res, szName, (0==i) ? readCall : ingestCall, &ctx, cnt, sizeof(double));
+		if (0==i)
+		{
+			gbpsio = res.gbps;
+		}
+		else if (1==i)
+		{
+			sprintf(res.szNote, "sum:%f", (double)ctx.n);
+		}
+		else
+		{
+			sprintf(res.szNote, "sum:%f overlap:%.2f serial:%.2f", (double)ctx.n,
+				(gbpsio < gbpssum) ? gbpsio : gbpssum, 1.0 / (1.0/gbpsio + 1.0/gbpssum));
+		}
+		simdbench_print(&benchcfg, &res);
 	}
+}
 
-	dt = clock() - tm0;
-	double time_s = (double)dt / CLOCKS_PER_SEC;
-	// show
-	mps = (double)testloop*BUFSIZE*CLOCKS_PER_SEC/(1024.0*1024.0*dt);
-	printf("%s:\t\t  io: %.0f mb/s\t  time:%f s sum:%f\n", szname, mps, time_s, n);
+// 文件求和: 用 simd_sum_file_f64 映射文件并求和, 测试含映射与缺页的端到端带宽; 再用 simd_sum_fd_f64 测试读取与求和重叠的流水线.
+// 分别测试页缓存已预热（warm）与已清空（cold）时的情况. 输入为设备或管道（例如/dev/zero）时只测试流水线.
+void runFileTest(void)
+{
+	int rt;
+	int isdev = simdbench_isdevice(benchcfg.szfile);
+	double s;
+	size_t cnt;	// 元素数.
+	uint64_t cb;	// 字节数.
+	double gbpssum;	// 对缓存中的一块求和的带宽.
+	TESTCTX ctx = {NULL, NULL, 0, 0};
+	SIMDBENCH_CFG cfg;	// 按文件大小减少计时轮数.
+	SIMDBENCH_RESULT res;
+	FILE* fpinfo = simdbench_info(&benchcfg);
+
+	if (isdev)
+	{
+		cb = (0!=benchcfg.cbfile) ? benchcfg.cbfile : SIMDBENCH_DEVICE_BYTES;
+		fprintf(fpinfo, "file:\t%s (device, %llu bytes)\n", benchcfg.szfile, (unsigned long long)cb);
+		ingestcfg.cblimit = cb;
+	}
+	else
+	{
+		if (0!=benchcfg.cbfile)
+		{
+			rt = simdbench_mkfile(benchcfg.szfile, buf, sizeof(buf), benchcfg.cbfile);
+			if (0!=rt)
+			{
+				fprintf(stderr, "file: cannot create %s (%d).\n", benchcfg.szfile, rt);
+				return;
+			}
+		}
+		rt = simd_sum_file_f64(benchcfg.szfile, &s, &cnt);	// 同时预热页缓存.
+		if (0!=rt)
+		{
+			fprintf(stderr, "file: cannot map %s (%d).\n", benchcfg.szfile, rt);
+			return;
+		}
+		cb = cnt * sizeof(double);
+		fprintf(fpinfo, "file:\t%s (%llu bytes)\n", benchcfg.szfile, (unsigned long long)cb);
+		ingestcfg.cblimit = 0;
+	}
+	simdbench_sweep_cfg(&benchcfg, &cfg, (size_t)cb);
+
+	// 求和带宽: 与流水线一样, 每次对缓存中的一块求和.
+	ctx.proc = simd_sum_f64;
+	ctx.pbuf = buf;
+	ctx.cntbuf = SIMDSUM_INGEST_CHUNK / sizeof(double);
+	simdbench_run(&benchcfg, &res, "simd_sum_f64(chunk)", testCall, &ctx, ctx.cntbuf, sizeof(double));
+	gbpssum = res.gbps;
+	simdbench_print(&benchcfg, &res);
+
+	if (isdev)
+	{
+		runIngestTest(&cfg, "dev", 0, cb, gbpssum);
+		return;
+	}
+
+	simdbench_run(&cfg, &res, "simd_sum_file_f64(warm)", fileCall, &ctx, cnt, sizeof(double));
+	sprintf(res.szNote, "sum:%f", (double)ctx.n);
+	simdbench_print(&benchcfg, &res);
+	runIngestTest(&cfg, "warm", 0, cb, gbpssum);
+
+	if (0!=simdbench_dropcache(benchcfg.szfile))
+	{
+		fprintf(stderr, "file: cannot drop the page cache, cold test skipped.\n");
+		return;
+	}
+	simdbench_run_prep(&cfg, &res, "simd_sum_file_f64(cold)", fileCall, fileDrop, &ctx, cnt, sizeof(double));
+	sprintf(res.szNote, "sum:%f", (double)ctx.n);
+	simdbench_print(&benchcfg, &res);
+	runIngestTest(&cfg, "cold", 1, cb, gbpssum);
 }
 
 int main(int argc, char* argv[])
 {
 	char szBuf[64];
 	int i;
-
-	printf("simdsumdouble v1.00 (%dbit)\n", INTRIN_WORDSIZE);
-	printf("Compiler: %s\n", COMPILER_NAME);
+	int isa, hwisa;	// 指令集级别.
+	int cntthreads;	// 线程池的线程数.
+	const SUMF64KERNEL* pk;
+	FILE* fpinfo;	// 说明文字的输出流.
+
+	simdbench_init(&benchcfg, argc, argv);
+	fpinfo = simdbench_info(&benchcfg);
+	fprintf(fpinfo, "simdsumdouble v1.00 (%dbit)\n", INTRIN_WORDSIZE);
+	fprintf(fpinfo, "Compiler: %s\n", COMPILER_NAME);
 	cpu_getbrand(szBuf);
-	printf("CPU:\t%s\n", szBuf);
-	printf("\n");
+	fprintf(fpinfo, "CPU:\t%s\n", szBuf);
+	isa = simdsum_isa(&hwisa);
+	fprintf(fpinfo, "ISA:\t%s (hw: %s)\n", simdsum_isa_name(isa), simdsum_isa_name(hwisa));
+	fprintf(fpinfo, "Prefetch:\t%u bytes ahead, line %u bytes\n", (unsigned)simdsum_prefetch_dist(), (unsigned)simdsum_cacheline());
+	fprintf(fpinfo, "\n");
 
 	// init buf
 	srand( (unsigned)time( NULL ) );
-	for (i = 0; i < BUFSIZE; i++) buf[i] = (double)(rand() & 0x7fff);	// 使用&0x7fff是为了让求和后的数值在一定范围内，便于观察结果是否正确.
+	for (i = 0; i < BUFSIZE; i++) buf[i] = (double)rand() * (32768.0 / RAND_MAX);	// 使用带小数的值, 以便观察各函数的舍入误差. err为相对参考值的相对误差.
+	refsum = sum_ref(buf, BUFSIZE);
+	fprintf(fpinfo, "ref:\t%f\n", refsum);
+
+	// 工作集扫描模式: 只进行扫描.
+	if (0!=benchcfg.cbsweep)
+	{
+		runSweep(isa);
+		simdbench_end(&benchcfg);
+		return 0;
+	}
+
+	// 页面对比模式: 只对比普通页与大页.
+	if (0!=benchcfg.cbpagecmp)
+	{
+		runPageTest(isa);
+		simdbench_end(&benchcfg);
+		return 0;
+	}
+
+	// 文件求和模式: 只测试文件求和.
+	if (NULL!=benchcfg.szfile)
+	{
+		runFileTest();
+		simdbench_end(&benchcfg);
+		return 0;
+	}
+
+	// 带宽基准. 之后各结果的%read为占只读带宽的百分比.
+	simdbench_stream(&benchcfg, &benchcfg, sizeof(buf), "");
 
 	// test
-	runTest("sumdouble_base", sumdouble_base);	// 双精度浮点数组求和_基本版.
-#ifdef INTRIN_SSE2
-	if (simd_sse_level(NULL) >= SIMD_SSE_2)
+	for(pk=simdsum_kernels_f64(); NULL!=pk->szName; ++pk)
 	{
-		runTest("sumdouble_sse", sumdouble_sse);	// 双精度浮点数组求和_SSE版.
-		runTest("sumdouble_sse_4", sumdouble_sse_4loop);	// 双精度浮点数组求和_SSE四路循环展开版.
+		if (isa >= pk->isa)	runTest(pk->szName, pk->proc);
 	}
-#endif	// #ifdef INTRIN_SSE2
-#ifdef INTRIN_AVX
-	if (simd_avx_level(NULL) >= SIMD_AVX_1)
+	runTest("simd_sum_f64", simd_sum_f64);	// 运行时分派版.
+	runTest("simd_sum_f64_nta", simd_sum_f64_nta);	// 运行时分派版_流式.
+
+	// 多线程扩展性: 1~N线程.
+	cntthreads = simdsum_mt_init(0);
+	for(nthreads_mt=1; nthreads_mt<=cntthreads; ++nthreads_mt)
 	{
-		runTest("sumdouble_avx", sumdouble_avx);	// 双精度浮点数组求和_SSE版.
-		runTest("sumdouble_avx_4", sumdouble_avx_4loop);	// 双精度浮点数组求和_SSE四路循环展开版.
+		sprintf(szBuf, "simd_sum_f64_mt(%d)", nthreads_mt);
+		runTest(szBuf, sum_mt);
 	}
-#endif	// #ifdef INTRIN_AVX
+	simdsum_mt_exit();
+
+	// 任意对齐: 各字节偏移下的吞吐量.
+	fprintf(fpinfo, "\n");
+	runOffsetTest("simd_sum_f64", simd_sum_f64);
+
+	// 分段求和: 许多小数组, 一次调用与逐段调用对比.
+	fprintf(fpinfo, "\n");
+	runSegTest(isa);
+
+	// 单遍统计: 和、最小值、最大值与平方和.
+	fprintf(fpinfo, "\n");
+	runStatsTest(isa);
+
+	// 点积: 加权求和. 权重为[0,1)内的随机数.
+	fprintf(fpinfo, "\n");
+	runDotTest(isa);
+
+	// 前缀和: 累计和. 各行的sum即总和.
+	fprintf(fpinfo, "\n");
+	runScanTest(isa);
+
+	// 字段求和: 结构体数组中的一个字段, 与先转为SoA再求和对比.
+	fprintf(fpinfo, "\n");
+	runStrideTest(isa);
+
+	// 条件求和: 各种选择率下的单列与两列条件.
+	fprintf(fpinfo, "\n");
+	runWhereTest(isa);
+
+	// 跳过NaN: 约1%的NaN, 与无NaN的普通求和对比.
+	fprintf(fpinfo, "\n");
+	runNanTest(isa);
 
+	simdbench_end(&benchcfg);
 	return 0;
 }
@@ -1,9 +1,13 @@
 ﻿#include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
 #include <time.h>
 
 #include "zintrin.h"
 #include "ccpuid.h"
+#include "simdsum.h"
+#include "simdbench.h"
 
 
 // Compiler name
@@ -39,280 +43,1085 @@
 
 
 //////////////////////////////////////////////////
-// sumint: 32位整数数组求和的函数
+// main
 //////////////////////////////////////////////////
 
-// 32位整数数组求和_基本版.
-//
-// result: 返回数组求和结果.
-// pbuf: 数组的首地址.
-// cntbuf: 数组长度.
-int32_t sumint_base(const int32_t* pbuf, size_t cntbuf)
+// 变量对齐.
+#ifndef ATTR_ALIGN
+#  if defined(__GNUC__)	// GCC
+#    define ATTR_ALIGN(n)	__attribute__((aligned(n)))
+#  else	// 否则使用VC格式.
+#    define ATTR_ALIGN(n)	__declspec(align(n))
+#  endif
+#endif	// #ifndef ATTR_ALIGN
+
+
+#define BUFSIZE	409600
+ATTR_ALIGN(32) int32_t buf[BUFSIZE];
+ATTR_ALIGN(64) char bufofs[sizeof(buf) + 64];	// 偏移测试用. 数据复制到各字节偏移处.
+
+// 测试时的函数类型
+typedef int32_t (*TESTPROC)(const int32_t* pbuf, size_t cntbuf);
+
+// 64位结果测试时的函数类型
+typedef int64_t (*TESTWIDEPROC)(const int32_t* pbuf, size_t cntbuf);
+
+// 测试时的调用参数.
+typedef struct tagTESTCTX{
+	TESTPROC	proc;	// 被测函数.
+	TESTWIDEPROC	procwide;	// 被测函数_64位结果. proc为NULL时使用.
+	const int32_t*	pbuf;	// 数组的首地址.
+	size_t	cntbuf;	// 数组长度.
+	volatile int64_t	n;	// 结果. 避免调用被优化.
+}TESTCTX;
+
+// 测试配置.
+static SIMDBENCH_CFG benchcfg;
+
+// 64位结果测试时的参考值. 由基本版算出.
+static int64_t refwide = 0;
+
+// 并行求和测试时的线程数.
+static int nthreads_mt = 1;
+
+// 并行求和_测试用包装.
+static int32_t sum_mt(const int32_t* pbuf, size_t cntbuf)
+{
+	return simd_sum_i32_mt(pbuf, cntbuf, nthreads_mt);
+}
+
+// 单遍统计_测试用包装. 返回和, 用于工作集扫描中与求和对比.
+static int64_t sum_stats(const int32_t* pbuf, size_t cntbuf)
+{
+	SIMDSUM_STATS st;
+	simd_sum_stats_i32(pbuf, cntbuf, &st);
+	return (int64_t)st.sum;
+}
+
+// 前缀和测试的被测函数. scanCall 以 runTest 的函数类型调用它.
+static SCANI32PROC scanproc = NULL;
+
+// 前缀和测试是否不含自身.
+static int scanexcl = 0;
+
+// 前缀和的结果.
+ATTR_ALIGN(32) static int32_t scanbuf[BUFSIZE];
+
+// 前缀和_测试用包装. 返回总和, 故可与求和的结果对照.
+static int32_t scanCall(const int32_t* pbuf, size_t cntbuf)
 {
-	int32_t s = 0;	// 求和变量.
+	return scanproc(scanbuf, pbuf, cntbuf, 0, scanexcl);
+}
+
+// 并行前缀和_测试用包装.
+static int32_t scanCallMt(const int32_t* pbuf, size_t cntbuf)
+{
+	return simd_scan_i32_mt(scanbuf, pbuf, cntbuf, 0, scanexcl, nthreads_mt);
+}
+
+// 调用一次被测函数.
+static void testCall(void* param)
+{
+	TESTCTX* pctx = (TESTCTX*)param;
+	if (NULL!=pctx->proc)	pctx->n = pctx->proc(pctx->pbuf, pctx->cntbuf);
+	else	pctx->n = pctx->procwide(pctx->pbuf, pctx->cntbuf);
+}
+
+// 进行测试
+void runTest(const char* szname, TESTPROC proc)
+{
+	TESTCTX ctx = {proc, NULL, buf, BUFSIZE, 0};
+	SIMDBENCH_RESULT res;
+	simdbench_run(&benchcfg, &res, szname, testCall, &ctx, BUFSIZE, sizeof(buf[0]));
+	sprintf(res.szNote, "sum:%ld", (long)(int32_t)ctx.n);
+	simdbench_print(&benchcfg, &res);
+}
+
+// 进行测试_64位结果. 并与参考值比较.
+void runTestWide(const char* szname, TESTWIDEPROC proc)
+{
+	TESTCTX ctx = {NULL, proc, buf, BUFSIZE, 0};
+	SIMDBENCH_RESULT res;
+	simdbench_run(&benchcfg, &res, szname, testCall, &ctx, BUFSIZE, sizeof(buf[0]));
+	sprintf(res.szNote, "sum:%lld %s", (long long)ctx.n, (ctx.n==refwide)?"ok":"ERR");
+	simdbench_print(&benchcfg, &res);
+}
+
+// 测试各字节偏移(0~63)下的吞吐量. 将buf复制到bufofs+偏移处再求和, 数据与runTest相同. 计时轮数为其他测试的1/5.
+void runOffsetTest(const char* szname, TESTPROC proc)
+{
+	int off;
+	char szName[64];
+	TESTCTX ctx = {proc, NULL, NULL, BUFSIZE, 0};
+	SIMDBENCH_CFG cfg = benchcfg;
+	SIMDBENCH_RESULT res;
+
+	cfg.trials = (benchcfg.trials+4) / 5;
+	for(off=0; off<64; ++off)
+	{
+		ctx.pbuf = (const int32_t*)(bufofs + off);
+		memcpy(bufofs + off, buf, sizeof(buf));
+		sprintf(szName, "%s+%d", szname, off);
+		simdbench_run(&cfg, &res, szName, testCall, &ctx, BUFSIZE, sizeof(buf[0]));
+		sprintf(res.szNote, "sum:%ld", (long)(int32_t)ctx.n);
+		simdbench_print(&benchcfg, &res);
+	}
+}
+
+// 分段求和用的偏移数组.
+static size_t segoffs[BUFSIZE+1];
+
+// 分段求和的结果. segref为逐段调用 simd_sum_i32 的结果, 用于核对.
+static int32_t segsums[BUFSIZE];
+static int32_t segref[BUFSIZE];
+
+// 分段求和时的调用参数.
+typedef struct tagSEGCTX{
+	SUMI32SEGPROC	proc;	// 被测函数. NULL表示逐段调用 simd_sum_i32.
+	size_t	cntseg;	// 段数.
+}SEGCTX;
+
+// 分段求和_调用一次.
+static void segCall(void* param)
+{
+	SEGCTX* pctx = (SEGCTX*)param;
 	size_t i;
-	for(i=0; i<cntbuf; ++i)
+	if (NULL!=pctx->proc)
+	{
+		pctx->proc(buf, segoffs, pctx->cntseg, segsums);
+		return;
+	}
+	for(i=0; i<pctx->cntseg; ++i)
 	{
-		s += pbuf[i];
+		segsums[i] = simd_sum_i32(buf + segoffs[i], segoffs[i+1] - segoffs[i]);
 	}
-	return s;
 }
 
-#ifdef INTRIN_MMX
-// 32位整数数组求和_MMX版.
-int32_t sumint_mmx(const int32_t* pbuf, size_t cntbuf)
+// 分段求和_测试一个函数. 逐段调用的一行附上段数与平均段长, 其余各行附上与它的核对结果.
+static void runSegOne(SEGCTX* pctx, const char* szname, SUMI32SEGPROC proc)
 {
-	int32_t s = 0;	// 求和变量.
 	size_t i;
-	size_t nBlockWidth = 2;	// 块宽. MMX寄存器能一次处理2个int32_t.
-	size_t cntBlock = cntbuf / nBlockWidth;	// 块数.
-	size_t cntRem = cntbuf % nBlockWidth;	// 剩余数量.
-	__m64 midSum = _mm_setzero_si64();	// 求和变量。[MMX] PXOR, 赋初值0.
-	__m64 midLoad;	// 加载.
-	const __m64* p = (const __m64*)pbuf;	// MMX批量处理时所用的指针.
-	const int32_t* q;	// 单个数据处理时所用指针.
+	size_t cnterr = 0;	// 结果不同的段数.
+	SIMDBENCH_RESULT res;
+	pctx->proc = proc;
+	simdbench_run(&benchcfg, &res, szname, segCall, pctx, segoffs[pctx->cntseg], sizeof(buf[0]));
+	if (NULL==proc)
+	{
+		memcpy(segref, segsums, pctx->cntseg * sizeof(segsums[0]));
+		sprintf(res.szNote, "segs:%u avg:%.1f", (unsigned)pctx->cntseg, (double)segoffs[pctx->cntseg] / pctx->cntseg);
+	}
+	else
+	{
+		for(i=0; i<pctx->cntseg; ++i)
+		{
+			if (segsums[i] != segref[i])	++cnterr;
+		}
+		sprintf(res.szNote, "%s", (0==cnterr)?"ok":"ERR");
+	}
+	simdbench_print(&benchcfg, &res);
+}
 
-	// MMX批量处理.
-	for(i=0; i<cntBlock; ++i)
+// 分段求和: 在各种段长分布下, 对比逐段调用 simd_sum_i32 与各分段求和内核. 数值数组为buf, 各段依次排列.
+void runSegTest(int isa)
+{
+	int dist;
+	const char* szdist;	// 分布的名称.
+	char szName[64];
+	const SUMI32SEGKERNEL* pk;
+	SEGCTX ctx = {NULL, 0};
+	for(dist=0; dist<SIMDBENCH_SEG_COUNT; ++dist)
+	{
+		szdist = simdbench_seg_name(dist);
+		ctx.cntseg = simdbench_segoffs(segoffs, BUFSIZE, dist);
+		sprintf(szName, "simd_sum_i32(loop,%s)", szdist);
+		runSegOne(&ctx, szName, NULL);
+		for(pk=simdsum_kernels_i32_seg(); NULL!=pk->szName; ++pk)
+		{
+			if (isa < pk->isa)	continue;
+			sprintf(szName, "%s(%s)", pk->szName, szdist);
+			runSegOne(&ctx, szName, pk->proc);
+		}
+		sprintf(szName, "simd_sum_seg_i32(%s)", szdist);
+		runSegOne(&ctx, szName, simd_sum_seg_i32);
+	}
+}
+
+// 单遍统计时的调用参数.
+typedef struct tagSTATSCTX{
+	SUMI32STATSPROC	proc;	// 被测函数.
+	SIMDSUM_STATS	st;	// 结果.
+}STATSCTX;
+
+// 单遍统计_调用一次.
+static void statsCall(void* param)
+{
+	STATSCTX* pctx = (STATSCTX*)param;
+	pctx->proc(buf, BUFSIZE, &pctx->st);
+}
+
+// 单遍统计_测试一个函数. 和与 refwide 核对. merge为把buf分4块分别统计再合并后, 离差平方和与整体统计的相对差.
+static void runStatsOne(STATSCTX* pctx, const char* szname, SUMI32STATSPROC proc)
+{
+	size_t i;
+	double e;
+	SIMDSUM_STATS part;
+	SIMDSUM_STATS merged;
+	SIMDBENCH_RESULT res;
+	pctx->proc = proc;
+	simdbench_run(&benchcfg, &res, szname, statsCall, pctx, BUFSIZE, sizeof(buf[0]));
+	simdsum_stats_init(&merged);
+	for(i=0; i<4; ++i)
+	{
+		proc(buf + BUFSIZE*i/4, BUFSIZE*(i+1)/4 - BUFSIZE*i/4, &part);
+		simdsum_stats_merge(&merged, &part);
+	}
+	e = fabs(merged.m2 - pctx->st.m2) / pctx->st.m2;
+	sprintf(res.szNote, "sum:%lld %s sd:%.6g min:%g max:%g merge:%.3g", (long long)pctx->st.sum, ((int64_t)pctx->st.sum==refwide)?"ok":"ERR", sqrt(simdsum_stats_var(&pctx->st, 0)), pctx->st.min, pctx->st.max, e);
+	simdbench_print(&benchcfg, &res);
+}
+
+// 单遍统计: 一次读取求出和、最小值、最大值与平方和. %read可与求和各行对比.
+void runStatsTest(int isa)
+{
+	const SUMI32STATSKERNEL* pk;
+	STATSCTX ctx;
+	ctx.proc = NULL;
+	for(pk=simdsum_kernels_i32_stats(); NULL!=pk->szName; ++pk)
 	{
-		midLoad = *p;	// [MMX] MOVQ. 加载.
-		midSum = _mm_add_pi32(midSum, midLoad);	// [MMX] PADDD. 32位整数紧缩环绕加法.
-		p ++;
+		if (isa >= pk->isa)	runStatsOne(&ctx, pk->szName, pk->proc);
 	}
-	// 合并.
-	q = (const int32_t*)&midSum;
-	s = q[0] + q[1];
+	runStatsOne(&ctx, "simd_sum_stats_i32", simd_sum_stats_i32);	// 运行时分派版.
+}
+
+// 原地前缀和_准备: 把buf复制到scanbuf.
+static void scanPrep(void* param)
+{
+	(void)param;
+	memcpy(scanbuf, buf, sizeof(buf));
+}
+
+// 原地前缀和_调用一次.
+static void scanInplaceCall(void* param)
+{
+	TESTCTX* pctx = (TESTCTX*)param;
+	pctx->n = scanproc(scanbuf, scanbuf, BUFSIZE, 0, scanexcl);
+}
+
+// 前缀和: 含自身（incl）与不含自身（excl）两种, 各内核与基本版（标量循环）对比. 之后是原地计算与多线程两遍版.
+// 带宽只按读取源数组计算, 未计入写入.
+void runScanTest(int isa)
+{
+	int cntthreads;
+	char szName[64];
+	const SCANI32KERNEL* pk;
+	TESTCTX ctx = {NULL, NULL, buf, BUFSIZE, 0};
+	SIMDBENCH_RESULT res;
+	for(scanexcl=0; scanexcl<2; ++scanexcl)
+	{
+		for(pk=simdsum_kernels_i32_scan(); NULL!=pk->szName; ++pk)
+		{
+			if (isa < pk->isa)	continue;
+			scanproc = pk->proc;
+			sprintf(szName, "%s(%s)", pk->szName, scanexcl ? "excl" : "incl");
+			runTest(szName, scanCall);
+		}
+		scanproc = simd_scan_i32;
+		sprintf(szName, "simd_scan_i32(%s)", scanexcl ? "excl" : "incl");
+		runTest(szName, scanCall);	// 运行时分派版.
+	}
+
+	// 原地: 每轮先把buf复制到scanbuf（不计时）, 故没有预热.
+	scanexcl = 0;
+	scanproc = simd_scan_i32;
+	simdbench_run_prep(&benchcfg, &res, "simd_scan_i32(inplace)", scanInplaceCall, scanPrep, &ctx, BUFSIZE, sizeof(buf[0]));
+	sprintf(res.szNote, "sum:%ld", (long)(int32_t)ctx.n);
+	simdbench_print(&benchcfg, &res);
 
-	// 处理剩下的.
-	q = (const int32_t*)p;
-	for(i=0; i<cntRem; ++i)
+	// 多线程两遍版: 1~N线程.
+	cntthreads = simdsum_mt_init(0);
+	for(nthreads_mt=1; nthreads_mt<=cntthreads; ++nthreads_mt)
 	{
-		s += q[i];
+		sprintf(szName, "simd_scan_i32_mt(%d)", nthreads_mt);
+		runTest(szName, scanCallMt);
 	}
+	simdsum_mt_exit();
+}
+
+// 64位前缀和的源数组与结果.
+ATTR_ALIGN(32) static int64_t buf64[BUFSIZE];
+ATTR_ALIGN(32) static int64_t scanbuf64[BUFSIZE];
+
+// 64位前缀和测试的被测函数.
+static SCANI64PROC scanproc64 = NULL;
+
+// 64位前缀和_调用一次.
+static void scan64Call(void* param)
+{
+	TESTCTX* pctx = (TESTCTX*)param;
+	pctx->n = scanproc64(scanbuf64, buf64, BUFSIZE, 0, scanexcl);
+}
 
-	// 清理MMX状态.
-	_mm_empty();	// [MMX] EMMS.
+// 64位前缀和_测试一个函数. 总和与refwide核对.
+static void runScan64One(const char* szname, SCANI64PROC proc)
+{
+	TESTCTX ctx = {NULL, NULL, buf, BUFSIZE, 0};
+	SIMDBENCH_RESULT res;
+	scanproc64 = proc;
+	simdbench_run(&benchcfg, &res, szname, scan64Call, &ctx, BUFSIZE, sizeof(buf64[0]));
+	sprintf(res.szNote, "sum:%lld %s", (long long)ctx.n, (ctx.n==refwide)?"ok":"ERR");
+	simdbench_print(&benchcfg, &res);
+}
 
-	return s;
+// 64位前缀和: 数据为buf的符号扩展, 故总和应等于refwide.
+void runScan64Test(int isa)
+{
+	size_t i;
+	char szName[64];
+	const SCANI64KERNEL* pk;
+	for(i=0; i<BUFSIZE; ++i)	buf64[i] = buf[i];
+	for(scanexcl=0; scanexcl<2; ++scanexcl)
+	{
+		for(pk=simdsum_kernels_i64_scan(); NULL!=pk->szName; ++pk)
+		{
+			if (isa < pk->isa)	continue;
+			sprintf(szName, "%s(%s)", pk->szName, scanexcl ? "excl" : "incl");
+			runScan64One(szName, pk->proc);
+		}
+		sprintf(szName, "simd_scan_i64(%s)", scanexcl ? "excl" : "incl");
+		runScan64One(szName, simd_scan_i64);
+	}
 }
 
-// 32位整数数组求和_MMX四路循环展开版.
-int32_t sumint_mmx_4loop(const int32_t* pbuf, size_t cntbuf)
+// 字段求和用的结构体数组. 共STRIDE_CNT个记录, 按最大步长分配. 字段位于各记录的STRIDE_OFS字节处, 值为buf的前STRIDE_CNT个元素.
+#define STRIDE_CNT	65536
+#define STRIDE_OFS	4
+#define STRIDE_MAXCB	128	// 最大步长.
+static char* stridebuf = NULL;
+
+// 先转为SoA时的目标数组.
+ATTR_ALIGN(32) static int32_t soabuf[STRIDE_CNT];
+
+// 字段求和时的调用参数.
+typedef struct tagSTRIDECTX{
+	SUMI32STRIDEPROC	proc;	// 被测函数. NULL表示先把字段复制到soabuf, 再用 simd_sum_i32 求和.
+	size_t	cbstride;	// 步长（字节）.
+	volatile int32_t	n;	// 结果. 避免调用被优化.
+}STRIDECTX;
+
+// 字段求和_调用一次.
+static void strideCall(void* param)
 {
-	int32_t s = 0;	// 返回值.
+	STRIDECTX* pctx = (STRIDECTX*)param;
 	size_t i;
-	size_t nBlockWidth = 2*4;	// 块宽. MMX寄存器能一次处理2个int32_t，然后循环展开4次.
-	size_t cntBlock = cntbuf / nBlockWidth;	// 块数.
-	size_t cntRem = cntbuf % nBlockWidth;	// 剩余数量.
-	__m64 midSum = _mm_setzero_si64();	// 求和变量。[MMX] PXOR, 赋初值0.
-	__m64 midSum1 = _mm_setzero_si64();
-	__m64 midSum2 = _mm_setzero_si64();
-	__m64 midSum3 = _mm_setzero_si64();
-	__m64 midLoad;	// 加载.
-	__m64 midLoad1;
-	__m64 midLoad2;
-	__m64 midLoad3;
-	const __m64* p = (const __m64*)pbuf;	// MMX批量处理时所用的指针.
-	const int32_t* q;	// 单个数据处理时所用指针.
-
-	// SSE批量处理.
-	for(i=0; i<cntBlock; ++i)
-	{
-		midLoad = *p;	// [MMX] MOVQ. 加载.
-		midLoad1 = *(p+1);
-		midLoad2 = *(p+2);
-		midLoad3 = *(p+3);
-		midSum = _mm_add_pi32(midSum, midLoad);	// [MMX] PADDD. 32位整数紧缩环绕加法.
-		midSum1 = _mm_add_pi32(midSum1, midLoad1);
-		midSum2 = _mm_add_pi32(midSum2, midLoad2);
-		midSum3 = _mm_add_pi32(midSum3, midLoad3);
-		p += 4;	// 四路循环展开.
-	}
-	// 合并.
-	midSum = _mm_add_pi32(midSum, midSum1);	// 两两合并(0~1).
-	midSum2 = _mm_add_pi32(midSum2, midSum3);	// 两两合并(2~3).
-	midSum = _mm_add_pi32(midSum, midSum2);	// 两两合并(0~3).
-	q = (const int32_t*)&midSum;
-	s = q[0] + q[1];
-
-	// 处理剩下的.
-	q = (const int32_t*)p;
-	for(i=0; i<cntRem; ++i)
-	{
-		s += q[i];
-	}
-
-	// 清理MMX状态.
-	_mm_empty();	// [MMX] EMMS.
-
-	return s;
-}
-#endif	// #ifdef INTRIN_MMX
-
-
-#ifdef INTRIN_SSE2
-// 32位整数数组求和_SSE版.
-int32_t sumint_sse(const int32_t* pbuf, size_t cntbuf)
-{
-	int32_t s = 0;	// 求和变量.
+	if (NULL!=pctx->proc)
+	{
+		pctx->n = pctx->proc(stridebuf, STRIDE_CNT, pctx->cbstride, STRIDE_OFS);
+		return;
+	}
+	for(i=0; i<STRIDE_CNT; ++i)
+	{
+		memcpy(&soabuf[i], stridebuf + i*pctx->cbstride + STRIDE_OFS, sizeof(soabuf[0]));
+	}
+	pctx->n = simd_sum_i32(soabuf, STRIDE_CNT);
+}
+
+// 字段求和_测试一个函数.
+static void runStrideOne(STRIDECTX* pctx, const char* szname, SUMI32STRIDEPROC proc, int32_t ref)
+{
+	SIMDBENCH_RESULT res;
+	pctx->proc = proc;
+	simdbench_run(&benchcfg, &res, szname, strideCall, pctx, STRIDE_CNT, sizeof(soabuf[0]));
+	sprintf(res.szNote, "sum:%ld %s", (long)(int32_t)pctx->n, (pctx->n==ref)?"ok":"ERR");
+	simdbench_print(&benchcfg, &res);
+}
+
+// 字段求和: 在各种步长下, 对比各字段求和内核与先转为SoA（逐个复制字段, 再用 simd_sum_i32 求和）. 元素数与带宽都只按字段计算.
+// 步长8、16、32整除向量宽度, 直接加载; 12、24、40在有AVX2时用聚集加载; 64、128每个记录各占一个缓存行, 逐个读取并预取.
+void runStrideTest(int isa)
+{
+	static const size_t strides[] = {8, 12, 16, 24, 32, 40, 64, 128};
+	size_t i, k;
+	char szName[64];
+	int32_t ref = sumint_base(buf, STRIDE_CNT);	// 参考值.
+	const SUMI32STRIDEKERNEL* pk;
+	STRIDECTX ctx = {NULL, 0, 0};
+	stridebuf = (char*)simdbench_alloc(STRIDE_CNT * STRIDE_MAXCB);
+	if (NULL==stridebuf)
+	{
+		fprintf(stderr, "stride: out of memory.\n");
+		return;
+	}
+	for(k=0; k<sizeof(strides)/sizeof(strides[0]); ++k)
+	{
+		// 其他字段也用buf的数据, 再写入被求和的字段.
+		ctx.cbstride = strides[k];
+		for(i=0; i<STRIDE_CNT*ctx.cbstride/sizeof(int32_t); ++i)	((int32_t*)stridebuf)[i] = buf[i % BUFSIZE];
+		for(i=0; i<STRIDE_CNT; ++i)	memcpy(stridebuf + i*ctx.cbstride + STRIDE_OFS, &buf[i], sizeof(buf[0]));
+		for(pk=simdsum_kernels_i32_stride(); NULL!=pk->szName; ++pk)
+		{
+			if (isa < pk->isa)	continue;
+			sprintf(szName, "%s(%u)", pk->szName, (unsigned)ctx.cbstride);
+			runStrideOne(&ctx, szName, pk->proc, ref);
+		}
+		sprintf(szName, "simd_sum_stride_i32(%u)", (unsigned)ctx.cbstride);
+		runStrideOne(&ctx, szName, simd_sum_stride_i32, ref);	// 运行时分派版.
+		sprintf(szName, "soa+simd_sum_i32(%u)", (unsigned)ctx.cbstride);
+		runStrideOne(&ctx, szName, NULL, ref);
+	}
+	simdbench_free(stridebuf);
+	stridebuf = NULL;
+}
+
+// 窄整数求和用的数组. 数据取自buf各元素的低位. u8与i8共用narrow8.
+ATTR_ALIGN(32) static uint8_t narrow8[BUFSIZE];
+ATTR_ALIGN(32) static int16_t narrow16[BUFSIZE];
+
+// 加宽为int32后的数组. 用于对比先加宽再求和.
+ATTR_ALIGN(32) static int32_t narrowwide[BUFSIZE];
+
+// 窄整数求和时的调用参数. 各函数指针只有一个非NULL.
+typedef struct tagNARROWCTX{
+	SUMU8PROC	procu8;	// 无符号8位.
+	SUMI8PROC	proci8;	// 有符号8位.
+	SUMI16PROC	proci16;	// 有符号16位.
+	TESTWIDEPROC	procwide;	// 对narrowwide求和.
+	volatile int64_t	n;	// 结果. 避免调用被优化.
+}NARROWCTX;
+
+// 窄整数求和_调用一次.
+static void narrowCall(void* param)
+{
+	NARROWCTX* pctx = (NARROWCTX*)param;
+	if (NULL!=pctx->procu8)	pctx->n = (int64_t)pctx->procu8(narrow8, BUFSIZE);
+	else if (NULL!=pctx->proci8)	pctx->n = pctx->proci8((const int8_t*)narrow8, BUFSIZE);
+	else if (NULL!=pctx->proci16)	pctx->n = pctx->proci16(narrow16, BUFSIZE);
+	else	pctx->n = pctx->procwide(narrowwide, BUFSIZE);
+}
+
+// 窄整数求和_测试一个函数. cbelem为每个元素的字节数, 用于计算带宽.
+static void runNarrowOne(NARROWCTX* pctx, const char* szname, size_t cbelem, int64_t ref)
+{
+	SIMDBENCH_RESULT res;
+	simdbench_run(&benchcfg, &res, szname, narrowCall, pctx, BUFSIZE, cbelem);
+	sprintf(res.szNote, "sum:%lld %s", (long long)pctx->n, (pctx->n==ref)?"ok":"ERR");
+	simdbench_print(&benchcfg, &res);
+	memset(pctx, 0, sizeof(*pctx));
+}
+
+// 窄整数求和: 8位、16位数组的各内核, 与先加宽为int32数组再用 simd_sum_i32_wide 求和对比.
+// 元素数相同, 加宽后的数组是4倍（8位）或2倍（16位）的字节数. 加宽本身的开销不计入.
+void runNarrowTest(int isa)
+{
 	size_t i;
-	size_t nBlockWidth = 4;	// 块宽. SSE寄存器能一次处理4个int32_t.
-	size_t cntBlock = cntbuf / nBlockWidth;	// 块数.
-	size_t cntRem = cntbuf % nBlockWidth;	// 剩余数量.
-	__m128i xidSum = _mm_setzero_si128();	// 求和变量。[SSE2] PXOR. 赋初值0.
-	__m128i xidLoad;	// 加载.
-	const __m128i* p = (const __m128i*)pbuf;	// SSE批量处理时所用的指针.
-	const int32_t* q;	// 单个数据处理时所用指针.
+	int64_t ref;	// 参考值.
+	const SUMU8KERNEL* pku8;
+	const SUMI8KERNEL* pki8;
+	const SUMI16KERNEL* pki16;
+	NARROWCTX ctx;
+	memset(&ctx, 0, sizeof(ctx));
+	for(i=0; i<BUFSIZE; ++i)
+	{
+		narrow8[i] = (uint8_t)buf[i];
+		narrow16[i] = (int16_t)buf[i];
+	}
 
-	// SSE批量处理.
-	for(i=0; i<cntBlock; ++i)
+	// 无符号8位.
+	ref = (int64_t)sumuint8_base(narrow8, BUFSIZE);
+	for(pku8=simdsum_kernels_u8(); NULL!=pku8->szName; ++pku8)
 	{
-		xidLoad = _mm_load_si128(p);	// [SSE2] MOVDQA. 加载.
-		xidSum = _mm_add_epi32(xidSum, xidLoad);	// [SSE2] PADDD. 32位整数紧缩环绕加法.
-		p ++;
+		if (isa < pku8->isa)	continue;
+		ctx.procu8 = pku8->proc;
+		runNarrowOne(&ctx, pku8->szName, sizeof(uint8_t), ref);
 	}
-	// 合并.
-	q = (const int32_t*)&xidSum;
-	s = q[0] + q[1] + q[2] + q[3];
+	ctx.procu8 = simd_sum_u8;
+	runNarrowOne(&ctx, "simd_sum_u8", sizeof(uint8_t), ref);	// 运行时分派版.
+	for(i=0; i<BUFSIZE; ++i)	narrowwide[i] = narrow8[i];
+	ctx.procwide = simd_sum_i32_wide;
+	runNarrowOne(&ctx, "simd_sum_i32_wide(u8)", sizeof(int32_t), ref);
 
-	// 处理剩下的.
-	q = (const int32_t*)p;
-	for(i=0; i<cntRem; ++i)
+	// 有符号8位.
+	ref = sumint8_base((const int8_t*)narrow8, BUFSIZE);
+	for(pki8=simdsum_kernels_i8(); NULL!=pki8->szName; ++pki8)
 	{
-		s += q[i];
+		if (isa < pki8->isa)	continue;
+		ctx.proci8 = pki8->proc;
+		runNarrowOne(&ctx, pki8->szName, sizeof(int8_t), ref);
 	}
+	ctx.proci8 = simd_sum_i8;
+	runNarrowOne(&ctx, "simd_sum_i8", sizeof(int8_t), ref);
+	for(i=0; i<BUFSIZE; ++i)	narrowwide[i] = (int8_t)narrow8[i];
+	ctx.procwide = simd_sum_i32_wide;
+	runNarrowOne(&ctx, "simd_sum_i32_wide(i8)", sizeof(int32_t), ref);
 
-	return s;
+	// 有符号16位.
+	ref = sumint16_base(narrow16, BUFSIZE);
+	for(pki16=simdsum_kernels_i16(); NULL!=pki16->szName; ++pki16)
+	{
+		if (isa < pki16->isa)	continue;
+		ctx.proci16 = pki16->proc;
+		runNarrowOne(&ctx, pki16->szName, sizeof(int16_t), ref);
+	}
+	ctx.proci16 = simd_sum_i16;
+	runNarrowOne(&ctx, "simd_sum_i16", sizeof(int16_t), ref);
+	for(i=0; i<BUFSIZE; ++i)	narrowwide[i] = narrow16[i];
+	ctx.procwide = simd_sum_i32_wide;
+	runNarrowOne(&ctx, "simd_sum_i32_wide(i16)", sizeof(int32_t), ref);
+}
+
+// 64位整数求和用的数组. 有符号与无符号共用.
+ATTR_ALIGN(32) static int64_t int64buf[BUFSIZE];
+
+// 64位整数求和时的调用参数. 两个函数指针只有一个非NULL.
+typedef struct tagINT64CTX{
+	SUMI64PROC	proci64;	// 有符号.
+	SUMU64PROC	procu64;	// 无符号.
+	volatile uint64_t	n;	// 结果. 避免调用被优化.
+	uint64_t	carry;	// 无符号时的进位次数.
+}INT64CTX;
+
+// 64位整数求和_调用一次.
+static void int64Call(void* param)
+{
+	INT64CTX* pctx = (INT64CTX*)param;
+	if (NULL!=pctx->proci64)	pctx->n = (uint64_t)pctx->proci64(int64buf, BUFSIZE);
+	else	pctx->n = pctx->procu64((const uint64_t*)int64buf, BUFSIZE, &pctx->carry);
+}
+
+// 64位整数求和_测试一个函数. refcarry只用于无符号.
+static void runInt64One(INT64CTX* pctx, const char* szname, uint64_t ref, uint64_t refcarry)
+{
+	SIMDBENCH_RESULT res;
+	simdbench_run(&benchcfg, &res, szname, int64Call, pctx, BUFSIZE, sizeof(int64buf[0]));
+	if (NULL!=pctx->proci64)	sprintf(res.szNote, "sum:%lld %s", (long long)pctx->n, (pctx->n==ref)?"ok":"ERR");
+	else	sprintf(res.szNote, "sum:%llu carry:%llu %s", (unsigned long long)pctx->n, (unsigned long long)pctx->carry, (pctx->n==ref && pctx->carry==refcarry)?"ok":"ERR");
+	simdbench_print(&benchcfg, &res);
+	memset(pctx, 0, sizeof(*pctx));
 }
 
-// 32位整数数组求和_SSE四路循环展开版.
-int32_t sumint_sse_4loop(const int32_t* pbuf, size_t cntbuf)
+// 64位整数求和: 有符号各内核, 及统计进位的无符号各内核. 基本版即标量的对照.
+// 数据由buf拼成, 取满64位范围, 故无符号求和几乎每两个元素就进位一次.
+void runInt64Test(int isa)
 {
-	int32_t s = 0;	// 返回值.
 	size_t i;
-	size_t nBlockWidth = 4*4;	// 块宽. SSE寄存器能一次处理4个int32_t，然后循环展开4次.
-	size_t cntBlock = cntbuf / nBlockWidth;	// 块数.
-	size_t cntRem = cntbuf % nBlockWidth;	// 剩余数量.
-	__m128i xidSum = _mm_setzero_si128();	// 求和变量。[SSE2] PXOR. 赋初值0.
-	__m128i xidSum1 = _mm_setzero_si128();
-	__m128i xidSum2 = _mm_setzero_si128();
-	__m128i xidSum3 = _mm_setzero_si128();
-	__m128i xidLoad;	// 加载.
-	__m128i xidLoad1;
-	__m128i xidLoad2;
-	__m128i xidLoad3;
-	const __m128i* p = (const __m128i*)pbuf;	// SSE批量处理时所用的指针.
-	const int32_t* q;	// 单个数据处理时所用指针.
+	uint64_t ref, refcarry;	// 参考值.
+	const SUMI64KERNEL* pki64;
+	const SUMU64KERNEL* pku64;
+	INT64CTX ctx;
+	memset(&ctx, 0, sizeof(ctx));
+	for(i=0; i<BUFSIZE; ++i)	int64buf[i] = (int64_t)(((uint64_t)(uint32_t)buf[i] << 32) | (uint32_t)buf[(i*7+1) % BUFSIZE]);
 
-	// SSE批量处理.
-	for(i=0; i<cntBlock; ++i)
+	ref = (uint64_t)sumint64_base(int64buf, BUFSIZE);
+	for(pki64=simdsum_kernels_i64(); NULL!=pki64->szName; ++pki64)
 	{
-		xidLoad = _mm_load_si128(p);	// [SSE2] MOVDQA. 加载.
-		xidLoad1 = _mm_load_si128(p+1);
-		xidLoad2 = _mm_load_si128(p+2);
-		xidLoad3 = _mm_load_si128(p+3);
-		xidSum = _mm_add_epi32(xidSum, xidLoad);	// [SSE2] PADDD. 32位整数紧缩环绕加法.
-		xidSum1 = _mm_add_epi32(xidSum1, xidLoad1);
-		xidSum2 = _mm_add_epi32(xidSum2, xidLoad2);
-		xidSum3 = _mm_add_epi32(xidSum3, xidLoad3);
-		p += 4;	// 四路循环展开.
+		if (isa < pki64->isa)	continue;
+		ctx.proci64 = pki64->proc;
+		runInt64One(&ctx, pki64->szName, ref, 0);
 	}
-	// 合并.
-	xidSum = _mm_add_epi32(xidSum, xidSum1);	// 两两合并(0~1).
-	xidSum2 = _mm_add_epi32(xidSum2, xidSum3);	// 两两合并(2~3).
-	xidSum = _mm_add_epi32(xidSum, xidSum2);	// 两两合并(0~3).
-	q = (const int32_t*)&xidSum;
-	s = q[0] + q[1] + q[2] + q[3];
+	ctx.proci64 = simd_sum_i64;
+	runInt64One(&ctx, "simd_sum_i64", ref, 0);	// 运行时分派版.
 
-	// 处理剩下的.
-	q = (const int32_t*)p;
-	for(i=0; i<cntRem; ++i)
+	ref = sumuint64_base((const uint64_t*)int64buf, BUFSIZE, &refcarry);
+	for(pku64=simdsum_kernels_u64(); NULL!=pku64->szName; ++pku64)
 	{
-		s += q[i];
+		if (isa < pku64->isa)	continue;
+		ctx.procu64 = pku64->proc;
+		runInt64One(&ctx, pku64->szName, ref, refcarry);
 	}
+	ctx.procu64 = simd_sum_u64;
+	runInt64One(&ctx, "simd_sum_u64", ref, refcarry);
+}
+
+// 条件求和用的条件列. 值为[0, 10000)内的随机整数.
+ATTR_ALIGN(32) static int32_t wherekey[BUFSIZE];
+
+// 先过滤时的目标数组.
+ATTR_ALIGN(32) static int32_t wherebuf[BUFSIZE];
+
+// 条件求和时的调用参数. 条件都是 lo <= key < hi.
+typedef struct tagWHERECTX{
+	SUMI32WHEREPROC	proc;	// 被测函数. NULL表示先用标量循环把满足条件的值复制到wherebuf, 再用 simd_sum_i32 求和.
+	const int32_t*	pkey;	// 条件数组. NULL表示条件在值本身上.
+	int32_t	lo;	// 下界.
+	int32_t	hi;	// 上界.
+	volatile int32_t	n;	// 结果. 避免调用被优化.
+}WHERECTX;
 
-	return s;
+// 条件求和_标量过滤. 返回满足条件的元素数.
+static size_t whereFilter(const WHERECTX* pctx)
+{
+	const int32_t* pkey = (NULL!=pctx->pkey) ? pctx->pkey : buf;
+	size_t i;
+	size_t cnt = 0;
+	for(i=0; i<BUFSIZE; ++i)
+	{
+		if (pkey[i] >= pctx->lo && pkey[i] < pctx->hi)	wherebuf[cnt++] = buf[i];
+	}
+	return cnt;
 }
-#endif	// #ifdef INTRIN_SSE2
 
+// 条件求和_调用一次.
+static void whereCall(void* param)
+{
+	WHERECTX* pctx = (WHERECTX*)param;
+	if (NULL!=pctx->proc)	pctx->n = pctx->proc(buf, pctx->pkey, BUFSIZE, pctx->lo, pctx->hi, 0);
+	else	pctx->n = simd_sum_i32(wherebuf, whereFilter(pctx));
+}
 
+// 条件求和_测试一个函数. 带宽按读取的列数计算.
+static void runWhereOne(WHERECTX* pctx, const char* szname, SUMI32WHEREPROC proc, int32_t ref)
+{
+	SIMDBENCH_RESULT res;
+	pctx->proc = proc;
+	simdbench_run(&benchcfg, &res, szname, whereCall, pctx, BUFSIZE, (NULL!=pctx->pkey ? 2 : 1) * sizeof(buf[0]));
+	sprintf(res.szNote, "sum:%ld %s", (long)(int32_t)pctx->n, (pctx->n==ref)?"ok":"ERR");
+	simdbench_print(&benchcfg, &res);
+}
 
+// 条件求和: 在0%~100%的选择率下, 对比各条件求和内核与先用标量循环过滤、再用 simd_sum_i32 求和.
+// 单列的条件为 0 <= x < t（buf的值在[0, 32768)内）; 两列的条件为 lo <= key < hi, 区间以5000为中心.
+void runWhereTest(int isa)
+{
+	static const int sels[] = {0, 1, 10, 25, 50, 75, 90, 99, 100};	// 选择率（%）.
+	size_t i, k;
+	int two;	// 是否为两列.
+	char szName[64];
+	int32_t ref;	// 参考值.
+	const SUMI32WHEREKERNEL* pk;
+	WHERECTX ctx = {NULL, NULL, 0, 0, 0};
+	for(i=0; i<BUFSIZE; ++i)	wherekey[i] = rand() % 10000;
+	for(two=0; two<2; ++two)
+	{
+		ctx.pkey = two ? wherekey : NULL;
+		for(k=0; k<sizeof(sels)/sizeof(sels[0]); ++k)
+		{
+			if (two)
+			{
+				ctx.lo = (int32_t)(5000 - 50*sels[k]);
+				ctx.hi = (int32_t)(5000 + 50*sels[k]);
+			}
+			else
+			{
+				ctx.lo = 0;
+				ctx.hi = 32768 * sels[k] / 100;
+			}
+			ref = sumint_where_base(buf, ctx.pkey, BUFSIZE, ctx.lo, ctx.hi, 0);
+			for(pk=simdsum_kernels_i32_where(); NULL!=pk->szName; ++pk)
+			{
+				if (isa < pk->isa)	continue;
+				sprintf(szName, "%s(%s%d%%)", pk->szName, two ? "key," : "", sels[k]);
+				runWhereOne(&ctx, szName, pk->proc, ref);
+			}
+			sprintf(szName, "simd_sum_where_i32(%s%d%%)", two ? "key," : "", sels[k]);
+			runWhereOne(&ctx, szName, simd_sum_where_i32, ref);	// 运行时分派版.
+			sprintf(szName, "filter+simd_sum_i32(%s%d%%)", two ? "key," : "", sels[k]);
+			runWhereOne(&ctx, szName, NULL, ref);
+		}
+	}
+}
 
+// 工作集扫描_测试一个函数. proc与procwide只有一个非NULL.
+static void runSweepOne(const SIMDBENCH_CFG* pcfg, TESTCTX* pctx, const char* szname, TESTPROC proc, TESTWIDEPROC procwide, size_t cb)
+{
+	SIMDBENCH_RESULT res;
+	pctx->proc = proc;
+	pctx->procwide = procwide;
+	simdbench_run(pcfg, &res, szname, testCall, pctx, pctx->cntbuf, sizeof(pctx->pbuf[0]));
+	simdbench_sweep_note(res.szNote, cb);
+	simdbench_print(&benchcfg, &res);
+}
 
-//////////////////////////////////////////////////
-// main
-//////////////////////////////////////////////////
+// 工作集扫描: 数组从4KB增大到benchcfg.cbsweep, 测试各内核在各级缓存与内存中的吞吐量. 数据为buf的重复.
+void runSweep(int isa)
+{
+	size_t cntmax = benchcfg.cbsweep / sizeof(int32_t);
+	size_t cb;
+	size_t cbprev = 0;
+	size_t i;
+	const SUMI32KERNEL* pk;
+	const SUMI32WIDEKERNEL* pkw;
+	int32_t* pbuf;
+	SIMDSUM_ARENA arena;
+	TESTCTX ctx = {NULL, NULL, NULL, 0, 0};
+	SIMDBENCH_CFG cfg;	// 当前大小所用的配置.
+	char szNote[32];	// 当前大小的附加说明.
+	FILE* fpinfo = simdbench_info(&benchcfg);
 
-// 变量对齐.
-#ifndef ATTR_ALIGN
-#  if defined(__GNUC__)	// GCC
-#    define ATTR_ALIGN(n)	__attribute__((aligned(n)))
-#  else	// 否则使用VC格式.
-#    define ATTR_ALIGN(n)	__declspec(align(n))
-#  endif
-#endif	// #ifndef ATTR_ALIGN
+	if (0!=simdsum_arena_init(&arena, cntmax * sizeof(int32_t), benchcfg.page))
+	{
+		fprintf(stderr, "sweep: out of memory (%llu bytes).\n", (unsigned long long)(cntmax * sizeof(int32_t)));
+		return;
+	}
+	pbuf = (int32_t*)simdsum_arena_alloc(&arena, cntmax * sizeof(int32_t));
+	fprintf(fpinfo, "pages:\t%s\n", simdsum_page_name(arena.page));
+	for(i=0; i<cntmax; ++i)	pbuf[i] = buf[i % BUFSIZE];
+	ctx.pbuf = pbuf;
+	for(cb=SIMDBENCH_SWEEP_MIN; cb<=cntmax*sizeof(int32_t); cb=simdbench_sweep_next(cb))
+	{
+		simdbench_sweep_mark(fpinfo, cbprev, cb);
+		simdbench_sweep_cfg(&benchcfg, &cfg, cb);
+		simdbench_sweep_note(szNote, cb);
+		simdbench_stream(&benchcfg, &cfg, cb, szNote);
+		ctx.cntbuf = cb / sizeof(int32_t);
+		for(pk=simdsum_kernels_i32(); NULL!=pk->szName; ++pk)
+		{
+			if (isa >= pk->isa)	runSweepOne(&cfg, &ctx, pk->szName, pk->proc, NULL, cb);
+		}
+		runSweepOne(&cfg, &ctx, "simd_sum_i32", simd_sum_i32, NULL, cb);
+		runSweepOne(&cfg, &ctx, "simd_sum_i32_nta", simd_sum_i32_nta, NULL, cb);
+		for(pkw=simdsum_kernels_i32_wide(); NULL!=pkw->szName; ++pkw)
+		{
+			if (isa >= pkw->isa)	runSweepOne(&cfg, &ctx, pkw->szName, NULL, pkw->proc, cb);
+		}
+		runSweepOne(&cfg, &ctx, "simd_sum_i32_wide", NULL, simd_sum_i32_wide, cb);
+		runSweepOne(&cfg, &ctx, "simd_sum_stats_i32", NULL, sum_stats, cb);
+		cbprev = cb;
+	}
+	simdsum_arena_free(&arena);
+}
 
+// 页面对比用的数组. [0]为普通页, [1]为大页.
+static int32_t* pagebuf[2];
 
-#define BUFSIZE	409600
-ATTR_ALIGN(32) int32_t buf[BUFSIZE];
+// 页面对比用的数组的页面类型名称.
+static const char* pagename[2];
 
-// 测试时的函数类型
-typedef int32_t (*TESTPROC)(const int32_t* pbuf, size_t cntbuf);
+// 页面对比_测试一个函数. 依次在普通页与大页的数组上测试, 大页一行的说明为相对普通页的加速比. proc与procwide只有一个非NULL.
+static void runPageOne(const SIMDBENCH_CFG* pcfg, TESTCTX* pctx, const char* szname, TESTPROC proc, TESTWIDEPROC procwide)
+{
+	char szName[64];
+	double tmed = 0;	// 普通页的中位数.
+	SIMDBENCH_RESULT res;
+	int i;
+	pctx->proc = proc;
+	pctx->procwide = procwide;
+	for(i=0; i<2; ++i)
+	{
+		pctx->pbuf = pagebuf[i];
+		sprintf(szName, "%s(%s)", szname, pagename[i]);
+		simdbench_run(pcfg, &res, szName, testCall, pctx, pctx->cntbuf, sizeof(pctx->pbuf[0]));
+		if (0==i)	tmed = res.tmed;
+		else	sprintf(res.szNote, "x%.3f vs %s", tmed / res.tmed, pagename[0]);
+		simdbench_print(&benchcfg, &res);
+	}
+}
 
-// 进行测试
-void runTest(const char* szname, TESTPROC proc)
+// 页面对比: 在远大于末级缓存的数组（benchcfg.cbpagecmp字节）上, 对比各内核用普通页与大页时的吞吐量, 即TLB缺失的影响. 数据为buf的重复.
+void runPageTest(int isa)
 {
-	const int testloop = 4000;	// 重复运算几次延长时间，避免计时精度问题.
+	static const int s_page[2] = {SIMDSUM_PAGE_4K, SIMDSUM_PAGE_HUGETLB};
+	size_t cnt = benchcfg.cbpagecmp / sizeof(int32_t);
+	size_t i;
 	int j;
-	clock_t	tm0, dt;	// 存储时间.
-	double mps;	// M/s.
-	volatile int32_t n=0;	// 避免内循环被优化.
+	const SUMI32KERNEL* pk;
+	const SUMI32WIDEKERNEL* pkw;
+	SIMDSUM_ARENA arena[2];
+	TESTCTX ctx = {NULL, NULL, NULL, 0, 0};
+	SIMDBENCH_CFG cfg;	// 按数组大小减少计时轮数.
+	FILE* fpinfo = simdbench_info(&benchcfg);
 
-	tm0 = clock();
+	for(j=0; j<2; ++j)
+	{
+		if (0!=simdsum_arena_init(&arena[j], cnt * sizeof(int32_t), s_page[j]))
+		{
+			fprintf(stderr, "pages: out of memory (%llu bytes).\n", (unsigned long long)(cnt * sizeof(int32_t)));
+			if (0!=j)	simdsum_arena_free(&arena[0]);
+			return;
+		}
+		pagebuf[j] = (int32_t*)simdsum_arena_alloc(&arena[j], cnt * sizeof(int32_t));
+		pagename[j] = simdsum_page_name(arena[j].page);
+		for(i=0; i<cnt; ++i)	pagebuf[j][i] = buf[i % BUFSIZE];
+	}
+	fprintf(fpinfo, "pages:\t%s vs %s, %llu bytes\n", pagename[0], pagename[1], (unsigned long long)(cnt * sizeof(int32_t)));
+	simdbench_sweep_cfg(&benchcfg, &cfg, cnt * sizeof(int32_t));
+	ctx.cntbuf = cnt;
+
+	for(pk=simdsum_kernels_i32(); NULL!=pk->szName; ++pk)
+	{
+		if (isa >= pk->isa)	runPageOne(&cfg, &ctx, pk->szName, pk->proc, NULL);
+	}
+	runPageOne(&cfg, &ctx, "simd_sum_i32", simd_sum_i32, NULL);
+	runPageOne(&cfg, &ctx, "simd_sum_i32_nta", simd_sum_i32_nta, NULL);
+	for(pkw=simdsum_kernels_i32_wide(); NULL!=pkw->szName; ++pkw)
+	{
+		if (isa >= pkw->isa)	runPageOne(&cfg, &ctx, pkw->szName, NULL, pkw->proc);
+	}
+	runPageOne(&cfg, &ctx, "simd_sum_i32_wide", NULL, simd_sum_i32_wide);
+
+	simdsum_arena_free(&arena[1]);
+	simdsum_arena_free(&arena[0]);
+}
+
+// 文件求和_调用一次. 结果保存到n, 元素数保存到cntbuf.
+static void fileCall(void* param)
+{
+	TESTCTX* pctx = (TESTCTX*)param;
+	int64_t s = 0;
+	simd_sum_file_i32(benchcfg.szfile, &s, &pctx->cntbuf);
+	pctx->n = s;
+}
+
+// 文件求和_清空页缓存.
+static void fileDrop(void* param)
+{
+	(void)param;
+	simdbench_dropcache(benchcfg.szfile);
+}
+
+// 流水线参数. 由 runIngestTest 设置.
+static SIMDSUM_INGEST ingestcfg;
+
+// 只读取_调用一次. 测量I/O带宽.
+static void readCall(void* param)
+{
+	int fd = simdbench_open(benchcfg.szfile);
+	(void)param;
+	if (fd < 0)	return;
+	simdbench_readfd(fd, SIMDSUM_INGEST_CHUNK, ingestcfg.cblimit);
+	simdbench_close(fd);
+}
+
+// 流水线读取求和_调用一次. 结果保存到n.
+static void ingestCall(void* param)
+{
+	TESTCTX* pctx = (TESTCTX*)param;
+	int64_t s = 0;
+	int fd = simdbench_open(benchcfg.szfile);
+	if (fd < 0)	return;
+	simd_sum_fd_i32(fd, &ingestcfg, &s, NULL);
+	simdbench_close(fd);
+	pctx->n = s;
+}
+
+// 流水线读取求和: 依次测试只读取、串行（读一块求一块）、流水线.
+// 流水线一行的说明附上两个估计值: 完全重叠时为 min(I/O, 求和), 完全串行时为调和组合 1/(1/I/O + 1/求和).
+//
+// pcfg: 测试配置.
+// szmode: 名称中的模式, 为"warm", "cold"或"dev".
+// cold: 是否在每轮之前清空页缓存.
+// cb: 读取的字节数.
+// gbpssum: 对缓存中的一块求和的带宽.
+static void runIngestTest(const SIMDBENCH_CFG* pcfg, const char* szmode, int cold, uint64_t cb, double gbpssum)
+{
+	static const char* const s_szName[3] = {"read(", "simd_sum_fd_i32(serial,", "simd_sum_fd_i32(pipe,"};
+	char szName[64];
+	double gbpsio;
+	TESTCTX ctx = {NULL, NULL, NULL, 0, 0};
+	SIMDBENCH_RESULT res;
+	size_t cnt = (size_t)(cb / sizeof(int32_t));
+	int i;
+
+	for(i=0; i<3; ++i)
+	{
+		ingestcfg.depth = (0==i) ? 0 : (1==i) ? 1 : SIMDSUM_INGEST_DEPTH;
+		sprintf(szName, "%s%s)", s_szName[i], szmode);
+		if (cold)	simdbench_run_prep(pcfg, &res, szName, (0==i) ? readCall : ingestCall, fileDrop, &ctx, cnt, sizeof(int32_t));
+		else	simdbench_run(pcfg, &res, szName, (0==i) ? readCall : ingestCall, &ctx, cnt, sizeof(int32_t));
+		if (0==i)
+		{
+			gbpsio = res.gbps;
+		}
+		else if (1==i)
+		{
+			sprintf(res.szNote, "sum:%lld", (long long)ctx.n);
+		}
+		else
+		{
+			sprintf(res.szNote, "sum:%lld overlap:%.2f serial:%.2f", (long long)ctx.n,
+				(gbpsio < gbpssum) ? gbpsio : gbpssum, 1.0 / (1.0/gbpsio + 1.0/gbpssum));
+		}
+		simdbench_print(&benchcfg, &res);
+	}
+}
+
+// 文件求和: 用 simd_sum_file_i32 映射文件并求和, 测试含映射与缺页的端到端带宽; 再用 simd_sum_fd_i32 测试读取与求和重叠的流水线.
+// 分别测试页缓存已预热（warm）与已清空（cold）时的情况. 输入为设备或管道（例如/dev/zero）时只测试流水线.
+void runFileTest(void)
+{
+	int rt;
+	int isdev = simdbench_isdevice(benchcfg.szfile);
+	int64_t s;
+	size_t cnt;	// 元素数.
+	uint64_t cb;	// 字节数.
+	double gbpssum;	// 对缓存中的一块求和的带宽.
+	TESTCTX ctx = {NULL, NULL, NULL, 0, 0};
+	SIMDBENCH_CFG cfg;	// 按文件大小减少计时轮数.
+	SIMDBENCH_RESULT res;
+	FILE* fpinfo = simdbench_info(&benchcfg);
 
-	for(j=1; j<=testloop; ++j)	// 重复运算几次延长时间，避免计时开销带来的影响.
+	if (isdev)
 	{
-		n = proc(buf, BUFSIZE);	// 避免内循环被编译优化消掉.
+		cb = (0!=benchcfg.cbfile) ? benchcfg.cbfile : SIMDBENCH_DEVICE_BYTES;
+		fprintf(fpinfo, "file:\t%s (device, %llu bytes)\n", benchcfg.szfile, (unsigned long long)cb);
+		ingestcfg.cblimit = cb;
 	}
-	dt = clock() - tm0;
-	double time_s = (double)dt / CLOCKS_PER_SEC;
-	// show
-	mps = (double)testloop*BUFSIZE*CLOCKS_PER_SEC/(1024.0*1024.0*dt);
-	printf("%s:\t\t  io: %.0f mb/s\t  time:%f s sum:%ld\n", szname, mps, time_s, n);
+	else
+	{
+		if (0!=benchcfg.cbfile)
+		{
+			rt = simdbench_mkfile(benchcfg.szfile, buf, sizeof(buf), benchcfg.cbfile);
+			if (0!=rt)
+			{
+				fprintf(stderr, "file: cannot create %s (%d).\n", benchcfg.szfile, rt);
+				return;
+			}
+		}
+		rt = simd_sum_file_i32(benchcfg.szfile, &s, &cnt);	// 同时预热页缓存.
+		if (0!=rt)
+		{
+			fprintf(stderr, "file: cannot map %s (%d).\n", benchcfg.szfile, rt);
+			return;
+		}
+		cb = cnt * sizeof(int32_t);
+		fprintf(fpinfo, "file:\t%s (%llu bytes)\n", benchcfg.szfile, (unsigned long long)cb);
+		ingestcfg.cblimit = 0;
+	}
+	simdbench_sweep_cfg(&benchcfg, &cfg, (size_t)cb);
+
+	// 求和带宽: 与流水线一样, 每次对缓存中的一块求和.
+	ctx.procwide = simd_sum_i32_wide;
+	ctx.pbuf = buf;
+	ctx.cntbuf = SIMDSUM_INGEST_CHUNK / sizeof(int32_t);
+	simdbench_run(&benchcfg, &res, "simd_sum_i32_wide(chunk)", testCall, &ctx, ctx.cntbuf, sizeof(int32_t));
+	gbpssum = res.gbps;
+	simdbench_print(&benchcfg, &res);
+
+	if (isdev)
+	{
+		runIngestTest(&cfg, "dev", 0, cb, gbpssum);
+		return;
+	}
+
+	simdbench_run(&cfg, &res, "simd_sum_file_i32(warm)", fileCall, &ctx, cnt, sizeof(int32_t));
+	sprintf(res.szNote, "sum:%lld", (long long)ctx.n);
+	simdbench_print(&benchcfg, &res);
+	runIngestTest(&cfg, "warm", 0, cb, gbpssum);
+
+	if (0!=simdbench_dropcache(benchcfg.szfile))
+	{
+		fprintf(stderr, "file: cannot drop the page cache, cold test skipped.\n");
+		return;
+	}
+	simdbench_run_prep(&cfg, &res, "simd_sum_file_i32(cold)", fileCall, fileDrop, &ctx, cnt, sizeof(int32_t));
+	sprintf(res.szNote, "sum:%lld", (long long)ctx.n);
+	simdbench_print(&benchcfg, &res);
+	runIngestTest(&cfg, "cold", 1, cb, gbpssum);
 }
 
 int main(int argc, char* argv[])
 {
 	char szBuf[64];
 	int i;
+	int isa, hwisa;	// 指令集级别.
+	int cntthreads;	// 线程池的线程数.
+	const SUMI32KERNEL* pk;
+	const SUMI32WIDEKERNEL* pkw;
+	FILE* fpinfo;	// 说明文字的输出流.
 
-	printf("simdsumint v1.00 (%dbit)\n", INTRIN_WORDSIZE);
-	printf("Compiler: %s\n", COMPILER_NAME);
+	simdbench_init(&benchcfg, argc, argv);
+	fpinfo = simdbench_info(&benchcfg);
+	fprintf(fpinfo, "simdsumint v1.00 (%dbit)\n", INTRIN_WORDSIZE);
+	fprintf(fpinfo, "Compiler: %s\n", COMPILER_NAME);
 	cpu_getbrand(szBuf);
-	printf("CPU:\t%s\n", szBuf);
-	printf("\n");
+	fprintf(fpinfo, "CPU:\t%s\n", szBuf);
+	isa = simdsum_isa(&hwisa);
+	fprintf(fpinfo, "ISA:\t%s (hw: %s)\n", simdsum_isa_name(isa), simdsum_isa_name(hwisa));
+	fprintf(fpinfo, "Prefetch:\t%u bytes ahead, line %u bytes\n", (unsigned)simdsum_prefetch_dist(), (unsigned)simdsum_cacheline());
+	fprintf(fpinfo, "\n");
 
 	// init buf
 	srand( (unsigned)time( NULL ) );
 	for (i = 0; i < BUFSIZE; i++) buf[i] = (int32_t)(rand() & 0x7fff);	// 使用&0x7fff是为了使数值在一定范围内，便于观察结果是否正确.
 
-    printf("%ld\n", buf[2]);
+	// 工作集扫描模式: 只进行扫描.
+	if (0!=benchcfg.cbsweep)
+	{
+		runSweep(isa);
+		simdbench_end(&benchcfg);
+		return 0;
+	}
+
+	// 页面对比模式: 只对比普通页与大页.
+	if (0!=benchcfg.cbpagecmp)
+	{
+		runPageTest(isa);
+		simdbench_end(&benchcfg);
+		return 0;
+	}
+
+	// 文件求和模式: 只测试文件求和.
+	if (NULL!=benchcfg.szfile)
+	{
+		runFileTest();
+		simdbench_end(&benchcfg);
+		return 0;
+	}
+	// 带宽基准. 之后各结果的%read为占只读带宽的百分比.
+	simdbench_stream(&benchcfg, &benchcfg, sizeof(buf), "");
+
 	// test
-	runTest("sumint_base", sumint_base);	// 32位整数数组求和_基本版.
-#ifdef INTRIN_MMX
-	if (simd_mmx(NULL))
+	for(pk=simdsum_kernels_i32(); NULL!=pk->szName; ++pk)
+	{
+		if (isa >= pk->isa)	runTest(pk->szName, pk->proc);
+	}
+	runTest("simd_sum_i32", simd_sum_i32);	// 运行时分派版.
+	runTest("simd_sum_i32_nta", simd_sum_i32_nta);	// 运行时分派版_流式.
+
+	// 多线程扩展性: 1~N线程.
+	cntthreads = simdsum_mt_init(0);
+	for(nthreads_mt=1; nthreads_mt<=cntthreads; ++nthreads_mt)
 	{
-		runTest("sumint_mmx", sumint_mmx);	// 32位整数数组求和_MMX版.
-		runTest("sumint_mmx_4", sumint_mmx_4loop);	// 32位整数数组求和_MMX四路循环展开版.
+		sprintf(szBuf, "simd_sum_i32_mt(%d)", nthreads_mt);
+		runTest(szBuf, sum_mt);
 	}
-#endif	// #ifdef INTRIN_MMX
-#ifdef INTRIN_SSE2
-	if (simd_sse_level(NULL) >= SIMD_SSE_2)
+	simdsum_mt_exit();
+
+	// 任意对齐: 各字节偏移下的吞吐量.
+	fprintf(fpinfo, "\n");
+	runOffsetTest("simd_sum_i32", simd_sum_i32);
+
+	// 分段求和: 许多小数组, 一次调用与逐段调用对比.
+	fprintf(fpinfo, "\n");
+	runSegTest(isa);
+
+	// 前缀和: 累计和. 各行的sum即总和.
+	fprintf(fpinfo, "\n");
+	runScanTest(isa);
+
+	// 字段求和: 结构体数组中的一个字段, 与先转为SoA再求和对比.
+	fprintf(fpinfo, "\n");
+	runStrideTest(isa);
+
+	// 条件求和: 各种选择率下的单列与两列条件.
+	fprintf(fpinfo, "\n");
+	runWhereTest(isa);
+
+	// 64位结果: 使用完整的int32_t范围, 此时32位结果会溢出.
+	fprintf(fpinfo, "\n");
+	for (i = 0; i < BUFSIZE; i++) buf[i] = (int32_t)(((uint32_t)rand() << 17) ^ ((uint32_t)rand() << 2) ^ (uint32_t)rand());
+	refwide = sumint_wide_base(buf, BUFSIZE);
+	fprintf(fpinfo, "ref: %lld\t i32: %ld\n", (long long)refwide, (long)simd_sum_i32(buf, BUFSIZE));
+	for(pkw=simdsum_kernels_i32_wide(); NULL!=pkw->szName; ++pkw)
 	{
-		runTest("sumint_sse", sumint_sse);	// 32位整数数组求和_SSE版.
-		runTest("sumint_sse_4", sumint_sse_4loop);	// 32位整数数组求和_SSE四路循环展开版.
+		if (isa >= pkw->isa)	runTestWide(pkw->szName, pkw->proc);
 	}
-#endif	// #ifdef INTRIN_SSE2
+	runTestWide("simd_sum_i32_wide", simd_sum_i32_wide);	// 运行时分派版.
+
+	// 窄整数求和: 取上面数据的低8位、低16位.
+	fprintf(fpinfo, "\n");
+	runNarrowTest(isa);
+
+	// 64位整数求和: 数据由上面的32位数据拼成.
+	fprintf(fpinfo, "\n");
+	runInt64Test(isa);
+
+	// 单遍统计: 数据同上. 各元素转为双精度累加, 和不会溢出.
+	fprintf(fpinfo, "\n");
+	runStatsTest(isa);
+
+	// 64位前缀和: 数据同上.
+	fprintf(fpinfo, "\n");
+	runScan64Test(isa);
 
+	simdbench_end(&benchcfg);
 	return 0;
 }
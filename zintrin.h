@@ -71,6 +71,26 @@
 			#define INTRIN_AVX2	1
 			#include <x86intrin.h>
 		#endif
+		#ifdef __AVX512F__
+			#define INTRIN_AVX512F	1
+			#include <x86intrin.h>
+		#endif
+		#ifdef __AVX512CD__
+			#define INTRIN_AVX512CD	1
+			#include <x86intrin.h>
+		#endif
+		#ifdef __AVX512BW__
+			#define INTRIN_AVX512BW	1
+			#include <x86intrin.h>
+		#endif
+		#ifdef __AVX512DQ__
+			#define INTRIN_AVX512DQ	1
+			#include <x86intrin.h>
+		#endif
+		#ifdef __AVX512VL__
+			#define INTRIN_AVX512VL	1
+			#include <x86intrin.h>
+		#endif
 		#ifdef __F16C__
 			#define INTRIN_F16C	1
 			#include <x86intrin.h>
@@ -177,6 +197,23 @@
 			//#define INTRIN_BMI	1
 			//#define INTRIN_BMI2	1
 		#endif
+		#if _MSC_VER >=1911	// VC2017 15.3. 指定 /arch:AVX512 时定义 __AVX512F__ 等宏.
+			#ifdef __AVX512F__
+				#define INTRIN_AVX512F	1	// immintrin.h
+			#endif
+			#ifdef __AVX512CD__
+				#define INTRIN_AVX512CD	1
+			#endif
+			#ifdef __AVX512BW__
+				#define INTRIN_AVX512BW	1
+			#endif
+			#ifdef __AVX512DQ__
+				#define INTRIN_AVX512DQ	1
+			#endif
+			#ifdef __AVX512VL__
+				#define INTRIN_AVX512VL	1
+			#endif
+		#endif
 	#endif
 	//TODO:待查证 VS配合intel C编译器时intrin函数的支持性.
 